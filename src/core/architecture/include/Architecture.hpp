@@ -22,9 +22,49 @@ namespace llvm {
 
         static uint32_t getNumberOfPhysicalCores (void);
 
+        static uint32_t getNumberOfNUMANodes (void);
+
+        /*
+         * Logical cores are the CPUs of the operating system.
+         * Physical cores are numbered from 0 to getNumberOfPhysicalCores() - 1 across all sockets.
+         */
+        static uint32_t getPhysicalCore (uint32_t logicalCore);
+
+        static uint32_t getNUMANode (uint32_t logicalCore);
+
+        /*
+         * Return the logical cores (SMT siblings) of a physical core.
+         */
+        static std::vector<uint32_t> getLogicalCores (uint32_t physicalCore);
+
+        static uint32_t getNumberOfLogicalCoresPerPhysicalCore (void);
+
         static int32_t getCacheLineBytes (void);
 
+        static uint64_t getL1DataCacheBytes (void);
+
+        static uint64_t getL2CacheBytes (void);
+
+        static uint64_t getLastLevelCacheBytes (void);
+
       private:
+        struct Topology {
+          uint32_t logicalCores;
+          uint32_t physicalCores;
+          uint32_t numaNodes;
+          std::vector<uint32_t> physicalCoreOfLogicalCore;
+          std::vector<uint32_t> numaNodeOfLogicalCore;
+          int32_t cacheLineBytes;
+          uint64_t l1DataCacheBytes;
+          uint64_t l2CacheBytes;
+          uint64_t lastLevelCacheBytes;
+        };
+
+        static const Topology & getTopology (void);
+
+        static void discoverCores (Topology &t);
+
+        static void discoverCaches (Topology &t);
   };
 
 }
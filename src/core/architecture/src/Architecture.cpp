@@ -8,22 +8,324 @@
  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
  * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include "llvm/Support/CommandLine.h"
+#include <dirent.h>
+#include <unistd.h>
+#include <fstream>
+
 #include "Architecture.hpp"
 
 using namespace llvm;
 
+/*
+ * Options to describe the target when it is not the machine that runs the compiler.
+ * A value of 0 means the property is discovered from the host.
+ */
+static cl::opt<int> LogicalCores("noelle-arch-logical-cores", cl::ZeroOrMore, cl::Hidden, cl::desc("Number of logical cores of the target (0: discover it)"));
+static cl::opt<int> PhysicalCores("noelle-arch-physical-cores", cl::ZeroOrMore, cl::Hidden, cl::desc("Number of physical cores of the target (0: discover it)"));
+static cl::opt<int> NUMANodes("noelle-arch-numa-nodes", cl::ZeroOrMore, cl::Hidden, cl::desc("Number of NUMA nodes of the target (0: discover it)"));
+static cl::opt<int> CacheLineBytes("noelle-arch-cache-line-bytes", cl::ZeroOrMore, cl::Hidden, cl::desc("Cache line size of the target in bytes (0: discover it)"));
+static cl::opt<int> L1DataCacheKB("noelle-arch-l1-kb", cl::ZeroOrMore, cl::Hidden, cl::desc("L1 data cache size of the target in KB (0: discover it)"));
+static cl::opt<int> L2CacheKB("noelle-arch-l2-kb", cl::ZeroOrMore, cl::Hidden, cl::desc("L2 cache size of the target in KB (0: discover it)"));
+static cl::opt<int> LastLevelCacheKB("noelle-arch-llc-kb", cl::ZeroOrMore, cl::Hidden, cl::desc("Last level cache size of the target in KB (0: discover it)"));
+
+static bool readFirstLine (const std::string &fileName, std::string &line){
+  std::ifstream file(fileName);
+  if (!file.is_open()){
+    return false;
+  }
+  if (!std::getline(file, line)){
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Parse a cache size of sysfs (e.g., "32K", "1024K", "32M").
+ */
+static uint64_t parseBytes (const std::string &text){
+  auto bytes = strtoull(text.c_str(), nullptr, 10);
+  if (text.find('K') != std::string::npos){
+    bytes *= 1024;
+  } else if (text.find('M') != std::string::npos){
+    bytes *= 1024 * 1024;
+  } else if (text.find('G') != std::string::npos){
+    bytes *= 1024 * 1024 * 1024;
+  }
+
+  return bytes;
+}
+
 Architecture::Architecture (){
   return ;
 }
     
 uint32_t Architecture::getNumberOfLogicalCores (void){
-  return std::thread::hardware_concurrency();
+  return getTopology().logicalCores;
 }
 
 uint32_t Architecture::getNumberOfPhysicalCores (void){
-  return getNumberOfLogicalCores() / 2;
+  return getTopology().physicalCores;
+}
+
+uint32_t Architecture::getNumberOfNUMANodes (void){
+  return getTopology().numaNodes;
+}
+
+uint32_t Architecture::getPhysicalCore (uint32_t logicalCore){
+  auto &t = getTopology();
+  assert(logicalCore < t.logicalCores);
+
+  return t.physicalCoreOfLogicalCore[logicalCore];
+}
+
+uint32_t Architecture::getNUMANode (uint32_t logicalCore){
+  auto &t = getTopology();
+  assert(logicalCore < t.logicalCores);
+
+  return t.numaNodeOfLogicalCore[logicalCore];
+}
+
+std::vector<uint32_t> Architecture::getLogicalCores (uint32_t physicalCore){
+  auto &t = getTopology();
+  std::vector<uint32_t> siblings;
+  for (uint32_t i = 0; i < t.logicalCores; i++){
+    if (t.physicalCoreOfLogicalCore[i] == physicalCore){
+      siblings.push_back(i);
+    }
+  }
+
+  return siblings;
+}
+
+uint32_t Architecture::getNumberOfLogicalCoresPerPhysicalCore (void){
+  auto &t = getTopology();
+
+  return (t.logicalCores + t.physicalCores - 1) / t.physicalCores;
 }
 
 int32_t Architecture::getCacheLineBytes (void){
-  return 64;
+  return getTopology().cacheLineBytes;
+}
+
+uint64_t Architecture::getL1DataCacheBytes (void){
+  return getTopology().l1DataCacheBytes;
+}
+
+uint64_t Architecture::getL2CacheBytes (void){
+  return getTopology().l2CacheBytes;
+}
+
+uint64_t Architecture::getLastLevelCacheBytes (void){
+  return getTopology().lastLevelCacheBytes;
+}
+
+const Architecture::Topology & Architecture::getTopology (void){
+  static Topology t = [](){
+    Topology t;
+    Architecture::discoverCores(t);
+    Architecture::discoverCaches(t);
+
+    return t;
+  }();
+
+  return t;
+}
+
+void Architecture::discoverCores (Topology &t){
+
+  /*
+   * Check if the user described the cores of the target.
+   */
+  if (  false
+        || (LogicalCores > 0)
+        || (PhysicalCores > 0)
+    ){
+    t.logicalCores = (LogicalCores > 0) ? LogicalCores : PhysicalCores;
+    t.physicalCores = (PhysicalCores > 0) ? std::min<uint32_t>(PhysicalCores, t.logicalCores) : t.logicalCores;
+    t.numaNodes = (NUMANodes > 0) ? std::min<uint32_t>(NUMANodes, t.physicalCores) : 1;
+
+    /*
+     * Follow the Linux numbering: the first SMT sibling of every physical core comes first, and physical cores are split evenly across NUMA nodes.
+     */
+    for (uint32_t i = 0; i < t.logicalCores; i++){
+      auto physicalCore = i % t.physicalCores;
+      t.physicalCoreOfLogicalCore.push_back(physicalCore);
+      t.numaNodeOfLogicalCore.push_back((physicalCore * t.numaNodes) / t.physicalCores);
+    }
+
+    return ;
+  }
+
+  /*
+   * Discover the cores of the host from sysfs.
+   * Physical cores are identified by their (package, core) pair, and NUMA nodes are renumbered densely.
+   */
+  t.logicalCores = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+  std::map<std::pair<int64_t, int64_t>, uint32_t> physicalCores;
+  std::map<int64_t, uint32_t> numaNodes;
+  auto isDiscovered = true;
+  for (uint32_t i = 0; i < t.logicalCores; i++){
+    auto cpuDir = std::string("/sys/devices/system/cpu/cpu") + std::to_string(i);
+
+    /*
+     * Fetch the physical core.
+     */
+    std::string coreID, packageID;
+    if (  false
+          || (!readFirstLine(cpuDir + "/topology/core_id", coreID))
+          || (!readFirstLine(cpuDir + "/topology/physical_package_id", packageID))
+      ){
+      isDiscovered = false;
+      break ;
+    }
+    auto key = std::make_pair(atoll(packageID.c_str()), atoll(coreID.c_str()));
+    if (physicalCores.find(key) == physicalCores.end()){
+      auto newID = physicalCores.size();
+      physicalCores[key] = newID;
+    }
+    t.physicalCoreOfLogicalCore.push_back(physicalCores[key]);
+
+    /*
+     * Fetch the NUMA node.
+     */
+    int64_t node = 0;
+    auto dir = opendir(cpuDir.c_str());
+    if (dir != nullptr){
+      while (auto entry = readdir(dir)){
+        if (  true
+              && (strncmp(entry->d_name, "node", 4) == 0)
+              && (isdigit(entry->d_name[4]))
+          ){
+          node = atoll(entry->d_name + 4);
+          break ;
+        }
+      }
+      closedir(dir);
+    }
+    if (numaNodes.find(node) == numaNodes.end()){
+      auto newID = numaNodes.size();
+      numaNodes[node] = newID;
+    }
+    t.numaNodeOfLogicalCore.push_back(numaNodes[node]);
+  }
+  if (isDiscovered){
+    t.physicalCores = physicalCores.size();
+    t.numaNodes = numaNodes.size();
+
+  } else {
+
+    /*
+     * The topology is not available: assume 2-way SMT on a single NUMA node.
+     */
+    t.physicalCores = std::max<uint32_t>(t.logicalCores / 2, 1);
+    t.numaNodes = 1;
+    t.physicalCoreOfLogicalCore.clear();
+    t.numaNodeOfLogicalCore.clear();
+    for (uint32_t i = 0; i < t.logicalCores; i++){
+      t.physicalCoreOfLogicalCore.push_back(i % t.physicalCores);
+      t.numaNodeOfLogicalCore.push_back(0);
+    }
+  }
+
+  /*
+   * The user can still override the number of NUMA nodes.
+   */
+  if (NUMANodes > 0){
+    t.numaNodes = std::min<uint32_t>(NUMANodes, t.physicalCores);
+    for (uint32_t i = 0; i < t.logicalCores; i++){
+      t.numaNodeOfLogicalCore[i] = (t.physicalCoreOfLogicalCore[i] * t.numaNodes) / t.physicalCores;
+    }
+  }
+
+  return ;
+}
+
+void Architecture::discoverCaches (Topology &t){
+
+  /*
+   * Set the defaults.
+   */
+  t.cacheLineBytes = 64;
+  t.l1DataCacheBytes = 32 * 1024;
+  t.l2CacheBytes = 256 * 1024;
+  t.lastLevelCacheBytes = 8 * 1024 * 1024;
+
+  /*
+   * Discover the caches of the host from sysfs.
+   */
+  uint32_t lastLevel = 0;
+  auto isDiscovered = false;
+  for (auto index = 0; ; index++){
+    auto cacheDir = std::string("/sys/devices/system/cpu/cpu0/cache/index") + std::to_string(index);
+    std::string level, type, size, lineSize;
+    if (  false
+          || (!readFirstLine(cacheDir + "/level", level))
+          || (!readFirstLine(cacheDir + "/type", type))
+          || (!readFirstLine(cacheDir + "/size", size))
+      ){
+      break ;
+    }
+    if (type == "Instruction"){
+      continue ;
+    }
+    isDiscovered = true;
+    auto levelID = (uint32_t)atoi(level.c_str());
+    auto bytes = parseBytes(size);
+    if (levelID == 1){
+      t.l1DataCacheBytes = bytes;
+      if (  true
+            && readFirstLine(cacheDir + "/coherency_line_size", lineSize)
+            && (atoi(lineSize.c_str()) > 0)
+        ){
+        t.cacheLineBytes = atoi(lineSize.c_str());
+      }
+    } else if (levelID == 2){
+      t.l2CacheBytes = bytes;
+    }
+    if (levelID >= lastLevel){
+      lastLevel = levelID;
+      t.lastLevelCacheBytes = bytes;
+    }
+  }
+
+  /*
+   * Fall back to the C library, which relies on cpuid on x86.
+   */
+  #if defined(_SC_LEVEL1_DCACHE_LINESIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+  if (!isDiscovered){
+    if (sysconf(_SC_LEVEL1_DCACHE_LINESIZE) > 0){
+      t.cacheLineBytes = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    }
+    if (sysconf(_SC_LEVEL1_DCACHE_SIZE) > 0){
+      t.l1DataCacheBytes = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    }
+    if (sysconf(_SC_LEVEL2_CACHE_SIZE) > 0){
+      t.l2CacheBytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+      t.lastLevelCacheBytes = t.l2CacheBytes;
+    }
+    if (sysconf(_SC_LEVEL3_CACHE_SIZE) > 0){
+      t.lastLevelCacheBytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    }
+  }
+  #endif
+
+  /*
+   * Apply the options of the user.
+   */
+  if (CacheLineBytes > 0){
+    t.cacheLineBytes = CacheLineBytes;
+  }
+  if (L1DataCacheKB > 0){
+    t.l1DataCacheBytes = ((uint64_t)L1DataCacheKB) * 1024;
+  }
+  if (L2CacheKB > 0){
+    t.l2CacheBytes = ((uint64_t)L2CacheKB) * 1024;
+  }
+  if (LastLevelCacheKB > 0){
+    t.lastLevelCacheBytes = ((uint64_t)LastLevelCacheKB) * 1024;
+  }
+
+  return ;
 }
@@ -20,7 +20,29 @@ namespace llvm {
       std::vector<Type *> queueElementTypes;
       std::vector<Function *> queuePushes;
       std::vector<Function *> queuePops;
+      std::vector<Function *> queueFlushes;
       std::vector<Type *> queueTypes;
+
+      /*
+       * Index of the queue functions and types that handle entries of any size (e.g., several values packed together).
+       */
+      int entryQueueIndex;
+
+      /*
+       * Index of the queue functions and types that deliver each entry to several consumers.
+       */
+      int broadcastQueueIndex;
+
+      int getQueueIndex (int bitLength, bool isBroadcast = false) {
+        if (isBroadcast) {
+          return broadcastQueueIndex;
+        }
+        auto queueIt = queueSizeToIndex.find(bitLength);
+        if (queueIt == queueSizeToIndex.end()) {
+          return entryQueueIndex;
+        }
+        return queueIt->second;
+      }
   };
 
 }
@@ -99,6 +99,36 @@ namespace llvm {
 
       double getAverageTotalInstructionsPerIteration (LoopStructure *loop) const ;
 
+      /*
+       * Return true if the loop @l has been profiled by noelle-prof-loops (see noelle-meta-loop-prof-embed).
+       */
+      bool hasCycles (LoopStructure *l) const ;
+
+      /*
+       * Return the cycles spent in @l including the ones spent in its nested loops and callees.
+       */
+      uint64_t getTotalCycles (LoopStructure *l) const ;
+
+      /*
+       * Return the cycles spent in @l excluding the ones spent in the profiled loops nested within it (including the ones of its callees).
+       */
+      uint64_t getSelfCycles (LoopStructure *l) const ;
+
+      /*
+       * Return the histogram of the iterations per invocation of @l.
+       * Element 0 counts the invocations without iterations, and element b > 0 the ones with [2^(b-1), 2^b) iterations.
+       */
+      std::vector<uint64_t> getIterationsHistogram (LoopStructure *l) const ;
+
+      /*
+       * Return the fraction of the cycles of the program spent in @loop.
+       *
+       * @return Between 0 and 1
+       */
+      double getDynamicTotalCycleCoverage (LoopStructure *loop) const ;
+
+      void setLoopProfile (BasicBlock *header, uint64_t invocations, uint64_t iterations, uint64_t totalCycles, uint64_t selfCycles, std::vector<uint64_t> const &histogram);
+
       /*
        * =========================== Functions ==================================
        */
@@ -126,6 +156,15 @@ namespace llvm {
 
       uint64_t getTotalInstructions (void) const ;
 
+      /*
+       * Return true if the program has been profiled by noelle-prof-loops.
+       */
+      bool hasCycles (void) const ;
+
+      uint64_t getTotalCycles (void) const ;
+
+      void setProgramCycles (uint64_t cycles);
+
  
       /*
        * =========================== Branches ====================================
@@ -138,6 +177,14 @@ namespace llvm {
       void computeProgramInvocations (Module &M);
 
     private:
+      struct LoopProfile {
+        uint64_t invocations;
+        uint64_t iterations;
+        uint64_t totalCycles;
+        uint64_t selfCycles;
+        std::vector<uint64_t> histogram;
+      };
+
       std::unordered_map<BasicBlock *, std::unordered_map<BasicBlock *, double>> branchProbability;
       std::unordered_map<BasicBlock *, uint64_t> bbInvocations;
       std::unordered_map<Function *, uint64_t> functionInvocations;
@@ -145,6 +192,8 @@ namespace llvm {
       std::unordered_map<Function *, uint64_t> functionTotalInstructions;
       std::unordered_map<Instruction *, uint64_t> instructionTotalInstructions;
       uint64_t moduleNumberOfInstructionsExecuted;
+      std::unordered_map<BasicBlock *, LoopProfile> loopProfiles;
+      uint64_t moduleCycles;
 
       void computeTotalInstructions (Module &M); 
 
@@ -36,5 +36,7 @@ namespace llvm {
       Hot hot;
 
       void analyzeProfiles (Module &M);
+
+      void analyzeLoopProfiles (Module &M);
   };
 }
@@ -16,7 +16,8 @@
 using namespace llvm ;
 
 Hot::Hot ()
-  : moduleNumberOfInstructionsExecuted{0}
+  : moduleNumberOfInstructionsExecuted{0},
+    moduleCycles{0}
   {
   return ;
 }
@@ -78,6 +78,59 @@ void HotProfiler::analyzeProfiles (Module &M){
    */
   this->hot.computeProgramInvocations(M);
 
+  /*
+   * Fetch the loop profile if it has been embedded.
+   */
+  this->analyzeLoopProfiles(M);
+
+  return ;
+}
+
+void HotProfiler::analyzeLoopProfiles (Module &M){
+
+  /*
+   * Check if the profile generated by noelle-prof-loops has been embedded (see noelle-meta-loop-prof-embed).
+   */
+  auto programM = M.getNamedMetadata("noelle.module.loop_profile");
+  if (  false
+        || (programM == nullptr)
+        || (programM->getNumOperands() == 0)
+    ){
+    return ;
+  }
+  auto getCounter = [](const MDOperand &operand) -> uint64_t {
+    return std::stoull(cast<MDString>(operand)->getString().str());
+  };
+  this->hot.setProgramCycles(getCounter(programM->getOperand(0)->getOperand(0)));
+
+  /*
+   * Fetch the profiles of the loops, which are attached to the terminators of their headers.
+   */
+  for (auto &F : M){
+    for (auto &bb : F){
+      auto terminator = bb.getTerminator();
+      if (terminator == nullptr){
+        continue ;
+      }
+      auto loopM = terminator->getMetadata("noelle.loop_profile");
+      if (loopM == nullptr){
+        continue ;
+      }
+      std::vector<uint64_t> histogram;
+      for (auto i = 4u; i < loopM->getNumOperands(); i++){
+        histogram.push_back(getCounter(loopM->getOperand(i)));
+      }
+      this->hot.setLoopProfile(
+        &bb,
+        getCounter(loopM->getOperand(0)),
+        getCounter(loopM->getOperand(1)),
+        getCounter(loopM->getOperand(2)),
+        getCounter(loopM->getOperand(3)),
+        histogram
+        );
+    }
+  }
+
   return ;
 }
 
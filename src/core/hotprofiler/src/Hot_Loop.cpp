@@ -17,6 +17,14 @@ using namespace llvm ;
       
 uint64_t Hot::getInvocations (LoopStructure *l) const {
 
+  /*
+   * Check if the loop has been profiled natively.
+   */
+  auto profileIt = this->loopProfiles.find(l->getHeader());
+  if (profileIt != this->loopProfiles.end()){
+    return profileIt->second.invocations;
+  }
+
   /*
    * Fetch the pre-header.
    */
@@ -126,6 +134,14 @@ double Hot::getAverageTotalInstructionsPerIteration (LoopStructure *loop) const
 
 uint64_t Hot::getIterations (LoopStructure *l) const {
 
+  /*
+   * Check if the loop has been profiled natively.
+   */
+  auto profileIt = this->loopProfiles.find(l->getHeader());
+  if (profileIt != this->loopProfiles.end()){
+    return profileIt->second.iterations;
+  }
+
   /*
    * Fetch the header.
    */
@@ -156,3 +172,51 @@ uint64_t Hot::getIterations (LoopStructure *l) const {
 
   return loopIterations;
 }
+
+bool Hot::hasCycles (LoopStructure *l) const {
+  return this->loopProfiles.find(l->getHeader()) != this->loopProfiles.end();
+}
+
+uint64_t Hot::getTotalCycles (LoopStructure *l) const {
+  auto profileIt = this->loopProfiles.find(l->getHeader());
+  if (profileIt == this->loopProfiles.end()){
+    return 0;
+  }
+
+  return profileIt->second.totalCycles;
+}
+
+uint64_t Hot::getSelfCycles (LoopStructure *l) const {
+  auto profileIt = this->loopProfiles.find(l->getHeader());
+  if (profileIt == this->loopProfiles.end()){
+    return 0;
+  }
+
+  return profileIt->second.selfCycles;
+}
+
+std::vector<uint64_t> Hot::getIterationsHistogram (LoopStructure *l) const {
+  auto profileIt = this->loopProfiles.find(l->getHeader());
+  if (profileIt == this->loopProfiles.end()){
+    return {};
+  }
+
+  return profileIt->second.histogram;
+}
+
+double Hot::getDynamicTotalCycleCoverage (LoopStructure *loop) const {
+  auto mCycles = this->getTotalCycles();
+  if (mCycles == 0){
+    return 0;
+  }
+  auto lCycles = this->getTotalCycles(loop);
+  auto hotness = ((double)lCycles) / ((double)mCycles);
+
+  return hotness;
+}
+
+void Hot::setLoopProfile (BasicBlock *header, uint64_t invocations, uint64_t iterations, uint64_t totalCycles, uint64_t selfCycles, std::vector<uint64_t> const &histogram){
+  this->loopProfiles[header] = LoopProfile{invocations, iterations, totalCycles, selfCycles, histogram};
+
+  return ;
+}
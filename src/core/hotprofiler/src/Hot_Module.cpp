@@ -38,3 +38,17 @@ bool Hot::getInvocations (void) const {
 uint64_t Hot::getTotalInstructions (void) const {
   return this->getSelfInstructions();
 }
+
+bool Hot::hasCycles (void) const {
+  return this->moduleCycles > 0;
+}
+
+uint64_t Hot::getTotalCycles (void) const {
+  return this->moduleCycles;
+}
+
+void Hot::setProgramCycles (uint64_t cycles){
+  this->moduleCycles = cycles;
+
+  return ;
+}
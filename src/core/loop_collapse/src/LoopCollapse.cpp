@@ -0,0 +1,421 @@
+/*
+ * Copyright 2019 - 2020 Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopCollapse.hpp"
+#include "llvm/Analysis/ValueTracking.h"
+
+using namespace llvm;
+
+LoopCollapser::LoopCollapser(){
+  return ;
+}
+
+bool LoopCollapser::collapseLoop (
+  LoopDependenceInfo &LDI
+  ){
+
+  /*
+   * Fetch the loop to collapse.
+   * It must include a single loop.
+   */
+  auto outerLoop = LDI.getLoopStructure();
+  auto subLoops = outerLoop->getChildren();
+  if (subLoops.size() != 1){
+    return false;
+  }
+  auto innerLoop = *subLoops.begin();
+
+  /*
+   * Check if the two loops can be collapsed.
+   */
+  if (!this->canCollapseLoops(LDI, outerLoop, innerLoop)){
+    return false;
+  }
+
+  /*
+   * Collapse the loops.
+   */
+  return this->collapseLoops(LDI, outerLoop, innerLoop);
+}
+
+bool LoopCollapser::canCollapseLoops (
+  LoopDependenceInfo &LDI,
+  LoopStructure *outerLoop,
+  LoopStructure *innerLoop
+  ){
+
+  /*
+   * Both loops must be governed by an induction variable.
+   */
+  auto IVM = LDI.getInductionVariableManager();
+  auto outerAttribution = IVM->getLoopGoverningIVAttribution(*outerLoop);
+  auto innerAttribution = IVM->getLoopGoverningIVAttribution(*innerLoop);
+  if (  false
+        || (outerAttribution == nullptr)
+        || (innerAttribution == nullptr)
+    ){
+    return false;
+  }
+
+  /*
+   * Both loops must have a single exit, which is taken from their header.
+   * Moreover, the header of the inner loop must not be its latch; otherwise the body of the inner loop executes before the exit condition is evaluated.
+   */
+  auto innerHeader = innerLoop->getHeader();
+  auto innerLatches = innerLoop->getLatches();
+  auto outerExitEdges = outerLoop->getLoopExitEdges();
+  auto innerExitEdges = innerLoop->getLoopExitEdges();
+  if (  false
+        || (outerExitEdges.size() != 1)
+        || (innerExitEdges.size() != 1)
+        || (outerExitEdges[0].first != outerLoop->getHeader())
+        || (innerExitEdges[0].first != innerHeader)
+        || (innerLatches.size() != 1)
+        || (innerLatches.count(innerHeader) > 0)
+    ){
+    return false;
+  }
+
+  /*
+   * The outer loop must be entered through a preheader that unconditionally jumps to it.
+   */
+  auto preheader = outerLoop->getPreHeader();
+  if (preheader == nullptr){
+    return false;
+  }
+  auto preheaderTerminator = dyn_cast<BranchInst>(preheader->getTerminator());
+  if (  false
+        || (preheaderTerminator == nullptr)
+        || (preheaderTerminator->isConditional())
+    ){
+    return false;
+  }
+
+  /*
+   * The collapsed loop jumps to the exit of the outer loop from the header of the inner one.
+   * Hence, the exit block of the outer loop must not depend on which block jumps to it.
+   */
+  auto exitBlock = outerLoop->getLoopExitBasicBlocks()[0];
+  if (exitBlock->phis().begin() != exitBlock->phis().end()){
+    return false;
+  }
+
+  /*
+   * The values of both induction variables will be recomputed from the collapsed one.
+   * Hence, the trip count of both loops must be computable before entering the outer loop.
+   */
+  if (  false
+        || (!this->canComputeTheTripCountBeforeEnteringTheNest(outerLoop, outerLoop, outerAttribution))
+        || (!this->canComputeTheTripCountBeforeEnteringTheNest(outerLoop, innerLoop, innerAttribution))
+    ){
+    return false;
+  }
+
+  /*
+   * The header of the inner loop must include only the loop-governing induction variable as PHI.
+   * Other PHIs (e.g., accumulators) would be re-initialized at every iteration of the outer loop, which the collapsed loop cannot do.
+   */
+  auto innerIVPHI = innerAttribution->getInductionVariable().getLoopEntryPHI();
+  for (auto &phi : innerHeader->phis()){
+    if (&phi != innerIVPHI){
+      return false;
+    }
+  }
+
+  /*
+   * The header of the inner loop runs once more than the body of the inner loop at every iteration of the outer loop.
+   * Once collapsed, it runs once more in total and with values of the outer induction variable that are beyond its exit value.
+   * Therefore, the header must only include instructions that can be speculatively executed.
+   */
+  for (auto &inst : *innerHeader){
+    if (  false
+          || isa<PHINode>(&inst)
+          || inst.isTerminator()
+      ){
+      continue ;
+    }
+    if (!isSafeToSpeculativelyExecute(&inst)){
+      return false;
+    }
+  }
+
+  /*
+   * The two loops must be perfectly nested.
+   */
+  if (!this->isPerfectlyNested(outerLoop, innerLoop, outerAttribution)){
+    return false;
+  }
+
+  /*
+   * Values computed within the nest must not be used outside it.
+   */
+  for (auto inst : outerLoop->getInstructions()){
+    for (auto user : inst->users()){
+      auto userInst = dyn_cast<Instruction>(user);
+      if (  false
+            || (userInst == nullptr)
+            || (!outerLoop->isIncluded(userInst))
+        ){
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool LoopCollapser::isPerfectlyNested (
+  LoopStructure *outerLoop,
+  LoopStructure *innerLoop,
+  LoopGoverningIVAttribution *outerAttribution
+  ){
+
+  /*
+   * Every iteration of the outer loop must only execute the inner loop.
+   * Hence, the code of the outer loop that does not belong to the inner loop can only be used to compute the outer induction variable and to decide whether to exit the outer loop.
+   */
+  auto outerIVPHI = outerAttribution->getInductionVariable().getLoopEntryPHI();
+  auto outerBranch = outerAttribution->getHeaderBrInst();
+  for (auto bb : outerLoop->getBasicBlocks()){
+    if (innerLoop->isIncluded(bb)){
+      continue ;
+    }
+    for (auto &inst : *bb){
+
+      /*
+       * The outer induction variable will be recomputed from the collapsed one.
+       */
+      if (&inst == outerIVPHI){
+        continue ;
+      }
+      if (isa<PHINode>(&inst)){
+        return false;
+      }
+
+      /*
+       * The only conditional branch allowed is the one that exits the outer loop.
+       */
+      if (inst.isTerminator()){
+        if (&inst == outerBranch){
+          continue ;
+        }
+        auto br = dyn_cast<BranchInst>(&inst);
+        if (  false
+              || (br == nullptr)
+              || (br->isConditional())
+          ){
+          return false;
+        }
+        continue ;
+      }
+
+      /*
+       * The instruction will be removed.
+       * Hence, it must not have side effects and its result must only be used by other instructions that will be removed.
+       */
+      if (  false
+            || inst.mayHaveSideEffects()
+            || inst.mayReadOrWriteMemory()
+        ){
+        return false;
+      }
+      for (auto user : inst.users()){
+        auto userInst = cast<Instruction>(user);
+        if (  false
+              || (!outerLoop->isIncluded(userInst))
+              || innerLoop->isIncluded(userInst)
+          ){
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+bool LoopCollapser::canComputeTheTripCountBeforeEnteringTheNest (
+  LoopStructure *outerLoop,
+  LoopStructure *loop,
+  LoopGoverningIVAttribution *attribution
+  ){
+
+  /*
+   * The induction variable must be an integer with a constant step.
+   */
+  auto &IV = attribution->getInductionVariable();
+  auto startValue = IV.getStartValue();
+  auto stepValue = IV.getSingleComputedStepValue();
+  if (  false
+        || (!startValue->getType()->isIntegerTy())
+        || (stepValue == nullptr)
+        || (!isa<ConstantInt>(stepValue))
+    ){
+    return false;
+  }
+
+  /*
+   * The start and the exit values must be invariant of the whole nest.
+   */
+  if (attribution->getConditionValueDerivation().size() > 0){
+    return false;
+  }
+  auto exitValue = attribution->getHeaderCmpInstConditionValue();
+  for (auto value : { startValue, exitValue }){
+    auto inst = dyn_cast<Instruction>(value);
+    if (  true
+          && (inst != nullptr)
+          && outerLoop->isIncluded(inst)
+      ){
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool LoopCollapser::collapseLoops (
+  LoopDependenceInfo &LDI,
+  LoopStructure *outerLoop,
+  LoopStructure *innerLoop
+  ){
+
+  /*
+   * Fetch the induction variables of the two loops.
+   */
+  auto IVM = LDI.getInductionVariableManager();
+  auto outerAttribution = IVM->getLoopGoverningIVAttribution(*outerLoop);
+  auto innerAttribution = IVM->getLoopGoverningIVAttribution(*innerLoop);
+  auto &outerIV = outerAttribution->getInductionVariable();
+  auto &innerIV = innerAttribution->getInductionVariable();
+
+  /*
+   * Fetch the basic blocks we need.
+   */
+  auto f = outerLoop->getFunction();
+  auto preheader = outerLoop->getPreHeader();
+  auto exitBlock = outerLoop->getLoopExitBasicBlocks()[0];
+  auto innerHeader = innerLoop->getHeader();
+  auto innerLatch = *innerLoop->getLatches().begin();
+  auto int64 = IntegerType::get(f->getContext(), 64);
+
+  /*
+   * Compute the trip counts of the two loops.
+   * The code is generated in a separate basic block first, so it can be dropped if a trip count cannot be computed.
+   */
+  auto tripCountsBB = BasicBlock::Create(f->getContext(), "", f);
+  IRBuilder<> tripCountsBuilder(tripCountsBB);
+  LoopGoverningIVUtility outerIVUtility(outerIV, *outerAttribution);
+  LoopGoverningIVUtility innerIVUtility(innerIV, *innerAttribution);
+  auto outerTripCount = outerIVUtility.generateCodeToComputeTheTripCount(tripCountsBuilder, int64);
+  auto innerTripCount = innerIVUtility.generateCodeToComputeTheTripCount(tripCountsBuilder, int64);
+  if (  false
+        || (outerTripCount == nullptr)
+        || (innerTripCount == nullptr)
+    ){
+    tripCountsBB->eraseFromParent();
+    return false;
+  }
+  auto tripCount = tripCountsBuilder.CreateMul(outerTripCount, innerTripCount);
+
+  /*
+   * Move the computation of the trip counts to the preheader of the outer loop.
+   */
+  auto preheaderTerminator = preheader->getTerminator();
+  std::vector<Instruction *> tripCountsComputation;
+  for (auto &inst : *tripCountsBB){
+    tripCountsComputation.push_back(&inst);
+  }
+  for (auto inst : tripCountsComputation){
+    inst->moveBefore(preheaderTerminator);
+  }
+  tripCountsBB->eraseFromParent();
+
+  /*
+   * Enter the collapsed loop only if it has at least one iteration.
+   */
+  IRBuilder<> preheaderBuilder(preheaderTerminator);
+  auto isEmpty = preheaderBuilder.CreateICmpEQ(tripCount, ConstantInt::get(int64, 0));
+  preheaderBuilder.CreateCondBr(isEmpty, exitBlock, innerHeader);
+  preheaderTerminator->eraseFromParent();
+
+  /*
+   * Add the induction variable of the collapsed loop.
+   */
+  IRBuilder<> headerBuilder(innerHeader->getFirstNonPHI());
+  auto collapsedIV = headerBuilder.CreatePHI(int64, 2);
+  IRBuilder<> latchBuilder(innerLatch->getTerminator());
+  auto nextCollapsedIV = latchBuilder.CreateAdd(collapsedIV, ConstantInt::get(int64, 1));
+  collapsedIV->addIncoming(ConstantInt::get(int64, 0), preheader);
+  collapsedIV->addIncoming(nextCollapsedIV, innerLatch);
+
+  /*
+   * Recompute the values of the original induction variables from the collapsed one.
+   */
+  headerBuilder.SetInsertPoint(innerHeader->getFirstNonPHI());
+  auto outerIteration = headerBuilder.CreateUDiv(collapsedIV, innerTripCount);
+  auto innerIteration = headerBuilder.CreateURem(collapsedIV, innerTripCount);
+  auto computeIVValue = [&headerBuilder](InductionVariable &IV, Value *iteration) -> Value * {
+    auto startValue = IV.getStartValue();
+    auto scaledIteration = headerBuilder.CreateMul(
+      headerBuilder.CreateZExtOrTrunc(iteration, startValue->getType()),
+      IV.getSingleComputedStepValue()
+    );
+    return headerBuilder.CreateAdd(startValue, scaledIteration);
+  };
+  auto outerIVValue = computeIVValue(outerIV, outerIteration);
+  auto innerIVValue = computeIVValue(innerIV, innerIteration);
+
+  /*
+   * Exit the collapsed loop from the header of the inner loop once all iterations of the nest have been executed.
+   */
+  auto innerBranch = innerAttribution->getHeaderBrInst();
+  auto innerCmp = innerAttribution->getHeaderCmpInst();
+  auto bodyBB = innerBranch->getSuccessor(0);
+  if (bodyBB == innerAttribution->getExitBlockFromHeader()){
+    bodyBB = innerBranch->getSuccessor(1);
+  }
+  IRBuilder<> branchBuilder(innerBranch);
+  auto isDone = branchBuilder.CreateICmpEQ(collapsedIV, tripCount);
+  branchBuilder.CreateCondBr(isDone, exitBlock, bodyBB);
+  innerBranch->eraseFromParent();
+  if (innerCmp->use_empty()){
+    innerCmp->eraseFromParent();
+  }
+
+  /*
+   * Replace the original induction variables.
+   */
+  auto outerIVPHI = outerIV.getLoopEntryPHI();
+  auto innerIVPHI = innerIV.getLoopEntryPHI();
+  innerIVPHI->replaceAllUsesWith(innerIVValue);
+  innerIVPHI->eraseFromParent();
+  outerIVPHI->replaceAllUsesWith(outerIVValue);
+  outerIVPHI->eraseFromParent();
+
+  /*
+   * Remove the code of the outer loop that does not belong to the inner loop.
+   * This code is now unreachable.
+   */
+  std::vector<BasicBlock *> bbsToDelete;
+  for (auto bb : outerLoop->getBasicBlocks()){
+    if (!innerLoop->isIncluded(bb)){
+      bbsToDelete.push_back(bb);
+    }
+  }
+  for (auto bb : bbsToDelete){
+    bb->dropAllReferences();
+  }
+  for (auto bb : bbsToDelete){
+    bb->eraseFromParent();
+  }
+
+  return true;
+}
@@ -15,12 +15,15 @@
 
 namespace llvm {
 
+  class EnvBuilder;
+
   class EnvUserBuilder {
    public:
-    EnvUserBuilder ();
+    EnvUserBuilder (EnvBuilder *envBuilder);
     ~EnvUserBuilder ();
 
     void setEnvArray (Value *envArr) { this->envArray = envArr; }
+    Value *getEnvArray () { return this->envArray; }
     void createEnvPtr (IRBuilder<> b, int envIndex, Type *type);
     void createReducableEnvPtr (
       IRBuilder<> b,
@@ -43,6 +46,7 @@ namespace llvm {
     Instruction *getEnvPtr (int ind) { return envIndexToPtr[ind]; }
 
    private:
+    EnvBuilder *envBuilder;
     Value *envArray;
 
 		/*
@@ -69,6 +73,18 @@ namespace llvm {
       int reducerCount
     );
 
+    /*
+     * Variables in readOnlyVarIndices (a subset of singleVarIndices) are only read by the users.
+     * They are packed next to each other at the beginning of the environment array, while every other variable takes its own cache line.
+     */
+    void createEnvVariables (
+      std::vector<Type *> &varTypes,
+      std::set<int> &singleVarIndices,
+      std::set<int> &reducableVarIndices,
+      std::set<int> &readOnlyVarIndices,
+      int reducerCount
+    );
+
     /*
      * Generate code to create environment array/variable allocations
      */
@@ -87,6 +103,21 @@ namespace llvm {
       Value *numberOfThreadsExecuted
     );
 
+    /*
+     * Generate code in the exit block of a task to combine the private copies of its reducible live-out variables pairwise in a tree.
+     * Each task instance waits for its partners, and the private copy of the task instance 0 ends up holding the value of all of them.
+     * The reduction of the caller (reduceLiveOutVariables) then only reads that copy.
+     */
+    void reduceLiveOutVariablesInTask (
+      int user,
+      BasicBlock *taskExit,
+      std::unordered_map<int, int> &reducableBinaryOps,
+      Value *taskInstanceID,
+      Value *numberOfTaskInstances
+    );
+
+    bool areLiveOutVariablesReducedInTasks (void) const { return this->reductionFlagsIndex != -1; }
+
     /*
      * As all users of the environment konw its structure,
      *  pass around the equivalent of a void pointer
@@ -98,6 +129,11 @@ namespace llvm {
     EnvUserBuilder *getUser (int user) { return envUsers[user]; }
     int getNumUsers () { return envUsers.size(); }
 
+    /*
+     * Return the offset (in 64-bit words) of a variable within the environment array.
+     */
+    uint64_t getEnvVarOffset (int ind) ;
+
     Value *getEnvVar (int ind) ;
     Value *getAccumulatedReducableEnvVar (int ind) ;
     Value *getReducableEnvVar (int ind, int reducerInd) ;
@@ -118,12 +154,18 @@ namespace llvm {
     int envSize;
     ArrayType *envArrayType;
     std::vector<Type *> envTypes;
+    std::unordered_map<int, uint64_t> envIndexToOffset;
     std::unordered_map<int, Value *> envIndexToVar;
     std::unordered_map<int, Value *> envIndexToAccumulatedReducableVar;
     std::unordered_map<int, std::vector<Value *>> envIndexToReducableVar;
     std::unordered_map<int, AllocaInst *> envIndexToVectorOfReducableVar;
     int numReducers;
 
+    /*
+     * When tasks reduce live-out variables, the second word of each private copy of this variable is the flag that states the copy is ready to be combined.
+     */
+    int reductionFlagsIndex;
+
     /*
      * Information on a specific user (a function, stage, chunk, etc...)
      */
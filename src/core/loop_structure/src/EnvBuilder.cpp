@@ -13,8 +13,8 @@
 
 using namespace llvm ;
 
-EnvUserBuilder::EnvUserBuilder ()
-  : envIndexToPtr{}, liveInInds{}, liveOutInds{} {
+EnvUserBuilder::EnvUserBuilder (EnvBuilder *envBuilder)
+  : envBuilder{envBuilder}, envIndexToPtr{}, liveInInds{}, liveOutInds{} {
   envIndexToPtr.clear();
   liveInInds.clear();
   liveOutInds.clear();
@@ -35,13 +35,7 @@ void EnvUserBuilder::createEnvPtr (
 
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
-
-  /*
-   * Compute how many values can fit in a cache line.
-   */
-  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
-
-  auto envIndV = cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+  auto envIndV = cast<Value>(ConstantInt::get(int64, this->envBuilder->getEnvVarOffset(envIndex)));
 
   auto envGEP = builder.CreateInBoundsGEP(
     this->envArray,
@@ -73,7 +67,7 @@ void EnvUserBuilder::createReducableEnvPtr (
   auto ptrTy_int8 = PointerType::getUnqual(int8);
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
-  auto envIndV = cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+  auto envIndV = cast<Value>(ConstantInt::get(int64, this->envBuilder->getEnvVarOffset(envIndex)));
 
   auto envReduceGEP = builder.CreateInBoundsGEP(
     this->envArray,
@@ -95,7 +89,7 @@ void EnvUserBuilder::createReducableEnvPtr (
 EnvBuilder::EnvBuilder (LLVMContext &cxt)
   : CXT{cxt}, envTypes{}, envUsers{},
     envIndexToVar{}, envIndexToReducableVar{}, envIndexToVectorOfReducableVar{},
-    numReducers{-1}, envSize{-1} {
+    numReducers{-1}, envSize{-1}, reductionFlagsIndex{-1} {
   envIndexToVar.clear();
   envIndexToReducableVar.clear();
   envIndexToVectorOfReducableVar.clear();
@@ -112,15 +106,28 @@ EnvBuilder::~EnvBuilder () {
 
 void EnvBuilder::createEnvUsers (int numUsers) {
   for (int i = 0; i < numUsers; ++i) {
-    this->envUsers.push_back(new EnvUserBuilder());
+    this->envUsers.push_back(new EnvUserBuilder(this));
   }
 }
 
+void EnvBuilder::createEnvVariables (
+  std::vector<Type *> &varTypes,
+  std::set<int> &singleVarIndices,
+  std::set<int> &reducableVarIndices,
+  int reducerCount
+) {
+  std::set<int> readOnlyVarIndices;
+  this->createEnvVariables(varTypes, singleVarIndices, reducableVarIndices, readOnlyVarIndices, reducerCount);
+
+  return ;
+}
+
 // TODO: Adjust users of createEnvVariables to pass the Type map
 void EnvBuilder::createEnvVariables (
   std::vector<Type *> &varTypes,
   std::set<int> &singleVarIndices,
   std::set<int> &reducableVarIndices,
+  std::set<int> &readOnlyVarIndices,
   int reducerCount
 ) {
   assert(envSize == -1 && "Environment variables must be fully determined at once\n");
@@ -135,8 +142,39 @@ void EnvBuilder::createEnvVariables (
    */
   auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
 
+  /*
+   * Pack the read-only variables that fit in a 64-bit word.
+   * This way, a task that loads N of them touches N / valuesInCacheLine cache lines rather than N.
+   */
+  uint64_t packedValues = 0;
+  for (auto envIndex : readOnlyVarIndices) {
+    assert(singleVarIndices.find(envIndex) != singleVarIndices.end());
+    auto varType = this->envTypes[envIndex];
+    if (!(  false
+            || varType->isPointerTy()
+            || (varType->isIntegerTy() && (varType->getIntegerBitWidth() <= 64))
+            || varType->isFloatTy()
+            || varType->isDoubleTy()
+         )){
+      continue ;
+    }
+    this->envIndexToOffset[envIndex] = packedValues++;
+  }
+
+  /*
+   * Every other variable takes its own cache line after the packed ones (so written variables never share a line with others).
+   */
+  auto cacheLines = (packedValues + valuesInCacheLine - 1) / valuesInCacheLine;
+  for (auto envIndex = 0; envIndex < this->envSize; envIndex++) {
+    if (this->envIndexToOffset.find(envIndex) != this->envIndexToOffset.end()) {
+      continue ;
+    }
+    this->envIndexToOffset[envIndex] = cacheLines * valuesInCacheLine;
+    cacheLines++;
+  }
+
   auto int64 = IntegerType::get(this->CXT, 64);
-  this->envArrayType = ArrayType::get(int64, this->envSize * valuesInCacheLine);
+  this->envArrayType = ArrayType::get(int64, cacheLines * valuesInCacheLine);
 
   numReducers = reducerCount;
   for (auto envIndex : singleVarIndices) {
@@ -156,7 +194,9 @@ void EnvBuilder::generateEnvArray (IRBuilder<> builder) {
 
   auto int8 = IntegerType::get(builder.getContext(), 8);
   auto ptrTy_int8 = PointerType::getUnqual(int8);
-  this->envArray = builder.CreateAlloca(this->envArrayType);
+  auto envAlloca = builder.CreateAlloca(this->envArrayType);
+  envAlloca->setAlignment(Architecture::getCacheLineBytes());
+  this->envArray = envAlloca;
   this->envArrayInt8Ptr = cast<Value>(builder.CreateBitCast(this->envArray, ptrTy_int8));
 }
 
@@ -175,19 +215,13 @@ void EnvBuilder::generateEnvVariables (IRBuilder<> builder) {
   auto ptrTy_int8 = PointerType::getUnqual(int8);
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
-  auto fetchCastedEnvPtr = [&](Value *arr, int envIndex, Type *ptrType) -> Value * {
-
-    /*
-     * Compute the offset of the variable with index "envIndex" that is stored inside the environment.
-     *
-     * Compute how many values can fit in a cache line.
-     */
-    auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
-    auto indValue = cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
+  auto fetchCastedEnvPtr = [&](Value *arr, uint64_t offset, Type *ptrType) -> Value * {
 
     /*
-     * Compute the address of the variable with index "envIndex".
+     * Compute the address of the variable stored "offset" 64-bit words from the beginning of the array.
      */
+    auto indValue = cast<Value>(ConstantInt::get(int64, offset));
     auto envPtr = builder.CreateInBoundsGEP(arr, ArrayRef<Value*>({ zeroV, indValue }));
 
     /*
@@ -209,7 +243,7 @@ void EnvBuilder::generateEnvVariables (IRBuilder<> builder) {
   }
   for (auto envIndex : singleIndices) {
     auto ptrType = PointerType::getUnqual(envTypes[envIndex]);
-    envIndexToVar[envIndex] = fetchCastedEnvPtr(this->envArray, envIndex, ptrType);
+    envIndexToVar[envIndex] = fetchCastedEnvPtr(this->envArray, this->getEnvVarOffset(envIndex), ptrType);
   }
 
   /*
@@ -233,7 +267,6 @@ void EnvBuilder::generateEnvVariables (IRBuilder<> builder) {
     /*
      * Define the type of the vectorized form of the reducable variable.
      */
-    auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
     auto reduceArrType = ArrayType::get(int64, numReducers * valuesInCacheLine);
 
     /*
@@ -246,16 +279,28 @@ void EnvBuilder::generateEnvVariables (IRBuilder<> builder) {
      * Store the pointer of the vector of the reducable variable inside the environment.
      */
     auto reduceArrPtrType = PointerType::getUnqual(reduceArrAlloca->getType());
-    auto envPtr = fetchCastedEnvPtr(this->envArray, envIndex, reduceArrPtrType);
+    auto envPtr = fetchCastedEnvPtr(this->envArray, this->getEnvVarOffset(envIndex), reduceArrPtrType);
     builder.CreateStore(reduceArrAlloca, envPtr);
 
     /*
      * Compute and cache the pointer of each element of the vectorized variable.
      */
     for (auto i = 0; i < numReducers; ++i) {
-      auto reducePtr = fetchCastedEnvPtr(reduceArrAlloca, i, ptrType);
+      auto reducePtr = fetchCastedEnvPtr(reduceArrAlloca, i * valuesInCacheLine, ptrType);
       envIndexToReducableVar[envIndex].push_back(reducePtr);
     }
+
+    /*
+     * Clear the flags used by the tasks to combine their private copies.
+     * Each task instance that sets its flag has it cleared by the instance that consumes its copy, so the flags are clear at every invocation.
+     */
+    if (envIndex == this->reductionFlagsIndex){
+      for (auto i = 0; i < numReducers; ++i) {
+        auto flagIndex = cast<Value>(ConstantInt::get(int64, (i * valuesInCacheLine) + 1));
+        auto flagPtr = builder.CreateInBoundsGEP(reduceArrAlloca, ArrayRef<Value*>({ zeroV, flagIndex }));
+        builder.CreateStore(ConstantInt::get(int64, 0), flagPtr);
+      }
+    }
   }
 
   return ;
@@ -281,6 +326,29 @@ BasicBlock * EnvBuilder::reduceLiveOutVariables (
    */
   auto f = bb->getParent();
 
+  /*
+   * Check if the tasks have already combined their private copies.
+   * In this case, the private copy of the first task instance holds the value of all of them.
+   */
+  if (this->areLiveOutVariablesReducedInTasks()){
+    auto afterReductionBB = BasicBlock::Create(this->CXT, "AfterReduction", f);
+    auto bbTerminator = bb->getTerminator();
+    if (bbTerminator != nullptr){
+      bbTerminator->eraseFromParent();
+    }
+    IRBuilder<> bbBuilder{bb};
+    for (auto envIndexInitValue : initialValues) {
+      auto envIndex = envIndexInitValue.first;
+      auto initialValue = envIndexInitValue.second;
+      auto binOp = (Instruction::BinaryOps)reducableBinaryOps[envIndex];
+      auto reducedValue = bbBuilder.CreateLoad(envIndexToReducableVar[envIndex][0]);
+      envIndexToAccumulatedReducableVar[envIndex] = bbBuilder.CreateBinOp(binOp, initialValue, reducedValue);
+    }
+    bbBuilder.CreateBr(afterReductionBB);
+
+    return afterReductionBB;
+  }
+
   /*
    * Create a new basic block that will include the loop body.
    */
@@ -454,6 +522,131 @@ BasicBlock * EnvBuilder::reduceLiveOutVariables (
   return afterReductionBB;
 }
 
+void EnvBuilder::reduceLiveOutVariablesInTask (
+  int user,
+  BasicBlock *taskExit,
+  std::unordered_map<int, int> &reducableBinaryOps,
+  Value *taskInstanceID,
+  Value *numberOfTaskInstances
+) {
+
+  /*
+   * Fetch the reducible live-out variables of the task.
+   */
+  auto envUser = this->envUsers[user];
+  std::vector<int> reducedIndices;
+  for (auto envIndex : envUser->getEnvIndicesOfLiveOutVars()) {
+    if (this->isReduced(envIndex)) {
+      reducedIndices.push_back(envIndex);
+    }
+  }
+  if (reducedIndices.size() == 0){
+    return ;
+  }
+
+  /*
+   * The second word of the private copies of the first variable are the flags of the task instances.
+   */
+  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
+  assert(valuesInCacheLine >= 2);
+  this->reductionFlagsIndex = reducedIndices[0];
+
+  /*
+   * The tree runs between the code of the exit block and its PHI nodes.
+   */
+  auto f = taskExit->getParent();
+  auto afterTreeBB = taskExit->splitBasicBlock(taskExit->getFirstNonPHI(), "AfterReductionTree");
+  auto headerBB = BasicBlock::Create(this->CXT, "ReductionTreeHeader", f, afterTreeBB);
+  auto checkBB = BasicBlock::Create(this->CXT, "ReductionTreeCheck", f, afterTreeBB);
+  auto waitBB = BasicBlock::Create(this->CXT, "ReductionTreeWait", f, afterTreeBB);
+  auto combineBB = BasicBlock::Create(this->CXT, "ReductionTreeCombine", f, afterTreeBB);
+  auto signalBB = BasicBlock::Create(this->CXT, "ReductionTreeSignal", f, afterTreeBB);
+  auto setFlagBB = BasicBlock::Create(this->CXT, "ReductionTreeSetFlag", f, afterTreeBB);
+
+  /*
+   * Fetch the private copies of the reducible variables.
+   */
+  taskExit->getTerminator()->eraseFromParent();
+  IRBuilder<> exitBuilder{taskExit};
+  auto int64 = IntegerType::get(this->CXT, 64);
+  auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
+  auto instanceID = exitBuilder.CreateSExtOrTrunc(taskInstanceID, int64);
+  auto numberOfInstances = exitBuilder.CreateSExtOrTrunc(numberOfTaskInstances, int64);
+  std::vector<Value *> privateCopies;
+  for (auto envIndex : reducedIndices) {
+    auto envIndV = cast<Value>(ConstantInt::get(int64, this->getEnvVarOffset(envIndex)));
+    auto envGEP = exitBuilder.CreateInBoundsGEP(envUser->getEnvArray(), ArrayRef<Value*>({ zeroV, envIndV }));
+    auto envPtr = exitBuilder.CreateBitCast(envGEP, PointerType::getUnqual(PointerType::getUnqual(int64)));
+    privateCopies.push_back(exitBuilder.CreateLoad(envPtr));
+  }
+  exitBuilder.CreateBr(headerBB);
+
+  auto fetchPrivateCopy = [int64, valuesInCacheLine](IRBuilder<> &builder, Value *privateCopies, Value *instance, uint64_t word, Type *type) -> Value * {
+    auto offset = builder.CreateAdd(builder.CreateMul(instance, ConstantInt::get(int64, valuesInCacheLine)), ConstantInt::get(int64, word));
+    auto ptr = builder.CreateInBoundsGEP(privateCopies, offset);
+    return builder.CreateBitCast(ptr, PointerType::getUnqual(type));
+  };
+
+  /*
+   * At step "stride", an instance whose ID is a multiple of 2 * stride combines the copy of the instance ID + stride.
+   */
+  IRBuilder<> headerBuilder{headerBB};
+  auto stride = headerBuilder.CreatePHI(int64, 2);
+  stride->addIncoming(ConstantInt::get(int64, 1), taskExit);
+  headerBuilder.CreateCondBr(headerBuilder.CreateICmpSLT(stride, numberOfInstances), checkBB, signalBB);
+
+  /*
+   * An instance stops combining when its copy is consumed by another instance, or when it has no partners left (they would be even further away).
+   */
+  IRBuilder<> checkBuilder{checkBB};
+  auto partnerID = checkBuilder.CreateAdd(instanceID, stride);
+  auto isConsumed = checkBuilder.CreateICmpNE(checkBuilder.CreateAnd(instanceID, stride), zeroV);
+  auto hasPartner = checkBuilder.CreateICmpSLT(partnerID, numberOfInstances);
+  auto mustCombine = checkBuilder.CreateAnd(checkBuilder.CreateNot(isConsumed), hasPartner);
+  checkBuilder.CreateCondBr(mustCombine, waitBB, signalBB);
+
+  /*
+   * Wait for the partner to be done.
+   */
+  IRBuilder<> waitBuilder{waitBB};
+  auto partnerFlagPtr = fetchPrivateCopy(waitBuilder, privateCopies[0], partnerID, 1, int64);
+  auto partnerFlag = waitBuilder.CreateAlignedLoad(partnerFlagPtr, sizeof(int64_t));
+  partnerFlag->setAtomic(AtomicOrdering::Acquire);
+  waitBuilder.CreateCondBr(waitBuilder.CreateICmpEQ(partnerFlag, zeroV), waitBB, combineBB);
+
+  /*
+   * Combine the copy of the partner, and clear its flag for the next invocation.
+   */
+  IRBuilder<> combineBuilder{combineBB};
+  for (auto i = 0; i < reducedIndices.size(); ++i) {
+    auto envIndex = reducedIndices[i];
+    auto binOp = (Instruction::BinaryOps)reducableBinaryOps[envIndex];
+    auto type = this->envTypes[envIndex];
+    auto myPtr = fetchPrivateCopy(combineBuilder, privateCopies[i], instanceID, 0, type);
+    auto partnerPtr = fetchPrivateCopy(combineBuilder, privateCopies[i], partnerID, 0, type);
+    auto myValue = combineBuilder.CreateLoad(myPtr);
+    auto partnerValue = combineBuilder.CreateLoad(partnerPtr);
+    combineBuilder.CreateStore(combineBuilder.CreateBinOp(binOp, myValue, partnerValue), myPtr);
+  }
+  combineBuilder.CreateStore(zeroV, partnerFlagPtr);
+  auto nextStride = combineBuilder.CreateShl(stride, ConstantInt::get(int64, 1));
+  stride->addIncoming(nextStride, combineBB);
+  combineBuilder.CreateBr(headerBB);
+
+  /*
+   * Tell the consumer of our copy (if any) that it is ready.
+   */
+  IRBuilder<> signalBuilder{signalBB};
+  signalBuilder.CreateCondBr(signalBuilder.CreateICmpEQ(instanceID, zeroV), afterTreeBB, setFlagBB);
+  IRBuilder<> setFlagBuilder{setFlagBB};
+  auto myFlagPtr = fetchPrivateCopy(setFlagBuilder, privateCopies[0], instanceID, 1, int64);
+  auto setFlag = setFlagBuilder.CreateAlignedStore(ConstantInt::get(int64, 1), myFlagPtr, sizeof(int64_t));
+  setFlag->setAtomic(AtomicOrdering::Release);
+  setFlagBuilder.CreateBr(afterTreeBB);
+
+  return ;
+}
+
 Value *EnvBuilder::getEnvArrayInt8Ptr () {
   assert(envArrayInt8Ptr);
   return envArrayInt8Ptr;
@@ -464,6 +657,12 @@ Value *EnvBuilder::getEnvArray () {
   return envArray;
 }
 
+uint64_t EnvBuilder::getEnvVarOffset (int ind) {
+  auto iter = envIndexToOffset.find(ind);
+  assert(iter != envIndexToOffset.end());
+  return (*iter).second;
+}
+
 Value *EnvBuilder::getEnvVar (int ind) {
   auto iter = envIndexToVar.find(ind);
   assert(iter != envIndexToVar.end());
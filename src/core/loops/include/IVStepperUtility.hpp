@@ -68,7 +68,17 @@ namespace llvm {
         BasicBlock *exitBlock,
         IRBuilder<> &cloneBuilder) ;
 
+      /*
+       * Generate the code that computes the number of iterations of the loop before entering it.
+       * The code is generated using @builder, which must point to the preheader of the loop.
+       * Return nullptr if the number of iterations cannot be computed at the loop entry.
+       */
+      Value * generateCodeToComputeTheTripCount (
+        IRBuilder<> &builder,
+        Type *tripCountType) ;
+
     private:
+      InductionVariable &IV;
       LoopGoverningIVAttribution &attribution;
       CmpInst *condition;
       std::vector<Instruction *> conditionValueOrderedDerivation;
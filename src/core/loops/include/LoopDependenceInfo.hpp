@@ -159,6 +159,17 @@ namespace llvm {
        */
       bool isSCCContainedInSubloop (SCC *scc) const ;
 
+      /*
+       * Return an SCC whose loop-carried data dependences block running the iterations of the loop in parallel.
+       * Return nullptr if there is none.
+       *
+       * Reducible and clonable SCCs never block the parallelization.
+       * A loop-carried memory dependence does not block it if the two accesses are disjoint between iterations or if @param canIgnoreMemoryDependence returns true for it.
+       */
+      SCC * getSCCBlockingParallelization (
+        std::function<bool (Instruction *fromInst, Instruction *toInst, DGEdge<Value> *dependence)> canIgnoreMemoryDependence = nullptr
+        ) ;
+
       LoopGoverningIVAttribution * getLoopGoverningIVAttribution (void) const ;
 
       InductionVariableManager * getInductionVariableManager (void) const ;
@@ -44,6 +44,25 @@ namespace llvm {
         Instruction *to
       ) const ;
 
+      /*
+       * Bytes accessed by a load or a store at iteration i of an invocation of the top loop:
+       * [base + offset + (step * i), base + offset + (step * i) + accessSize)
+       * where base is a loop-invariant pointer.
+       */
+      struct MemoryAccessRange {
+        Value *base;
+        int64_t offset;
+        int64_t step;
+        uint64_t accessSize;
+      };
+
+      /*
+       * Return the range of bytes accessed by a load or a store of the top loop (nullptr if it cannot be described as above).
+       */
+      const MemoryAccessRange * getMemoryAccessRange (
+        Instruction *memoryInstruction
+      ) const ;
+
     private:
 
       /*
@@ -61,6 +80,13 @@ namespace llvm {
 
       void indexIVInstructionSCEVs (ScalarEvolution &SE) ;
 
+      /*
+       * Ranges of bytes accessed by loads and stores of the top loop
+       */
+      std::unordered_map<Instruction *, MemoryAccessRange> accessRangeByInstruction;
+
+      void computeMemoryAccessRanges (ScalarEvolution &SE) ;
+
       class MemoryAccessSpace {
         public:
         
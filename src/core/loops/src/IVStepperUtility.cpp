@@ -122,7 +122,7 @@ Value *IVUtility::offsetIVPHI (
  */
 
 LoopGoverningIVUtility::LoopGoverningIVUtility (InductionVariable &IV, LoopGoverningIVAttribution &attribution)
-  : attribution{attribution}, conditionValueOrderedDerivation{},
+  : IV{IV}, attribution{attribution}, conditionValueOrderedDerivation{},
     flipOperandsToUseNonStrictPredicate{false}, flipBrSuccessorsToUseNonStrictPredicate{false} {
 
   condition = attribution.getHeaderCmpInst();
@@ -219,6 +219,99 @@ void LoopGoverningIVUtility::cloneConditionalCheckFor(
   cloneBuilder.CreateCondBr(cmpInst, exitBlock, continueBlock);
 }
 
+Value * LoopGoverningIVUtility::generateCodeToComputeTheTripCount (
+  IRBuilder<> &builder,
+  Type *tripCountType
+  ) {
+
+  /*
+   * The value compared with the IV must be available before entering the loop.
+   */
+  if (this->conditionValueOrderedDerivation.size() > 0){
+    return nullptr;
+  }
+  auto exitValue = this->attribution.getHeaderCmpInstConditionValue();
+  auto startValue = this->IV.getStartValue();
+  auto ivType = startValue->getType();
+  if (  false
+        || (!ivType->isIntegerTy())
+        || (exitValue->getType() != ivType)
+    ){
+    return nullptr;
+  }
+
+  /*
+   * Fetch the first value of the IV that is compared with the exit value.
+   * The header compares either the IV itself or its value for the next iteration.
+   */
+  auto stepValue = cast<ConstantInt>(this->IV.getSingleComputedStepValue());
+  Value *firstComparedValue = startValue;
+  auto comparedValue = this->attribution.getIntermediateValueUsedInCompare();
+  if (comparedValue != this->IV.getLoopEntryPHI()){
+    if (!isa<BinaryOperator>(comparedValue)){
+      return nullptr;
+    }
+    firstComparedValue = builder.CreateAdd(startValue, stepValue);
+  }
+
+  /*
+   * Compute the distance between the first compared value and the first value that exits the loop.
+   *
+   * The loop exits when "IV nonStrictPredicate exitValue" holds.
+   * An IV that moves away from its exit value makes the loop iterate at most once, so we give up on it.
+   */
+  auto isStepValuePositive = stepValue->getValue().isStrictlyPositive();
+  auto one = ConstantInt::get(ivType, 1);
+  Value *distance = nullptr;
+  switch (this->nonStrictPredicate) {
+    case CmpInst::Predicate::ICMP_UGE:
+    case CmpInst::Predicate::ICMP_SGE:
+      if (!isStepValuePositive){
+        return nullptr;
+      }
+      distance = builder.CreateSub(builder.CreateSub(exitValue, firstComparedValue), one);
+      break ;
+    case CmpInst::Predicate::ICMP_UGT:
+    case CmpInst::Predicate::ICMP_SGT:
+      if (!isStepValuePositive){
+        return nullptr;
+      }
+      distance = builder.CreateSub(exitValue, firstComparedValue);
+      break ;
+    case CmpInst::Predicate::ICMP_ULE:
+    case CmpInst::Predicate::ICMP_SLE:
+      if (isStepValuePositive){
+        return nullptr;
+      }
+      distance = builder.CreateSub(builder.CreateSub(firstComparedValue, exitValue), one);
+      break ;
+    case CmpInst::Predicate::ICMP_ULT:
+    case CmpInst::Predicate::ICMP_SLT:
+      if (isStepValuePositive){
+        return nullptr;
+      }
+      distance = builder.CreateSub(firstComparedValue, exitValue);
+      break ;
+    default:
+      return nullptr;
+  }
+
+  /*
+   * Compute the trip count.
+   * The loop does not iterate at all if the first compared value already exits it.
+   */
+  auto absoluteStepValue = ConstantInt::get(ivType, stepValue->getValue().abs());
+  auto iterations = builder.CreateAdd(builder.CreateUDiv(distance, absoluteStepValue), one);
+  auto exitsImmediately = builder.CreateICmp(this->nonStrictPredicate, firstComparedValue, exitValue);
+  auto tripCount = builder.CreateSelect(
+    exitsImmediately,
+    ConstantInt::get(tripCountType, 0),
+    builder.CreateZExtOrTrunc(iterations, tripCountType)
+  );
+
+  return tripCount;
+}
+
 std::vector<Instruction *> &LoopGoverningIVUtility::getConditionValueDerivation (void) {
   return conditionValueOrderedDerivation;
 }
\ No newline at end of file
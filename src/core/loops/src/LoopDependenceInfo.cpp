@@ -375,6 +375,60 @@ bool LoopDependenceInfo::isSCCContainedInSubloop (SCC *scc) const {
   return this->sccdagAttrs.isSCCContainedInSubloop(this->liSummary, scc);
 }
 
+SCC * LoopDependenceInfo::getSCCBlockingParallelization (
+  std::function<bool (Instruction *fromInst, Instruction *toInst, DGEdge<Value> *dependence)> canIgnoreMemoryDependence
+  ){
+
+  /*
+   * Check every SCC with loop-carried data dependences.
+   */
+  for (auto scc : this->sccdagAttrs.getSCCsWithLoopCarriedDataDependencies()){
+
+    /*
+     * Reducible and clonable SCCs do not block the parallelization of the loop.
+     */
+    auto sccInfo = this->sccdagAttrs.getSCCAttrs(scc);
+    if (  false
+          || sccInfo->canExecuteReducibly()
+          || sccInfo->canBeCloned()
+      ){
+      continue ;
+    }
+
+    /*
+     * Loop-carried data dependences between memory accesses that are disjoint across iterations do not block the parallelization of the loop either.
+     * The same holds for the memory dependences the caller can ignore.
+     */
+    auto isBlocking = false;
+    this->sccdagAttrs.iterateOverLoopCarriedDataDependences(scc, [
+      this, &isBlocking, canIgnoreMemoryDependence
+    ](DGEdge<Value> *dep) -> bool {
+      if (dep->isControlDependence()) {
+        return false;
+      }
+      auto fromInst = dyn_cast<Instruction>(dep->getOutgoingT());
+      auto toInst = dyn_cast<Instruction>(dep->getIncomingT());
+      if (  true
+            && dep->isMemoryDependence()
+            && (fromInst != nullptr)
+            && (toInst != nullptr)
+            && (false
+                || this->domainSpaceAnalysis->areInstructionsAccessingDisjointMemoryLocationsBetweenIterations(fromInst, toInst)
+                || (canIgnoreMemoryDependence && canIgnoreMemoryDependence(fromInst, toInst, dep)))
+        ){
+        return false;
+      }
+      isBlocking = true;
+      return true;
+    });
+    if (isBlocking){
+      return scc;
+    }
+  }
+
+  return nullptr;
+}
+
 InductionVariableManager * LoopDependenceInfo::getInductionVariableManager (void) const {
   return inductionVariables;
 }
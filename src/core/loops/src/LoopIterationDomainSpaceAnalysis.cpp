@@ -18,6 +18,11 @@ LoopIterationDomainSpaceAnalysis::LoopIterationDomainSpaceAnalysis (
   ScalarEvolution &SE
 ) : loops{loops}, ivManager{ivManager} {
 
+  /*
+   * Describe the bytes accessed by loads and stores at each iteration of the top loop
+   */
+  computeMemoryAccessRanges(SE);
+
   /*
    * Map IV instructions to SCEVs for quick lookup
    */
@@ -66,6 +71,74 @@ bool LoopIterationDomainSpaceAnalysis::areInstructionsAccessingDisjointMemoryLoc
   return (accessSpaceI == accessSpaceJ) || isMemoryAccessSpaceEquivalentForTopLoopIVSubscript(accessSpaceI, accessSpaceJ);
 }
 
+const LoopIterationDomainSpaceAnalysis::MemoryAccessRange * LoopIterationDomainSpaceAnalysis::getMemoryAccessRange (
+  Instruction *memoryInstruction
+) const {
+  auto rangeIt = accessRangeByInstruction.find(memoryInstruction);
+  if (rangeIt == accessRangeByInstruction.end()) {
+    return nullptr;
+  }
+
+  return &rangeIt->second;
+}
+
+void LoopIterationDomainSpaceAnalysis::computeMemoryAccessRanges (ScalarEvolution &SE) {
+  auto rootLoopStructure = loops.getLoopNestingTreeRoot();
+  auto &DL = rootLoopStructure->getHeader()->getModule()->getDataLayout();
+
+  for (auto B : rootLoopStructure->getBasicBlocks()) {
+    for (auto &I : *B) {
+      Value *pointer;
+      Type *accessedType;
+      if (auto store = dyn_cast<StoreInst>(&I)) {
+        pointer = store->getPointerOperand();
+        accessedType = store->getValueOperand()->getType();
+      } else if (auto load = dyn_cast<LoadInst>(&I)) {
+        pointer = load->getPointerOperand();
+        accessedType = load->getType();
+      } else continue;
+      if (!SE.isSCEVable(pointer->getType())) continue;
+
+      /*
+       * The base of the access must be computed before the loop starts
+       */
+      auto pointerSCEV = SE.getSCEV(pointer);
+      auto basePointer = dyn_cast<SCEVUnknown>(SE.getPointerBase(pointerSCEV));
+      if (!basePointer) continue;
+      auto base = basePointer->getValue();
+      if (auto baseInst = dyn_cast<Instruction>(base)) {
+        if (rootLoopStructure->isIncluded(baseInst)) continue;
+      }
+
+      /*
+       * The distance from the base must be either a constant or an affine function of the top loop iteration with a constant step
+       */
+      MemoryAccessRange range;
+      range.base = base;
+      range.accessSize = DL.getTypeStoreSize(accessedType);
+      auto accessFunction = SE.getMinusSCEV(pointerSCEV, basePointer);
+      if (auto constantAccess = dyn_cast<SCEVConstant>(accessFunction)) {
+        range.offset = constantAccess->getAPInt().getSExtValue();
+        range.step = 0;
+
+      } else if (auto addRecAccess = dyn_cast<SCEVAddRecExpr>(accessFunction)) {
+        if (!addRecAccess->isAffine()) continue;
+        if (addRecAccess->getLoop()->getHeader() != rootLoopStructure->getHeader()) continue;
+        auto start = dyn_cast<SCEVConstant>(addRecAccess->getStart());
+        auto step = dyn_cast<SCEVConstant>(addRecAccess->getStepRecurrence(SE));
+        if (!start || !step) continue;
+        range.offset = start->getAPInt().getSExtValue();
+        range.step = step->getAPInt().getSExtValue();
+
+      } else continue;
+
+      accessRangeByInstruction.insert(std::make_pair(&I, range));
+    }
+  }
+
+  return;
+}
+
 bool LoopIterationDomainSpaceAnalysis::isMemoryAccessSpaceEquivalentForTopLoopIVSubscript (
   MemoryAccessSpace *space1,
   MemoryAccessSpace *space2
@@ -175,8 +175,9 @@ namespace llvm::noelle {
         BasicBlock *startOfParLoopInOriginalFunc,
         BasicBlock *endOfParLoopInOriginalFunc,
         Value *envArray,
-        Value *envIndexForExitVariable,
-        std::vector<BasicBlock *> &loopExitBlocks
+        Value *envOffsetForExitVariable,
+        std::vector<BasicBlock *> &loopExitBlocks,
+        Value *conditionToRunTheParLoop = nullptr
         );
 
       ~Noelle();
@@ -98,8 +98,9 @@ void Noelle::linkTransformedLoopToOriginalFunction (
     BasicBlock *startOfParLoopInOriginalFunc,
     BasicBlock *endOfParLoopInOriginalFunc,
     Value *envArray,
-    Value *envIndexForExitVariable,
-    std::vector<BasicBlock *> &loopExitBlocks
+    Value *envOffsetForExitVariable,
+    std::vector<BasicBlock *> &loopExitBlocks,
+    Value *conditionToRunTheParLoop
     ){
 
   /*
@@ -125,6 +126,13 @@ void Noelle::linkTransformedLoopToOriginalFunction (
   IRBuilder<> loopSwitchBuilder(originalTerminator);
   auto globalLoad = loopSwitchBuilder.CreateLoad(globalBool);
   auto compareInstruction = loopSwitchBuilder.CreateICmpEQ(globalLoad, const0);
+
+  /*
+   * Check if the parallelization technique wants the current invocation to run in parallel.
+   */
+  if (conditionToRunTheParLoop != nullptr){
+    compareInstruction = loopSwitchBuilder.CreateAnd(compareInstruction, conditionToRunTheParLoop);
+  }
   loopSwitchBuilder.CreateCondBr(
       compareInstruction,
       startOfParLoopInOriginalFunc,
@@ -142,15 +150,13 @@ void Noelle::linkTransformedLoopToOriginalFunction (
   } else {
 
     /*
-     * Compute how many values can fit in a cache line.
+     * The offset of the exit variable is in 64-bit words from the beginning of the environment array.
      */
-    auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
-
     auto exitEnvPtr = endBuilder.CreateInBoundsGEP(
         envArray,
         ArrayRef<Value*>({
           cast<Value>(ConstantInt::get(int64, 0)),
-          endBuilder.CreateMul(envIndexForExitVariable, ConstantInt::get(int64, valuesInCacheLine))
+          envOffsetForExitVariable
           })
         );
     auto exitEnvCast = endBuilder.CreateIntCast(endBuilder.CreateLoad(exitEnvPtr), int32, /*isSigned=*/false);
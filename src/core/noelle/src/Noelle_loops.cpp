@@ -869,6 +869,15 @@ LoopDependenceInfo * Noelle::getLoopDependenceInfoForLoop (
 }
 
 bool Noelle::isLoopHot (LoopStructure *loopStructure, double minimumHotness) {
+
+  /*
+   * Prefer the cycles measured by the loop profiler (see noelle-prof-loops) for the loops it measured.
+   */
+  if (profiles->hasCycles(loopStructure)) {
+    auto hotness = profiles->getDynamicTotalCycleCoverage(loopStructure);
+    return hotness >= minimumHotness;
+  }
+
   if (!profiles->isAvailable()) {
     return true;
   }
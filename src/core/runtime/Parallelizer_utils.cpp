@@ -3,6 +3,9 @@
 #include <atomic>
 #include <cstdint>
 #include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#include <unistd.h>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -19,11 +22,37 @@
 #include <queue>
 #include <utility>
 #include <iostream>
+#include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <cmath>
+#include <string>
+#include <sstream>
 
 using namespace MARC;
 
 #define CACHE_LINE_SIZE 64
 
+/*
+ * The parallelizer inlines the primitives that tasks execute at every iteration (e.g., queues, synchronization) into the tasks.
+ * Their slow paths (e.g., telemetry) stay out of line to keep the tasks small.
+ */
+#ifdef __clang__
+#define NOELLE_INLINE __attribute__((always_inline))
+#else
+#define NOELLE_INLINE
+#endif
+#define NOELLE_NOINLINE __attribute__((noinline))
+
+/*
+ * Period (in nanoseconds) to re-check the number of usable cores when the user did not set it.
+ */
+#define NOELLE_CORES_RECHECK_PERIOD 1000000000ULL
+
 #ifdef DSWP_STATS
 static int64_t numberOfPushes8 = 0;
 static int64_t numberOfPushes16 = 0;
@@ -31,7 +60,2401 @@ static int64_t numberOfPushes32 = 0;
 static int64_t numberOfPushes64 = 0;
 #endif
 
-static ThreadPool pool{true, std::thread::hardware_concurrency()};
+/*
+ * Read the first line of a file.
+ * Return false if the file cannot be read.
+ */
+static bool NOELLE_readFirstLine (const std::string &fileName, std::string &line){
+  auto file = fopen(fileName.c_str(), "r");
+  if (file == nullptr){
+    return false;
+  }
+  char buffer[256];
+  auto hasLine = (fgets(buffer, sizeof(buffer), file) != nullptr);
+  fclose(file);
+  if (!hasLine){
+    return false;
+  }
+  line = buffer;
+  while (  true
+           && (!line.empty())
+           && ((line.back() == '\n') || (line.back() == ' '))
+    ){
+    line.pop_back();
+  }
+
+  return true;
+}
+
+/*
+ * Return the path of the cgroup of the current process within the cgroup hierarchy that includes the controller given as input (e.g., "cpu").
+ * The empty controller identifies the cgroup v2 unified hierarchy.
+ */
+static std::string NOELLE_getCGroupPath (const std::string &controller){
+  auto file = fopen("/proc/self/cgroup", "r");
+  if (file == nullptr){
+    return "";
+  }
+
+  /*
+   * Each line has the format "ID:controllers:path".
+   */
+  std::string path;
+  char buffer[1024];
+  while (fgets(buffer, sizeof(buffer), file) != nullptr){
+    std::string line{buffer};
+    auto firstColon = line.find(':');
+    auto secondColon = line.find(':', firstColon + 1);
+    if (  false
+          || (firstColon == std::string::npos)
+          || (secondColon == std::string::npos)
+      ){
+      continue ;
+    }
+    auto controllers = line.substr(firstColon + 1, secondColon - firstColon - 1);
+    auto isMatching = controller.empty() ? controllers.empty() : (("," + controllers + ",").find("," + controller + ",") != std::string::npos);
+    if (!isMatching){
+      continue ;
+    }
+    path = line.substr(secondColon + 1);
+    while (  true
+             && (!path.empty())
+             && (path.back() == '\n')
+      ){
+      path.pop_back();
+    }
+    break ;
+  }
+  fclose(file);
+
+  return path;
+}
+
+/*
+ * Return the number of cores granted by the CPU quota of the cgroup of the current process (0 if there is no quota).
+ */
+static uint32_t NOELLE_getNumberOfCoresOfCGroupQuota (void){
+  int64_t quota = -1;
+  int64_t period = 0;
+  std::string line;
+
+  /*
+   * cgroup v2: "cpu.max" includes "<quota> <period>", where the quota is "max" if there is none.
+   * Containers see their cgroup as the root of the hierarchy, so we check the root as well.
+   */
+  auto v2Path = NOELLE_getCGroupPath("");
+  for (auto directory : { "/sys/fs/cgroup" + v2Path, std::string("/sys/fs/cgroup") }){
+    if (!NOELLE_readFirstLine(directory + "/cpu.max", line)){
+      continue ;
+    }
+    if (line.compare(0, 3, "max") != 0){
+      sscanf(line.c_str(), "%lld %lld", (long long *)&quota, (long long *)&period);
+    }
+    break ;
+  }
+
+  /*
+   * cgroup v1: "cpu.cfs_quota_us" is -1 if there is no quota.
+   */
+  if (quota < 0){
+    auto v1Path = NOELLE_getCGroupPath("cpu");
+    for (auto root : { std::string("/sys/fs/cgroup/cpu"), std::string("/sys/fs/cgroup/cpu,cpuacct") }){
+      auto isFound = false;
+      for (auto directory : { root + v1Path, root }){
+        std::string periodLine;
+        if (  false
+              || (!NOELLE_readFirstLine(directory + "/cpu.cfs_quota_us", line))
+              || (!NOELLE_readFirstLine(directory + "/cpu.cfs_period_us", periodLine))
+          ){
+          continue ;
+        }
+        quota = atoll(line.c_str());
+        period = atoll(periodLine.c_str());
+        isFound = true;
+        break ;
+      }
+      if (isFound){
+        break ;
+      }
+    }
+  }
+
+  /*
+   * Round the quota up to whole cores.
+   */
+  if (  false
+        || (quota <= 0)
+        || (period <= 0)
+    ){
+    return 0;
+  }
+
+  return (uint32_t)((quota + period - 1) / period);
+}
+
+/*
+ * Return the number of cores the current process can use.
+ * This is the number of CPUs of its affinity mask, capped by the CPU quota of its cgroup.
+ */
+static uint32_t NOELLE_getNumberOfUsableCores (void){
+
+  /*
+   * Fetch the CPUs the process can run on.
+   */
+  uint32_t cores = std::thread::hardware_concurrency();
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  if (sched_getaffinity(0, sizeof(affinity), &affinity) == 0){
+    cores = CPU_COUNT(&affinity);
+  }
+
+  /*
+   * Cap it by the CPU quota.
+   */
+  auto quotaCores = NOELLE_getNumberOfCoresOfCGroupQuota();
+  if (  true
+        && (quotaCores > 0)
+        && (quotaCores < cores)
+    ){
+    cores = quotaCores;
+  }
+  if (cores == 0){
+    cores = 1;
+  }
+
+  return cores;
+}
+
+/*
+ * Topology of the CPUs the process can run on, discovered from sysfs (and from the C library, which relies on cpuid on x86).
+ * Physical cores are numbered densely in the order of their first CPU, and each physical core lists its SMT siblings.
+ */
+class NOELLE_Topology {
+  public:
+    NOELLE_Topology (){
+
+      /*
+       * Fetch the CPUs the process can run on.
+       */
+      cpu_set_t affinity;
+      CPU_ZERO(&affinity);
+      if (sched_getaffinity(0, sizeof(affinity), &affinity) != 0){
+        for (auto cpu = 0u; cpu < std::thread::hardware_concurrency(); cpu++){
+          CPU_SET(cpu, &affinity);
+        }
+      }
+
+      /*
+       * Group the CPUs by physical core and by NUMA node.
+       */
+      std::map<std::pair<int64_t, int64_t>, uint32_t> physicalCoreIDs;
+      std::map<int64_t, uint32_t> nodeIDs;
+      for (auto cpu = 0; cpu < CPU_SETSIZE; cpu++){
+        if (!CPU_ISSET(cpu, &affinity)){
+          continue ;
+        }
+        auto cpuDir = std::string("/sys/devices/system/cpu/cpu") + std::to_string(cpu);
+
+        /*
+         * Fetch the physical core.
+         * If the topology is not available, every CPU is its own physical core.
+         */
+        std::string coreID, packageID;
+        auto key = std::make_pair((int64_t)-1, (int64_t)cpu);
+        if (  true
+              && NOELLE_readFirstLine(cpuDir + "/topology/core_id", coreID)
+              && NOELLE_readFirstLine(cpuDir + "/topology/physical_package_id", packageID)
+          ){
+          key = std::make_pair(atoll(packageID.c_str()), atoll(coreID.c_str()));
+        }
+
+        /*
+         * Fetch the NUMA node.
+         */
+        int64_t node = 0;
+        auto dir = opendir(cpuDir.c_str());
+        if (dir != nullptr){
+          while (auto entry = readdir(dir)){
+            if (  true
+                  && (strncmp(entry->d_name, "node", 4) == 0)
+                  && (isdigit(entry->d_name[4]))
+              ){
+              node = atoll(entry->d_name + 4);
+              break ;
+            }
+          }
+          closedir(dir);
+        }
+        if (nodeIDs.find(node) == nodeIDs.end()){
+          auto newID = nodeIDs.size();
+          nodeIDs[node] = newID;
+        }
+
+        /*
+         * Add the CPU to its physical core.
+         */
+        if (physicalCoreIDs.find(key) == physicalCoreIDs.end()){
+          auto newID = physicalCoreIDs.size();
+          physicalCoreIDs[key] = newID;
+          this->logicalCores.push_back({});
+          this->nodeOfPhysicalCore.push_back(nodeIDs[node]);
+        }
+        this->logicalCores[physicalCoreIDs[key]].push_back(cpu);
+      }
+      if (this->logicalCores.empty()){
+        this->logicalCores.push_back({0});
+        this->nodeOfPhysicalCore.push_back(0);
+        nodeIDs[0] = 0;
+      }
+      this->numberOfNUMANodes = nodeIDs.size();
+
+      /*
+       * Discover the caches.
+       */
+      this->cacheLineBytes = CACHE_LINE_SIZE;
+      this->l1DataCacheBytes = 0;
+      this->l2CacheBytes = 0;
+      this->lastLevelCacheBytes = 0;
+      uint32_t lastLevel = 0;
+      for (auto index = 0; ; index++){
+        auto cacheDir = std::string("/sys/devices/system/cpu/cpu") + std::to_string(this->logicalCores[0][0]) + "/cache/index" + std::to_string(index);
+        std::string level, type, size, lineSize;
+        if (  false
+              || (!NOELLE_readFirstLine(cacheDir + "/level", level))
+              || (!NOELLE_readFirstLine(cacheDir + "/type", type))
+              || (!NOELLE_readFirstLine(cacheDir + "/size", size))
+          ){
+          break ;
+        }
+        if (type == "Instruction"){
+          continue ;
+        }
+        auto levelID = (uint32_t)atoi(level.c_str());
+        uint64_t bytes = strtoull(size.c_str(), nullptr, 10);
+        if (size.find('K') != std::string::npos){
+          bytes *= 1024;
+        } else if (size.find('M') != std::string::npos){
+          bytes *= 1024 * 1024;
+        }
+        if (levelID == 1){
+          this->l1DataCacheBytes = bytes;
+          if (  true
+                && NOELLE_readFirstLine(cacheDir + "/coherency_line_size", lineSize)
+                && (atoi(lineSize.c_str()) > 0)
+            ){
+            this->cacheLineBytes = atoi(lineSize.c_str());
+          }
+        } else if (levelID == 2){
+          this->l2CacheBytes = bytes;
+        }
+        if (levelID >= lastLevel){
+          lastLevel = levelID;
+          this->lastLevelCacheBytes = bytes;
+        }
+      }
+      #if defined(_SC_LEVEL1_DCACHE_LINESIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+      if (lastLevel == 0){
+        if (sysconf(_SC_LEVEL1_DCACHE_LINESIZE) > 0){
+          this->cacheLineBytes = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+        }
+        this->l1DataCacheBytes = std::max<long>(sysconf(_SC_LEVEL1_DCACHE_SIZE), 0);
+        this->l2CacheBytes = std::max<long>(sysconf(_SC_LEVEL2_CACHE_SIZE), 0);
+        this->lastLevelCacheBytes = std::max<long>(sysconf(_SC_LEVEL3_CACHE_SIZE), 0);
+        if (this->lastLevelCacheBytes == 0){
+          this->lastLevelCacheBytes = this->l2CacheBytes;
+        }
+      }
+      #endif
+
+      return ;
+    }
+
+    uint32_t getNumberOfPhysicalCores (void) const {
+      return this->logicalCores.size();
+    }
+
+    uint32_t getNumberOfNUMANodes (void) const {
+      return this->numberOfNUMANodes;
+    }
+
+    /*
+     * Return the CPUs (SMT siblings) of a physical core.
+     */
+    const std::vector<uint32_t> & getLogicalCores (uint32_t physicalCore) const {
+      return this->logicalCores[physicalCore % this->logicalCores.size()];
+    }
+
+    uint32_t getNUMANode (uint32_t physicalCore) const {
+      return this->nodeOfPhysicalCore[physicalCore % this->logicalCores.size()];
+    }
+
+    uint32_t getCacheLineBytes (void) const {
+      return this->cacheLineBytes;
+    }
+
+    uint64_t getL1DataCacheBytes (void) const {
+      return this->l1DataCacheBytes;
+    }
+
+    uint64_t getL2CacheBytes (void) const {
+      return this->l2CacheBytes;
+    }
+
+    uint64_t getLastLevelCacheBytes (void) const {
+      return this->lastLevelCacheBytes;
+    }
+
+  private:
+    std::vector<std::vector<uint32_t>> logicalCores;
+    std::vector<uint32_t> nodeOfPhysicalCore;
+    uint32_t numberOfNUMANodes;
+    uint32_t cacheLineBytes;
+    uint64_t l1DataCacheBytes;
+    uint64_t l2CacheBytes;
+    uint64_t lastLevelCacheBytes;
+};
+
+static NOELLE_Topology NOELLE_topology;
+
+/*
+ * Placement of the threads of parallelized loops on the CPUs.
+ * The environment variable NOELLE_PLACEMENT selects the policy:
+ * - "compact": thread i runs on the SMT siblings of the i-th physical core, and a NUMA node is filled before the next one is used.
+ * - "scatter": consecutive threads run on physical cores of different NUMA nodes (round-robin across nodes).
+ * - a list of CPUs (e.g., "0,2,8-15"): thread i runs on the (i % length)-th CPU of the list.
+ * Without it, DOALL and DSWP threads are not pinned, and HELIX threads use the compact policy.
+ *
+ * Setting NOELLE_DOALL_STABLE_MAPPING to 1 pins DOALL threads (compact by default) and makes every invocation of a DOALL loop use the same number of cores.
+ * Since chunks are assigned to threads round-robin, an iteration then always runs on the same CPU, so data first-touched by a core stays in its NUMA node.
+ */
+class NOELLE_Placement {
+  public:
+    NOELLE_Placement (const NOELLE_Topology &topology)
+      : policy{NONE}, isDOALLStable{false}
+      {
+
+      /*
+       * Compute the order of the physical cores for the compact and scatter policies.
+       */
+      std::map<uint32_t, std::vector<uint32_t>> coresOfNodes;
+      for (auto core = 0u; core < topology.getNumberOfPhysicalCores(); core++){
+        coresOfNodes[topology.getNUMANode(core)].push_back(core);
+      }
+      for (auto &node : coresOfNodes){
+        for (auto core : node.second){
+          this->compactSlots.push_back(topology.getLogicalCores(core));
+        }
+      }
+      for (auto index = 0u; this->scatterSlots.size() < this->compactSlots.size(); index++){
+        for (auto &node : coresOfNodes){
+          if (index < node.second.size()){
+            this->scatterSlots.push_back(topology.getLogicalCores(node.second[index]));
+          }
+        }
+      }
+
+      /*
+       * Fetch the policy.
+       */
+      auto envVar = getenv("NOELLE_PLACEMENT");
+      if (envVar != nullptr){
+        std::string policyName(envVar);
+        if (policyName == "compact"){
+          this->policy = COMPACT;
+        } else if (policyName == "scatter"){
+          this->policy = SCATTER;
+        } else if (this->parseCPUList(policyName)){
+          this->policy = LIST;
+        } else {
+          fprintf(stderr, "NOELLE: Placement: WARNING = the placement \"%s\" is not valid. Threads will not be pinned\n", envVar);
+        }
+      }
+      envVar = getenv("NOELLE_DOALL_STABLE_MAPPING");
+      if (  true
+            && (envVar != nullptr)
+            && (atoi(envVar) != 0)
+        ){
+        this->isDOALLStable = true;
+      }
+
+      return ;
+    }
+
+    inline bool isDOALLMappingStable (void) const {
+      return this->isDOALLStable;
+    }
+
+    /*
+     * Compute the CPUs a thread of a parallelized loop should run on.
+     * Return false if the thread should not be pinned.
+     */
+    bool getCores (uint32_t thread, cpu_set_t &cores, bool pinByDefault) const {
+      auto slots = &this->compactSlots;
+      switch (this->policy){
+        case NONE:
+          if (!pinByDefault){
+            return false;
+          }
+          break ;
+        case SCATTER:
+          slots = &this->scatterSlots;
+          break ;
+        case LIST:
+          slots = &this->listSlots;
+          break ;
+        default:
+          break ;
+      }
+
+      CPU_ZERO(&cores);
+      for (auto cpu : (*slots)[thread % slots->size()]){
+        CPU_SET(cpu, &cores);
+      }
+
+      return true;
+    }
+
+  private:
+    enum Policy { NONE, COMPACT, SCATTER, LIST };
+    Policy policy;
+    bool isDOALLStable;
+    std::vector<std::vector<uint32_t>> compactSlots;
+    std::vector<std::vector<uint32_t>> scatterSlots;
+    std::vector<std::vector<uint32_t>> listSlots;
+
+    bool parseCPUList (const std::string &list){
+      std::stringstream stream(list);
+      std::string range;
+      while (std::getline(stream, range, ',')){
+        char *end;
+        auto first = strtol(range.c_str(), &end, 10);
+        auto last = first;
+        if (*end == '-'){
+          last = strtol(end + 1, &end, 10);
+        }
+        if (  false
+              || (end == range.c_str())
+              || (*end != '\0')
+              || (first < 0)
+              || (last < first)
+              || (last >= CPU_SETSIZE)
+          ){
+          this->listSlots.clear();
+          return false;
+        }
+        for (auto cpu = first; cpu <= last; cpu++){
+          this->listSlots.push_back({ (uint32_t)cpu });
+        }
+      }
+
+      return !this->listSlots.empty();
+    }
+};
+
+static NOELLE_Placement NOELLE_placement{NOELLE_topology};
+
+static ThreadPool pool{true, NOELLE_getNumberOfUsableCores()};
+
+/*
+ * Threads of the pool that run the tasks of the loops currently dispatched.
+ *
+ * Tasks that wait for each other (e.g., DOALL tasks that combine their reductions in a tree) must all run at the same time.
+ * This is guaranteed only if each of them gets a thread of the pool that is not running other tasks.
+ */
+class NOELLE_PoolThreads {
+  public:
+    NOELLE_PoolThreads (int64_t threads)
+      : threads{threads}
+      , busyThreads{0}
+      {
+      return ;
+    }
+
+    /*
+     * Mark as busy the threads that will run the given number of tasks.
+     */
+    void occupy (int64_t tasks){
+      this->busyThreads.fetch_add(tasks);
+
+      return ;
+    }
+
+    /*
+     * Mark as busy up to the given number of threads among the ones that are not running tasks, and return how many have been marked.
+     * At least one thread is always marked because a single task does not wait for others.
+     */
+    int64_t occupyFree (int64_t tasks){
+      auto busy = this->busyThreads.load();
+      while (true){
+        auto freeThreads = this->threads - busy;
+        auto occupied = (tasks < freeThreads) ? tasks : freeThreads;
+        if (occupied < 1){
+          occupied = 1;
+        }
+        if (this->busyThreads.compare_exchange_weak(busy, busy + occupied)){
+          return occupied;
+        }
+      }
+    }
+
+    void release (int64_t tasks){
+      this->busyThreads.fetch_sub(tasks);
+
+      return ;
+    }
+
+  private:
+    int64_t threads;
+    std::atomic<int64_t> busyThreads;
+};
+
+static NOELLE_PoolThreads NOELLE_poolThreads{NOELLE_getNumberOfUsableCores()};
+
+/*
+ * Return the current time in nanoseconds.
+ */
+static inline uint64_t NOELLE_now (void){
+  auto t = std::chrono::steady_clock::now().time_since_epoch();
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+}
+
+/*
+ * Counters of a thread that runs a task of a parallelized loop.
+ */
+struct NOELLE_ThreadCounters {
+  uint64_t startTime;
+  uint64_t busyTime;
+  int64_t chunks;
+  uint64_t queueFullStalls;
+  uint64_t queueEmptyStalls;
+};
+
+/*
+ * Per-thread buffer used while a parallelized loop runs.
+ * Each thread writes only its own buffer, which lives in its own cache lines.
+ */
+struct alignas(CACHE_LINE_SIZE) NOELLE_ThreadTelemetry {
+  NOELLE_ThreadCounters counters;
+  const char *technique;
+  int64_t loopID;
+
+  /*
+   * HELIX: the sequential segment arrays the thread waits on and signals, and the time spent waiting on each of its segments.
+   */
+  uint8_t *sequentialSegments;
+  uint8_t *futureSequentialSegments;
+  int64_t sequentialSegmentBytes;
+  int64_t numberOfSequentialSegments;
+  uint64_t *waitTimes;
+
+  /*
+   * DSWP: when the current stall on a queue started.
+   */
+  uint64_t stallStartTime;
+};
+
+/*
+ * Buffer of the thread that is running a task (if telemetry or tracing is enabled).
+ */
+static thread_local NOELLE_ThreadTelemetry *NOELLE_currentThreadTelemetry = nullptr;
+
+/*
+ * Record of a completed invocation of a parallelized loop.
+ */
+struct NOELLE_InvocationRecord {
+  const char *technique;
+  int64_t loopID;
+  uint64_t invocation;
+  int64_t numberOfThreads;
+  int64_t chunkSize;
+  uint64_t dispatchLatency;
+  uint64_t totalTime;
+  int64_t numberOfSequentialSegments;
+  std::vector<NOELLE_ThreadCounters> threads;
+  std::vector<uint64_t> waitTimes;
+};
+
+/*
+ * Telemetry of the parallelized loops.
+ *
+ * It is enabled by setting the environment variable NOELLE_TELEMETRY to the name of the file to generate at exit.
+ * The file is in JSON if its name ends with ".json", and it is in CSV otherwise.
+ */
+class NOELLE_Telemetry {
+  public:
+    NOELLE_Telemetry (){
+      auto fileName = getenv("NOELLE_TELEMETRY");
+      if (  true
+            && (fileName != nullptr)
+            && (fileName[0] != '\0')
+        ){
+        this->fileName = fileName;
+      }
+
+      return ;
+    }
+
+    inline bool isEnabled (void) const {
+      return !this->fileName.empty();
+    }
+
+    void append (NOELLE_InvocationRecord &record){
+      std::lock_guard<std::mutex> guard(this->logLock);
+
+      /*
+       * Number the invocations of each loop.
+       */
+      record.invocation = this->invocationsPerLoop[std::make_pair(std::string(record.technique), record.loopID)]++;
+      this->log.push_back(std::move(record));
+
+      return ;
+    }
+
+    ~NOELLE_Telemetry (){
+      if (!this->isEnabled()){
+        return ;
+      }
+
+      /*
+       * Dump the log.
+       */
+      auto file = fopen(this->fileName.c_str(), "w");
+      if (file == nullptr){
+        fprintf(stderr, "NOELLE: Telemetry: ERROR = cannot open %s\n", this->fileName.c_str());
+        return ;
+      }
+      auto isJSON = (this->fileName.size() >= 5) && (this->fileName.compare(this->fileName.size() - 5, 5, ".json") == 0);
+      if (isJSON){
+        this->dumpJSON(file);
+      } else {
+        this->dumpCSV(file);
+      }
+      fclose(file);
+
+      return ;
+    }
+
+  private:
+    std::string fileName;
+    std::mutex logLock;
+    std::vector<NOELLE_InvocationRecord> log;
+    std::map<std::pair<std::string, int64_t>, uint64_t> invocationsPerLoop;
+
+    void dumpCSV (FILE *file) const {
+
+      /*
+       * One row per thread of each invocation.
+       * The HELIX wait times of the sequential segments are separated by ';'.
+       */
+      fprintf(file, "technique,loop_id,invocation,threads,chunk_size,dispatch_latency_ns,total_ns,thread,busy_ns,chunks,queue_full_stalls,queue_empty_stalls,helix_wait_ns\n");
+      for (auto &record : this->log){
+        for (auto i = 0; i < record.numberOfThreads; i++){
+          auto &thread = record.threads[i];
+          fprintf(file, "%s,%lld,%llu,%lld,%lld,%llu,%llu,%d,%llu,", 
+            record.technique, (long long)record.loopID, (unsigned long long)record.invocation,
+            (long long)record.numberOfThreads, (long long)record.chunkSize,
+            (unsigned long long)record.dispatchLatency, (unsigned long long)record.totalTime,
+            i, (unsigned long long)thread.busyTime);
+          if (thread.chunks >= 0){
+            fprintf(file, "%lld", (long long)thread.chunks);
+          }
+          fprintf(file, ",%llu,%llu,", (unsigned long long)thread.queueFullStalls, (unsigned long long)thread.queueEmptyStalls);
+          for (auto ss = 0; ss < record.numberOfSequentialSegments; ss++){
+            fprintf(file, "%s%llu", (ss > 0) ? ";" : "", (unsigned long long)record.waitTimes[(i * record.numberOfSequentialSegments) + ss]);
+          }
+          fprintf(file, "\n");
+        }
+      }
+
+      return ;
+    }
+
+    void dumpJSON (FILE *file) const {
+      fprintf(file, "[\n");
+      for (size_t r = 0; r < this->log.size(); r++){
+        auto &record = this->log[r];
+        fprintf(file, "  {\"technique\": \"%s\", \"loop_id\": %lld, \"invocation\": %llu, \"threads\": %lld, \"chunk_size\": %lld, \"dispatch_latency_ns\": %llu, \"total_ns\": %llu, \"per_thread\": [\n",
+          record.technique, (long long)record.loopID, (unsigned long long)record.invocation,
+          (long long)record.numberOfThreads, (long long)record.chunkSize,
+          (unsigned long long)record.dispatchLatency, (unsigned long long)record.totalTime);
+        for (auto i = 0; i < record.numberOfThreads; i++){
+          auto &thread = record.threads[i];
+          fprintf(file, "    {\"busy_ns\": %llu, ", (unsigned long long)thread.busyTime);
+          if (thread.chunks >= 0){
+            fprintf(file, "\"chunks\": %lld, ", (long long)thread.chunks);
+          }
+          fprintf(file, "\"queue_full_stalls\": %llu, \"queue_empty_stalls\": %llu, \"helix_wait_ns\": [", (unsigned long long)thread.queueFullStalls, (unsigned long long)thread.queueEmptyStalls);
+          for (auto ss = 0; ss < record.numberOfSequentialSegments; ss++){
+            fprintf(file, "%s%llu", (ss > 0) ? ", " : "", (unsigned long long)record.waitTimes[(i * record.numberOfSequentialSegments) + ss]);
+          }
+          fprintf(file, "]}%s\n", ((i + 1) < record.numberOfThreads) ? "," : "");
+        }
+        fprintf(file, "  ]}%s\n", ((r + 1) < this->log.size()) ? "," : "");
+      }
+      fprintf(file, "]\n");
+
+      return ;
+    }
+};
+
+static NOELLE_Telemetry NOELLE_telemetry;
+
+/*
+ * Number of times each run-time check that guards a parallelized loop passed and failed.
+ * A passed check does not imply that the parallelized loop ran (e.g., a single core could have been chosen for that invocation).
+ *
+ * It is enabled by setting the environment variable NOELLE_LOOP_VERSIONS to the name of the CSV file to generate at exit.
+ */
+class NOELLE_LoopVersionCounters {
+  public:
+    NOELLE_LoopVersionCounters (){
+      auto fileName = getenv("NOELLE_LOOP_VERSIONS");
+      if (  true
+            && (fileName != nullptr)
+            && (fileName[0] != '\0')
+        ){
+        this->fileName = fileName;
+      }
+
+      return ;
+    }
+
+    inline bool isEnabled (void) const {
+      return !this->fileName.empty();
+    }
+
+    void count (const char *check, int64_t loopID, bool passed){
+      std::lock_guard<std::mutex> guard(this->countersLock);
+      auto &counters = this->counters[std::make_pair(std::string(check), loopID)];
+      if (passed){
+        counters.first++;
+      } else {
+        counters.second++;
+      }
+
+      return ;
+    }
+
+    ~NOELLE_LoopVersionCounters (){
+      if (!this->isEnabled()){
+        return ;
+      }
+
+      auto file = fopen(this->fileName.c_str(), "w");
+      if (file == nullptr){
+        fprintf(stderr, "NOELLE: LoopVersions: ERROR = cannot open %s\n", this->fileName.c_str());
+        return ;
+      }
+      fprintf(file, "check,loop_id,passed,failed\n");
+      for (auto &pair : this->counters){
+        fprintf(file, "%s,%lld,%llu,%llu\n", pair.first.first.c_str(), (long long)pair.first.second, (unsigned long long)pair.second.first, (unsigned long long)pair.second.second);
+      }
+      fclose(file);
+
+      return ;
+    }
+
+  private:
+    std::string fileName;
+    std::mutex countersLock;
+    std::map<std::pair<std::string, int64_t>, std::pair<uint64_t, uint64_t>> counters;
+};
+
+static NOELLE_LoopVersionCounters NOELLE_loopVersionCounters;
+
+/*
+ * Last accesses to a byte of memory during the current invocation of a profiled loop.
+ */
+struct NOELLE_ProfiledByte {
+  int64_t writer;
+  uint64_t writeIteration;
+  std::vector<std::pair<int64_t, uint64_t>> readersSinceWrite;
+};
+
+/*
+ * State of a loop profiled by the dependence profiler.
+ * Iterations are numbered across invocations, so the ones of the current invocation are the ones after invocationStart.
+ */
+struct NOELLE_ProfiledLoop {
+  uint64_t iteration;
+  uint64_t invocationStart;
+  std::unordered_map<uintptr_t, NOELLE_ProfiledByte> bytes;
+  std::set<int64_t> executed;
+};
+
+/*
+ * Profiler of the memory dependences of loops (see noelle-prof-dependences).
+ *
+ * Loads and stores are identified by the IDs of their nodes in the embedded PDG.
+ * At exit, the profile is written to the file named by the environment variable NOELLE_DEPENDENCE_PROFILE (default.depprof if it is not set) with the lines
+ *   executed LOOP_INDEX ID            for every instruction that ran in a profiled loop
+ *   manifested FROM_ID TO_ID          for every dependence observed within an invocation of a profiled loop (either between iterations or within one)
+ */
+class NOELLE_DependenceProfiler {
+  public:
+    void startInvocation (int64_t loopIndex){
+      std::lock_guard<std::mutex> guard(this->profilerLock);
+      auto &loop = this->loops[loopIndex];
+
+      /*
+       * Accesses of earlier invocations cannot create dependences within this one.
+       */
+      loop.iteration++;
+      loop.invocationStart = loop.iteration;
+      loop.bytes.clear();
+
+      return ;
+    }
+
+    void startIteration (int64_t loopIndex){
+      std::lock_guard<std::mutex> guard(this->profilerLock);
+      this->loops[loopIndex].iteration++;
+
+      return ;
+    }
+
+    void access (int64_t loopIndex, int64_t instructionID, void *address, int64_t size, bool isWrite){
+      std::lock_guard<std::mutex> guard(this->profilerLock);
+      auto &loop = this->loops[loopIndex];
+      loop.executed.insert(instructionID);
+
+      /*
+       * Dependences within an iteration are recorded as well, as the profile decides whether a dependence exists at all.
+       */
+      auto isCurrentInvocation = [&loop](uint64_t iteration) -> bool {
+        return (iteration > loop.invocationStart) && (iteration <= loop.iteration);
+      };
+      for (auto b = 0; b < size; b++){
+        auto it = loop.bytes.find(((uintptr_t)address) + b);
+        if (it == loop.bytes.end()){
+          it = loop.bytes.insert(std::make_pair(((uintptr_t)address) + b, NOELLE_ProfiledByte{-1, 0, {}})).first;
+        }
+        auto &byte = it->second;
+
+        /*
+         * Read-after-write and write-after-write dependences.
+         */
+        if (  true
+              && (byte.writer != -1)
+              && isCurrentInvocation(byte.writeIteration)
+          ){
+          this->manifested.insert(std::make_pair(byte.writer, instructionID));
+        }
+
+        if (!isWrite){
+          auto isRecorded = false;
+          for (auto &reader : byte.readersSinceWrite){
+            if (reader.first == instructionID){
+              reader.second = loop.iteration;
+              isRecorded = true;
+              break ;
+            }
+          }
+          if (!isRecorded){
+            byte.readersSinceWrite.push_back(std::make_pair(instructionID, loop.iteration));
+          }
+          continue ;
+        }
+
+        /*
+         * Write-after-read dependences.
+         */
+        for (auto &reader : byte.readersSinceWrite){
+          if (isCurrentInvocation(reader.second)){
+            this->manifested.insert(std::make_pair(reader.first, instructionID));
+          }
+        }
+        byte.readersSinceWrite.clear();
+        byte.writer = instructionID;
+        byte.writeIteration = loop.iteration;
+      }
+
+      return ;
+    }
+
+    ~NOELLE_DependenceProfiler (){
+
+      /*
+       * Only programs instrumented by the dependence profiler generate a profile.
+       */
+      if (this->loops.empty()){
+        return ;
+      }
+
+      auto fileName = getenv("NOELLE_DEPENDENCE_PROFILE");
+      if (  false
+            || (fileName == nullptr)
+            || (fileName[0] == '\0')
+        ){
+        fileName = (char *)"default.depprof";
+      }
+      auto file = fopen(fileName, "w");
+      if (file == nullptr){
+        fprintf(stderr, "NOELLE: DependenceProfiler: ERROR = cannot open %s\n", fileName);
+        return ;
+      }
+      for (auto &pair : this->loops){
+        for (auto instructionID : pair.second.executed){
+          fprintf(file, "executed %lld %lld\n", (long long)pair.first, (long long)instructionID);
+        }
+      }
+      for (auto &dependence : this->manifested){
+        fprintf(file, "manifested %lld %lld\n", (long long)dependence.first, (long long)dependence.second);
+      }
+      fclose(file);
+
+      return ;
+    }
+
+  private:
+    std::mutex profilerLock;
+    std::map<int64_t, NOELLE_ProfiledLoop> loops;
+    std::set<std::pair<int64_t, int64_t>> manifested;
+};
+
+static NOELLE_DependenceProfiler NOELLE_dependenceProfiler;
+
+/*
+ * Return the current value of the time-stamp counter (or the time in nanoseconds where it is not available).
+ */
+static inline uint64_t NOELLE_cycles (void){
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return NOELLE_now();
+#endif
+}
+
+/*
+ * Number of buckets of the histogram of the iterations per invocation of a profiled loop.
+ * Bucket 0 counts the invocations without iterations, and bucket b > 0 the ones with [2^(b-1), 2^b) iterations.
+ */
+#define NOELLE_LOOP_PROFILE_BUCKETS 65
+
+/*
+ * Invocation of a loop that is running.
+ */
+struct NOELLE_ActiveLoopInvocation {
+  int64_t loopID;
+  uint64_t start;
+  uint64_t iterations;
+  uint64_t nestedCycles;
+};
+
+/*
+ * Profile of a loop accumulated across its invocations.
+ */
+struct NOELLE_LoopProfile {
+  uint64_t invocations;
+  uint64_t iterations;
+  uint64_t totalCycles;
+  uint64_t selfCycles;
+  uint64_t histogram[NOELLE_LOOP_PROFILE_BUCKETS];
+};
+
+/*
+ * Invocations of the profiled loops that are running in the current thread (the innermost one is the last).
+ */
+static thread_local std::vector<NOELLE_ActiveLoopInvocation> NOELLE_activeLoopInvocations;
+
+/*
+ * Profiler of the invocations, iterations, and cycles of loops (see noelle-prof-loops).
+ *
+ * Loops are identified by their embedded IDs (see noelle-meta-loop-embed).
+ * The total cycles of a loop include the ones spent in its nested loops and callees; they are not counted twice when the loop runs within itself (e.g., by recursion).
+ * The self cycles of a loop exclude the ones spent in the profiled loops nested within it, including the ones of its callees.
+ * At exit, the profile is written to the file named by the environment variable NOELLE_LOOP_PROFILE (default.loopprof if it is not set) with the lines
+ *   program CYCLES
+ *   loop ID INVOCATIONS ITERATIONS TOTAL_CYCLES SELF_CYCLES BUCKET_0 BUCKET_1 ...     (up to the last non-empty bucket of the histogram)
+ */
+class NOELLE_LoopProfiler {
+  public:
+    NOELLE_LoopProfiler ()
+      : programStart{NOELLE_cycles()}
+      {
+      return ;
+    }
+
+    void startInvocation (int64_t loopID){
+      NOELLE_activeLoopInvocations.push_back(NOELLE_ActiveLoopInvocation{loopID, NOELLE_cycles(), 0, 0});
+
+      return ;
+    }
+
+    void startIteration (int64_t loopID){
+
+      /*
+       * Invocations that are still open within the current one have been left without going through their exit edges (e.g., by longjmp).
+       */
+      auto index = this->getActiveInvocation(loopID);
+      if (index < 0){
+        return ;
+      }
+      if ((uint64_t)(index + 1) < NOELLE_activeLoopInvocations.size()){
+        auto now = NOELLE_cycles();
+        while ((uint64_t)(index + 1) < NOELLE_activeLoopInvocations.size()){
+          this->endInnermostInvocation(now);
+        }
+      }
+      NOELLE_activeLoopInvocations[index].iterations++;
+
+      return ;
+    }
+
+    void endInvocation (int64_t loopID){
+      auto now = NOELLE_cycles();
+      auto index = this->getActiveInvocation(loopID);
+      if (index < 0){
+        return ;
+      }
+      while ((uint64_t)index < NOELLE_activeLoopInvocations.size()){
+        this->endInnermostInvocation(now);
+      }
+
+      return ;
+    }
+
+    ~NOELLE_LoopProfiler (){
+
+      /*
+       * Only programs instrumented by the loop profiler generate a profile.
+       */
+      if (this->loops.empty()){
+        return ;
+      }
+      auto programCycles = NOELLE_cycles() - this->programStart;
+
+      auto fileName = getenv("NOELLE_LOOP_PROFILE");
+      if (  false
+            || (fileName == nullptr)
+            || (fileName[0] == '\0')
+        ){
+        fileName = (char *)"default.loopprof";
+      }
+      auto file = fopen(fileName, "w");
+      if (file == nullptr){
+        fprintf(stderr, "NOELLE: LoopProfiler: ERROR = cannot open %s\n", fileName);
+        return ;
+      }
+      fprintf(file, "program %llu\n", (unsigned long long)programCycles);
+      for (auto &pair : this->loops){
+        auto &loop = pair.second;
+        fprintf(file, "loop %lld %llu %llu %llu %llu", (long long)pair.first, (unsigned long long)loop.invocations, (unsigned long long)loop.iterations, (unsigned long long)loop.totalCycles, (unsigned long long)loop.selfCycles);
+        auto buckets = NOELLE_LOOP_PROFILE_BUCKETS;
+        while ((buckets > 0) && (loop.histogram[buckets - 1] == 0)){
+          buckets--;
+        }
+        for (auto b = 0; b < buckets; b++){
+          fprintf(file, " %llu", (unsigned long long)loop.histogram[b]);
+        }
+        fprintf(file, "\n");
+      }
+      fclose(file);
+
+      return ;
+    }
+
+  private:
+    uint64_t programStart;
+    std::mutex profilerLock;
+    std::map<int64_t, NOELLE_LoopProfile> loops;
+
+    int64_t getActiveInvocation (int64_t loopID) const {
+      for (int64_t i = NOELLE_activeLoopInvocations.size() - 1; i >= 0; i--){
+        if (NOELLE_activeLoopInvocations[i].loopID == loopID){
+          return i;
+        }
+      }
+
+      return -1;
+    }
+
+    void endInnermostInvocation (uint64_t now){
+      auto invocation = NOELLE_activeLoopInvocations.back();
+      NOELLE_activeLoopInvocations.pop_back();
+      auto cycles = now - invocation.start;
+
+      /*
+       * Attribute the cycles of this invocation to the invocation that includes it.
+       */
+      auto isNestedInItself = false;
+      for (auto &outer : NOELLE_activeLoopInvocations){
+        if (outer.loopID == invocation.loopID){
+          isNestedInItself = true;
+          break ;
+        }
+      }
+      if (!NOELLE_activeLoopInvocations.empty()){
+        NOELLE_activeLoopInvocations.back().nestedCycles += cycles;
+      }
+
+      /*
+       * Fetch the bucket of the histogram.
+       */
+      auto bucket = 0;
+      if (invocation.iterations > 0){
+        bucket = 64 - __builtin_clzll(invocation.iterations);
+      }
+
+      /*
+       * Update the profile of the loop.
+       */
+      std::lock_guard<std::mutex> guard(this->profilerLock);
+      auto it = this->loops.find(invocation.loopID);
+      if (it == this->loops.end()){
+        it = this->loops.insert(std::make_pair(invocation.loopID, NOELLE_LoopProfile{})).first;
+      }
+      auto &loop = it->second;
+      loop.invocations++;
+      loop.iterations += invocation.iterations;
+      if (!isNestedInItself){
+        loop.totalCycles += cycles;
+      }
+      loop.selfCycles += cycles - std::min(cycles, invocation.nestedCycles);
+      loop.histogram[bucket]++;
+
+      return ;
+    }
+};
+
+static NOELLE_LoopProfiler NOELLE_loopProfiler;
+
+/*
+ * Number of events kept by the trace buffer of each thread (a power of 2).
+ */
+#define NOELLE_TRACE_EVENTS (64 * 1024)
+
+/*
+ * Event of the timeline of the parallelized loops.
+ * Events are either complete (they have a duration) or instant.
+ */
+struct NOELLE_TraceEvent {
+  const char *name;
+  const char *category;
+  char phase;
+  uint64_t timestamp;
+  uint64_t duration;
+  const char *argName;
+  int64_t arg;
+};
+
+/*
+ * Ring buffer of the trace events of a thread.
+ * Only its thread writes to it, so no synchronization is needed; when it is full, the oldest events are overwritten.
+ */
+class NOELLE_TraceBuffer {
+  public:
+    NOELLE_TraceBuffer (uint64_t threadID)
+      : threadID{threadID}, nextEvent{0}
+      {
+      return ;
+    }
+
+    inline void record (const char *name, const char *category, char phase, uint64_t timestamp, uint64_t duration, const char *argName, int64_t arg){
+      auto &event = this->events[this->nextEvent & (NOELLE_TRACE_EVENTS - 1)];
+      event.name = name;
+      event.category = category;
+      event.phase = phase;
+      event.timestamp = timestamp;
+      event.duration = duration;
+      event.argName = argName;
+      event.arg = arg;
+      this->nextEvent++;
+
+      return ;
+    }
+
+    uint64_t threadID;
+    uint64_t nextEvent;
+    NOELLE_TraceEvent events[NOELLE_TRACE_EVENTS];
+};
+
+/*
+ * Timeline of the parallelized loops.
+ *
+ * It is enabled by setting the environment variable NOELLE_TRACE to the name of the file to generate at exit.
+ * The file uses the Chrome trace-event JSON format (e.g., it can be opened by chrome://tracing or Perfetto).
+ */
+class NOELLE_Trace {
+  public:
+    NOELLE_Trace ()
+      : enabled{false}, startTime{NOELLE_now()}
+      {
+      auto fileName = getenv("NOELLE_TRACE");
+      if (  true
+            && (fileName != nullptr)
+            && (fileName[0] != '\0')
+        ){
+        this->fileName = fileName;
+        this->enabled = true;
+      }
+
+      return ;
+    }
+
+    inline bool isEnabled (void) const {
+      return this->enabled;
+    }
+
+    /*
+     * Record a complete event of the current thread.
+     */
+    inline void complete (const char *name, const char *category, uint64_t startTime, uint64_t endTime, const char *argName, int64_t arg){
+      this->getThreadBuffer()->record(name, category, 'X', startTime, endTime - startTime, argName, arg);
+
+      return ;
+    }
+
+    /*
+     * Record an instant event of the current thread.
+     */
+    inline void instant (const char *name, const char *category, const char *argName, int64_t arg){
+      this->getThreadBuffer()->record(name, category, 'i', NOELLE_now(), 0, argName, arg);
+
+      return ;
+    }
+
+    ~NOELLE_Trace (){
+      if (!this->isEnabled()){
+        return ;
+      }
+
+      /*
+       * Dump the events.
+       */
+      auto file = fopen(this->fileName.c_str(), "w");
+      if (file == nullptr){
+        fprintf(stderr, "NOELLE: Trace: ERROR = cannot open %s\n", this->fileName.c_str());
+        return ;
+      }
+      fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+      auto isFirst = true;
+      for (auto buffer : this->buffers){
+
+        /*
+         * Name the thread.
+         */
+        fprintf(file, "%s  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %llu, \"args\": {\"name\": \"thread %llu\"}}", 
+          isFirst ? "" : ",\n", (unsigned long long)buffer->threadID, (unsigned long long)buffer->threadID);
+        isFirst = false;
+
+        /*
+         * Dump the events that have not been overwritten.
+         */
+        auto firstEvent = (buffer->nextEvent > NOELLE_TRACE_EVENTS) ? (buffer->nextEvent - NOELLE_TRACE_EVENTS) : 0;
+        for (auto e = firstEvent; e < buffer->nextEvent; e++){
+          auto &event = buffer->events[e & (NOELLE_TRACE_EVENTS - 1)];
+          auto timestamp = (event.timestamp > this->startTime) ? (event.timestamp - this->startTime) : 0;
+          fprintf(file, ",\n  {\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"%c\", \"pid\": 0, \"tid\": %llu, \"ts\": %.3f", 
+            event.name, event.category, event.phase, (unsigned long long)buffer->threadID, ((double)timestamp) / 1000);
+          if (event.phase == 'X'){
+            fprintf(file, ", \"dur\": %.3f", ((double)event.duration) / 1000);
+          } else {
+            fprintf(file, ", \"s\": \"t\"");
+          }
+          if (event.argName != nullptr){
+            fprintf(file, ", \"args\": {\"%s\": %lld}", event.argName, (long long)event.arg);
+          }
+          fprintf(file, "}");
+        }
+        delete buffer;
+      }
+      fprintf(file, "\n]}\n");
+      fclose(file);
+
+      return ;
+    }
+
+  private:
+    bool enabled;
+    uint64_t startTime;
+    std::string fileName;
+    std::mutex buffersLock;
+    std::vector<NOELLE_TraceBuffer *> buffers;
+
+    inline NOELLE_TraceBuffer * getThreadBuffer (void){
+      static thread_local NOELLE_TraceBuffer *buffer = nullptr;
+
+      /*
+       * Allocate the buffer of the current thread the first time it records an event.
+       */
+      if (buffer == nullptr){
+        std::lock_guard<std::mutex> guard(this->buffersLock);
+        buffer = new NOELLE_TraceBuffer(this->buffers.size());
+        this->buffers.push_back(buffer);
+      }
+
+      return buffer;
+    }
+};
+
+static NOELLE_Trace NOELLE_trace;
+
+/*
+ * Check if the invocations of parallelized loops need to be measured.
+ */
+static inline bool NOELLE_isInstrumented (void){
+  return NOELLE_telemetry.isEnabled() || NOELLE_trace.isEnabled();
+}
+
+/*
+ * Telemetry of a single invocation of a parallelized loop.
+ * The dispatcher creates it only if telemetry or tracing is enabled.
+ */
+class NOELLE_InvocationTelemetry {
+  public:
+    NOELLE_InvocationTelemetry (const char *technique, int64_t loopID, int64_t numberOfThreads, int64_t chunkSize, int64_t numberOfSequentialSegments)
+      : dispatchTime{NOELLE_now()}, numberOfThreads{numberOfThreads}, numberOfSequentialSegments{numberOfSequentialSegments}
+      {
+
+      /*
+       * Allocate the per-thread buffers.
+       */
+      if (posix_memalign((void **)&this->threads, CACHE_LINE_SIZE, sizeof(NOELLE_ThreadTelemetry) * numberOfThreads) != 0){
+        fprintf(stderr, "NOELLE: Telemetry: ERROR = not enough memory\n");
+        abort();
+      }
+      this->waitTimesPerThread = ((numberOfSequentialSegments * sizeof(uint64_t) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE) * (CACHE_LINE_SIZE / sizeof(uint64_t));
+      this->waitTimes = nullptr;
+      if (this->waitTimesPerThread > 0){
+        if (posix_memalign((void **)&this->waitTimes, CACHE_LINE_SIZE, sizeof(uint64_t) * this->waitTimesPerThread * numberOfThreads) != 0){
+          fprintf(stderr, "NOELLE: Telemetry: ERROR = not enough memory\n");
+          abort();
+        }
+        memset(this->waitTimes, 0, sizeof(uint64_t) * this->waitTimesPerThread * numberOfThreads);
+      }
+      for (auto i = 0; i < numberOfThreads; i++){
+        auto thread = new (&this->threads[i]) NOELLE_ThreadTelemetry();
+        thread->counters = {0, 0, -1, 0, 0};
+        thread->technique = technique;
+        thread->loopID = loopID;
+        thread->sequentialSegments = nullptr;
+        thread->futureSequentialSegments = nullptr;
+        thread->sequentialSegmentBytes = CACHE_LINE_SIZE;
+        thread->stallStartTime = 0;
+        thread->numberOfSequentialSegments = numberOfSequentialSegments;
+        thread->waitTimes = (this->waitTimes != nullptr) ? (this->waitTimes + (i * this->waitTimesPerThread)) : nullptr;
+      }
+
+      /*
+       * Prepare the record.
+       */
+      this->record.technique = technique;
+      this->record.loopID = loopID;
+      this->record.numberOfThreads = numberOfThreads;
+      this->record.chunkSize = chunkSize;
+      this->record.numberOfSequentialSegments = numberOfSequentialSegments;
+
+      return ;
+    }
+
+    inline NOELLE_ThreadTelemetry * getThread (int64_t threadID){
+      return &this->threads[threadID];
+    }
+
+    /*
+     * Append the invocation to the log and to the timeline.
+     * This must be invoked after all threads completed their task.
+     */
+    void end (void){
+      auto endTime = NOELLE_now();
+      this->totalTime = endTime - this->dispatchTime;
+
+      /*
+       * Aggregate the busy time of the threads.
+       */
+      this->busyTime = 0;
+      this->maximumBusyTime = 0;
+      for (auto i = 0; i < this->numberOfThreads; i++){
+        auto threadBusyTime = this->threads[i].counters.busyTime;
+        this->busyTime += threadBusyTime;
+        if (threadBusyTime > this->maximumBusyTime){
+          this->maximumBusyTime = threadBusyTime;
+        }
+      }
+
+      if (NOELLE_trace.isEnabled()){
+        NOELLE_trace.complete(this->record.technique, "dispatch", this->dispatchTime, endTime, "loop_id", this->record.loopID);
+      }
+      if (!NOELLE_telemetry.isEnabled()){
+        return ;
+      }
+
+      /*
+       * The dispatch latency is the time it took for the last thread to start its task.
+       */
+      uint64_t lastStartTime = this->dispatchTime;
+      for (auto i = 0; i < this->numberOfThreads; i++){
+        auto &counters = this->threads[i].counters;
+        if (counters.startTime > lastStartTime){
+          lastStartTime = counters.startTime;
+        }
+        this->record.threads.push_back(counters);
+        for (auto ss = 0; ss < this->numberOfSequentialSegments; ss++){
+          this->record.waitTimes.push_back(this->threads[i].waitTimes[ss]);
+        }
+      }
+      this->record.dispatchLatency = lastStartTime - this->dispatchTime;
+      this->record.totalTime = this->totalTime;
+      NOELLE_telemetry.append(this->record);
+
+      return ;
+    }
+
+    /*
+     * Times of the invocation, which are available after "end" is invoked.
+     */
+    inline uint64_t getTotalTime (void) const {
+      return this->totalTime;
+    }
+
+    inline uint64_t getBusyTime (void) const {
+      return this->busyTime;
+    }
+
+    inline uint64_t getMaximumBusyTime (void) const {
+      return this->maximumBusyTime;
+    }
+
+    ~NOELLE_InvocationTelemetry (){
+      free(this->threads);
+      free(this->waitTimes);
+
+      return ;
+    }
+
+  private:
+    uint64_t dispatchTime;
+    uint64_t totalTime;
+    uint64_t busyTime;
+    uint64_t maximumBusyTime;
+    int64_t numberOfThreads;
+    int64_t numberOfSequentialSegments;
+    int64_t waitTimesPerThread;
+    NOELLE_ThreadTelemetry *threads;
+    uint64_t *waitTimes;
+    NOELLE_InvocationRecord record;
+};
+
+/*
+ * Initial estimate of the time (in nanoseconds) it takes to dispatch a task to a core and to join it.
+ */
+#define NOELLE_DEFAULT_CORE_OVERHEAD 5000.0
+
+/*
+ * Cost model of the invocations of DOALL loops, which is used to choose how many cores each invocation uses.
+ *
+ * An invocation of N iterations that runs on C cores is modeled to take (N * iterationTime / C) + (C * coreOverhead).
+ * The iteration time is learned for each loop from the busy time of its threads.
+ * The core overhead is learned across all loops from the time of the invocations that is not spent running tasks.
+ * Setting the environment variable NOELLE_ADAPTIVE_CORES to 0 disables the model: all invocations use all cores available.
+ */
+class NOELLE_DOALLCostModel {
+  public:
+    NOELLE_DOALLCostModel ()
+      : enabled{true}, coreOverhead{NOELLE_DEFAULT_CORE_OVERHEAD}
+      {
+      auto envVar = getenv("NOELLE_ADAPTIVE_CORES");
+      if (  true
+            && (envVar != nullptr)
+            && (atoi(envVar) == 0)
+        ){
+        this->enabled = false;
+      }
+
+      return ;
+    }
+
+    inline bool isEnabled (void) const {
+      return this->enabled;
+    }
+
+    /*
+     * Choose how many cores (up to maxNumberOfCores) the current invocation of a loop should use.
+     * One core means that the invocation should run sequentially.
+     */
+    int64_t chooseNumberOfCores (int64_t loopID, int64_t numberOfIterations, int64_t maxNumberOfCores){
+
+      /*
+       * Check if we can model the invocation.
+       */
+      if (  false
+            || (!this->enabled)
+            || (numberOfIterations < 0)
+            || (maxNumberOfCores <= 1)
+        ){
+        return maxNumberOfCores;
+      }
+      if (numberOfIterations <= 1){
+        return 1;
+      }
+      if (numberOfIterations < maxNumberOfCores){
+        maxNumberOfCores = numberOfIterations;
+      }
+
+      /*
+       * Fetch the model of the loop.
+       * The first invocation of a loop uses all cores to learn its iteration time.
+       */
+      double iterationTime;
+      double coreOverhead;
+      {
+        std::lock_guard<std::mutex> guard(this->modelLock);
+        auto loopModel = this->iterationTimes.find(loopID);
+        if (loopModel == this->iterationTimes.end()){
+          return maxNumberOfCores;
+        }
+        iterationTime = loopModel->second;
+        coreOverhead = this->coreOverhead;
+      }
+
+      /*
+       * The number of cores that minimizes the modeled time is sqrt(work / coreOverhead).
+       * We pick the best integer around it, and we run sequentially if that does not beat the sequential time.
+       */
+      auto work = ((double)numberOfIterations) * iterationTime;
+      auto idealNumberOfCores = std::sqrt(work / coreOverhead);
+      int64_t bestNumberOfCores = 1;
+      auto bestTime = work;
+      for (auto cores : { (int64_t)std::floor(idealNumberOfCores), (int64_t)std::ceil(idealNumberOfCores) }){
+        if (cores > maxNumberOfCores){
+          cores = maxNumberOfCores;
+        }
+        if (cores < 2){
+          continue ;
+        }
+        auto time = (work / cores) + (cores * coreOverhead);
+        if (time < bestTime){
+          bestTime = time;
+          bestNumberOfCores = cores;
+        }
+      }
+
+      return bestNumberOfCores;
+    }
+
+    /*
+     * Learn from an invocation of a loop.
+     */
+    void update (int64_t loopID, int64_t numberOfIterations, int64_t numberOfCores, NOELLE_InvocationTelemetry *invocation){
+      if (numberOfIterations <= 0){
+        return ;
+      }
+      auto iterationTime = ((double)invocation->getBusyTime()) / numberOfIterations;
+      auto overheadTime = (invocation->getTotalTime() > invocation->getMaximumBusyTime()) ? (invocation->getTotalTime() - invocation->getMaximumBusyTime()) : 0;
+      auto coreOverhead = ((double)overheadTime) / numberOfCores;
+
+      /*
+       * Update the estimates with exponential moving averages.
+       */
+      std::lock_guard<std::mutex> guard(this->modelLock);
+      auto loopModel = this->iterationTimes.find(loopID);
+      if (loopModel == this->iterationTimes.end()){
+        this->iterationTimes[loopID] = iterationTime;
+      } else {
+        loopModel->second += (iterationTime - loopModel->second) / 4;
+      }
+      this->coreOverhead += (coreOverhead - this->coreOverhead) / 4;
+
+      return ;
+    }
+
+  private:
+    bool enabled;
+    std::mutex modelLock;
+    std::unordered_map<int64_t, double> iterationTimes;
+    double coreOverhead;
+};
+
+static NOELLE_DOALLCostModel NOELLE_DOALLModel;
+
+/*
+ * Run a task of a parallelized loop while measuring it.
+ */
+template <typename... Args>
+static void NOELLE_runTaskWithTelemetry (NOELLE_ThreadTelemetry *thread, void (*task)(Args...), Args... args){
+  thread->counters.startTime = NOELLE_now();
+  NOELLE_currentThreadTelemetry = thread;
+
+  task(args...);
+
+  NOELLE_currentThreadTelemetry = nullptr;
+  auto endTime = NOELLE_now();
+  thread->counters.busyTime = endTime - thread->counters.startTime;
+  if (NOELLE_trace.isEnabled()){
+    NOELLE_trace.complete(thread->technique, "task", thread->counters.startTime, endTime, "loop_id", thread->loopID);
+  }
+
+  return ;
+}
+
+/*
+ * Bytes of an aligned 8-byte granule of memory accessed by a speculative DOALL task.
+ * For each byte, we keep the first and the last iteration that wrote it (or the last one that read it before writing it) and the last value written.
+ */
+struct NOELLE_SpeculativeGranule {
+  uint8_t data[8];
+  uint8_t mask;
+  int64_t firstKeys[8];
+  int64_t lastKeys[8];
+};
+
+/*
+ * Shadow memory of a thread that runs a speculative DOALL task.
+ *
+ * Stores are buffered rather than written to memory, so the task can be discarded.
+ * Loads read the memory unless the same iteration already wrote the bytes they access; such reads are recorded as exposed.
+ * Iterations are identified by keys that increase with the iterations of the loop.
+ */
+class NOELLE_SpeculationBuffer {
+  public:
+    NOELLE_SpeculationBuffer ()
+      : hasFailed{false}
+      {
+      return ;
+    }
+
+    NOELLE_NOINLINE uint64_t load (void *address, int64_t size, int64_t key){
+      uint64_t value = 0;
+      memcpy(&value, address, size);
+
+      /*
+       * Accesses that span two granules are not tracked.
+       */
+      auto offset = ((uintptr_t)address) & 7;
+      if ((offset + size) > 8){
+        this->hasFailed = true;
+        return value;
+      }
+      auto granuleAddress = ((uintptr_t)address) - offset;
+
+      /*
+       * Forward the bytes written by the current iteration.
+       */
+      auto writeIt = this->writes.find(granuleAddress);
+      auto readMask = (uint8_t)0;
+      for (auto b = 0; b < size; b++){
+        auto byte = offset + b;
+        if (  true
+              && (writeIt != this->writes.end())
+              && (writeIt->second.mask & (1 << byte))
+          ){
+          if (writeIt->second.lastKeys[byte] == key){
+            ((uint8_t *)&value)[b] = writeIt->second.data[byte];
+            continue ;
+          }
+
+          /*
+           * An earlier iteration run by this thread wrote the byte, so the loop has a loop-carried data dependence.
+           */
+          this->hasFailed = true;
+        }
+        readMask |= (1 << byte);
+      }
+
+      /*
+       * Record the exposed reads.
+       */
+      if (readMask != 0){
+        auto &granule = this->reads[granuleAddress];
+        for (auto byte = 0; byte < 8; byte++){
+          if (  true
+                && (readMask & (1 << byte))
+                && (  false
+                      || !(granule.mask & (1 << byte))
+                      || (granule.lastKeys[byte] < key)
+                   )
+            ){
+            granule.lastKeys[byte] = key;
+          }
+        }
+        granule.mask |= readMask;
+      }
+
+      return value;
+    }
+
+    NOELLE_NOINLINE void store (void *address, uint64_t value, int64_t size, int64_t key){
+
+      /*
+       * Accesses that span two granules are not tracked.
+       */
+      auto offset = ((uintptr_t)address) & 7;
+      if ((offset + size) > 8){
+        this->hasFailed = true;
+        return ;
+      }
+      auto granuleAddress = ((uintptr_t)address) - offset;
+
+      /*
+       * Buffer the bytes.
+       */
+      auto &granule = this->writes[granuleAddress];
+      for (auto b = 0; b < size; b++){
+        auto byte = offset + b;
+        if (!(granule.mask & (1 << byte))){
+          granule.firstKeys[byte] = key;
+          granule.mask |= (1 << byte);
+        }
+        granule.lastKeys[byte] = key;
+        granule.data[byte] = ((uint8_t *)&value)[b];
+      }
+
+      return ;
+    }
+
+    std::unordered_map<uintptr_t, NOELLE_SpeculativeGranule> writes;
+    std::unordered_map<uintptr_t, NOELLE_SpeculativeGranule> reads;
+    bool hasFailed;
+};
+
+/*
+ * Shadow memory of the thread that is running a speculative DOALL task (nullptr otherwise).
+ */
+static thread_local NOELLE_SpeculationBuffer *NOELLE_currentSpeculation = nullptr;
+
+/*
+ * Validate the speculative execution of a DOALL loop and, if it succeeded, commit its stores to memory.
+ *
+ * The execution failed if an iteration read a byte before an earlier iteration wrote it.
+ * Otherwise, every byte gets the value written by the last iteration that wrote it.
+ */
+static bool NOELLE_commitSpeculation (NOELLE_SpeculationBuffer *buffers, int64_t numberOfBuffers){
+  for (auto i = 0; i < numberOfBuffers; i++){
+    if (buffers[i].hasFailed){
+      return false;
+    }
+  }
+
+  /*
+   * Merge the stores of all threads.
+   */
+  std::unordered_map<uintptr_t, NOELLE_SpeculativeGranule> writes;
+  for (auto i = 0; i < numberOfBuffers; i++){
+    for (auto &pair : buffers[i].writes){
+      auto &threadGranule = pair.second;
+      auto &granule = writes[pair.first];
+      for (auto byte = 0; byte < 8; byte++){
+        if (!(threadGranule.mask & (1 << byte))){
+          continue ;
+        }
+        if (  false
+              || !(granule.mask & (1 << byte))
+              || (threadGranule.firstKeys[byte] < granule.firstKeys[byte])
+          ){
+          granule.firstKeys[byte] = threadGranule.firstKeys[byte];
+        }
+        if (  false
+              || !(granule.mask & (1 << byte))
+              || (threadGranule.lastKeys[byte] > granule.lastKeys[byte])
+          ){
+          granule.lastKeys[byte] = threadGranule.lastKeys[byte];
+          granule.data[byte] = threadGranule.data[byte];
+        }
+        granule.mask |= (1 << byte);
+      }
+    }
+  }
+
+  /*
+   * Check the exposed reads against the stores of earlier iterations.
+   */
+  for (auto i = 0; i < numberOfBuffers; i++){
+    for (auto &pair : buffers[i].reads){
+      auto writeIt = writes.find(pair.first);
+      if (writeIt == writes.end()){
+        continue ;
+      }
+      auto &readGranule = pair.second;
+      auto &writeGranule = writeIt->second;
+      for (auto byte = 0; byte < 8; byte++){
+        if (  true
+              && (readGranule.mask & (1 << byte))
+              && (writeGranule.mask & (1 << byte))
+              && (writeGranule.firstKeys[byte] < readGranule.lastKeys[byte])
+          ){
+          return false;
+        }
+      }
+    }
+  }
+
+  /*
+   * Commit.
+   */
+  for (auto &pair : writes){
+    auto memory = (uint8_t *)pair.first;
+    auto &granule = pair.second;
+    for (auto byte = 0; byte < 8; byte++){
+      if (granule.mask & (1 << byte)){
+        memory[byte] = granule.data[byte];
+      }
+    }
+  }
+
+  return true;
+}
+
+/*
+ * Run a task of a speculative DOALL loop with its shadow memory (and measure it if thread is not nullptr).
+ */
+template <typename... Args>
+static void NOELLE_runSpeculativeTask (NOELLE_SpeculationBuffer *buffer, NOELLE_ThreadTelemetry *thread, void (*task)(Args...), Args... args){
+  NOELLE_currentSpeculation = buffer;
+  if (thread != nullptr){
+    NOELLE_runTaskWithTelemetry(thread, task, args...);
+  } else {
+    task(args...);
+  }
+  NOELLE_currentSpeculation = nullptr;
+
+  return ;
+}
+
+/*
+ * Count a DSWP queue operation that found its queue full (push) or empty (pop).
+ */
+static NOELLE_NOINLINE void NOELLE_telemetryQueueStall (bool isFull){
+  auto thread = NOELLE_currentThreadTelemetry;
+  if (thread == nullptr){
+    return ;
+  }
+  if (isFull){
+    thread->counters.queueFullStalls++;
+  } else {
+    thread->counters.queueEmptyStalls++;
+  }
+  if (NOELLE_trace.isEnabled()){
+    thread->stallStartTime = NOELLE_now();
+  }
+
+  return ;
+}
+
+/*
+ * Add a stall of a DSWP queue that just ended to the timeline.
+ */
+static NOELLE_NOINLINE void NOELLE_traceQueueStall (uint64_t spins, bool isFull){
+  if (spins == 0){
+    return ;
+  }
+  auto thread = NOELLE_currentThreadTelemetry;
+  if (  false
+        || (thread == nullptr)
+        || (!NOELLE_trace.isEnabled())
+    ){
+    return ;
+  }
+  NOELLE_trace.complete(isFull ? "queue full" : "queue empty", "DSWP", thread->stallStartTime, NOELLE_now(), nullptr, 0);
+
+  return ;
+}
+
+/*
+ * Number of bytes of the ring buffer of each DSWP queue.
+ */
+#define NOELLE_QUEUE_BYTES (16 * 1024)
+
+/*
+ * Back off while spinning on a DSWP queue that is full or empty.
+ * The first spin of each wait is counted as a stall of the queue.
+ */
+static inline void NOELLE_queueBackoff (uint64_t &spins, bool isFull){
+  if (spins == 0){
+    NOELLE_telemetryQueueStall(isFull);
+  }
+  spins++;
+  if ((spins % 1024) == 0){
+    std::this_thread::yield();
+  }
+
+  return ;
+}
+
+/*
+ * Single-producer/single-consumer ring buffer that connects two DSWP stages.
+ *
+ * The index published by the producer (tail) and the one published by the consumer (head) live in different cache lines.
+ * Each side keeps a private copy of its own index and a cached copy of the remote one, which is refreshed only when the ring buffer looks full (producer) or empty (consumer).
+ * Indices are published once per batch of elements, where a batch fills a cache line of the ring buffer.
+ * The producer must call flush at the end of its stage to publish its last (partial) batch.
+ */
+template <typename T>
+class NOELLE_SPSCQueue {
+  public:
+    NOELLE_SPSCQueue ()
+      : tail{0}, head{0}, producerTail{0}, producerCachedHead{0}, consumerHead{0}, consumerCachedTail{0}
+      {
+      return ;
+    }
+
+    inline void push (T value){
+
+      /*
+       * Check if the ring buffer is full.
+       */
+      if ((this->producerTail - this->producerCachedHead) == capacity){
+
+        /*
+         * Publish the pending elements to let the consumer drain them, and wait for free slots.
+         */
+        this->tail.store(this->producerTail, std::memory_order_release);
+        uint64_t spins = 0;
+        for (;;){
+          this->producerCachedHead = this->head.load(std::memory_order_acquire);
+          if ((this->producerTail - this->producerCachedHead) < capacity){
+            break ;
+          }
+          NOELLE_queueBackoff(spins, true);
+        }
+        NOELLE_traceQueueStall(spins, true);
+      }
+
+      /*
+       * Append the element.
+       */
+      this->buffer[this->producerTail & (capacity - 1)] = value;
+      this->producerTail++;
+
+      /*
+       * Publish the batch if it is complete.
+       */
+      if ((this->producerTail & (batch - 1)) == 0){
+        this->tail.store(this->producerTail, std::memory_order_release);
+      }
+
+      return ;
+    }
+
+    inline void pop (T &value){
+
+      /*
+       * Check if the ring buffer is empty.
+       */
+      if (this->consumerHead == this->consumerCachedTail){
+
+        /*
+         * Return the consumed slots to the producer, and wait for new elements.
+         */
+        this->head.store(this->consumerHead, std::memory_order_release);
+        uint64_t spins = 0;
+        for (;;){
+          this->consumerCachedTail = this->tail.load(std::memory_order_acquire);
+          if (this->consumerCachedTail != this->consumerHead){
+            break ;
+          }
+          NOELLE_queueBackoff(spins, false);
+        }
+        NOELLE_traceQueueStall(spins, false);
+      }
+
+      /*
+       * Fetch the element.
+       */
+      value = this->buffer[this->consumerHead & (capacity - 1)];
+      this->consumerHead++;
+
+      /*
+       * Return the slots of a fully-consumed batch to the producer.
+       */
+      if ((this->consumerHead & (batch - 1)) == 0){
+        this->head.store(this->consumerHead, std::memory_order_release);
+      }
+
+      return ;
+    }
+
+    inline void flush (void){
+      this->tail.store(this->producerTail, std::memory_order_release);
+
+      return ;
+    }
+
+  private:
+    static constexpr uint64_t batch = (sizeof(T) >= CACHE_LINE_SIZE) ? 1 : (CACHE_LINE_SIZE / sizeof(T));
+    static constexpr uint64_t capacity = NOELLE_QUEUE_BYTES / sizeof(T);
+    static_assert((capacity & (capacity - 1)) == 0, "The capacity of a DSWP queue must be a power of 2");
+    static_assert(capacity >= (batch * 4), "A DSWP queue must hold several batches");
+
+    /*
+     * Shared indices: each one is written by a single side.
+     */
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+
+    /*
+     * Producer-private state.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t producerTail;
+    uint64_t producerCachedHead;
+
+    /*
+     * Consumer-private state.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t consumerHead;
+    uint64_t consumerCachedTail;
+
+    /*
+     * Elements.
+     */
+    alignas(CACHE_LINE_SIZE) T buffer[capacity];
+};
+
+/*
+ * Single-producer/single-consumer ring buffer of fixed-size entries whose size is known only at run time.
+ * It follows the protocol of NOELLE_SPSCQueue, and DSWP uses it to move all values that flow between two stages within an iteration as a single entry.
+ */
+class NOELLE_SPSCEntryQueue {
+  public:
+    NOELLE_SPSCEntryQueue (uint64_t entryBytes, uint64_t capacity, uint64_t batch, uint8_t *buffer)
+      : tail{0}, head{0}, producerTail{0}, producerCachedHead{0}, consumerHead{0}, consumerCachedTail{0},
+        entryBytes{entryBytes}, capacity{capacity}, batch{batch}, buffer{buffer}
+      {
+      return ;
+    }
+
+    inline void push (void *entry){
+
+      /*
+       * Check if the ring buffer is full.
+       */
+      if ((this->producerTail - this->producerCachedHead) == this->capacity){
+        this->tail.store(this->producerTail, std::memory_order_release);
+        uint64_t spins = 0;
+        for (;;){
+          this->producerCachedHead = this->head.load(std::memory_order_acquire);
+          if ((this->producerTail - this->producerCachedHead) < this->capacity){
+            break ;
+          }
+          NOELLE_queueBackoff(spins, true);
+        }
+        NOELLE_traceQueueStall(spins, true);
+      }
+
+      /*
+       * Append the entry.
+       */
+      auto slot = this->buffer + ((this->producerTail & (this->capacity - 1)) * this->entryBytes);
+      memcpy(slot, entry, this->entryBytes);
+      this->producerTail++;
+
+      /*
+       * Publish the batch if it is complete.
+       */
+      if ((this->producerTail & (this->batch - 1)) == 0){
+        this->tail.store(this->producerTail, std::memory_order_release);
+      }
+
+      return ;
+    }
+
+    inline void pop (void *entry){
+
+      /*
+       * Check if the ring buffer is empty.
+       */
+      if (this->consumerHead == this->consumerCachedTail){
+        this->head.store(this->consumerHead, std::memory_order_release);
+        uint64_t spins = 0;
+        for (;;){
+          this->consumerCachedTail = this->tail.load(std::memory_order_acquire);
+          if (this->consumerCachedTail != this->consumerHead){
+            break ;
+          }
+          NOELLE_queueBackoff(spins, false);
+        }
+        NOELLE_traceQueueStall(spins, false);
+      }
+
+      /*
+       * Fetch the entry.
+       */
+      auto slot = this->buffer + ((this->consumerHead & (this->capacity - 1)) * this->entryBytes);
+      memcpy(entry, slot, this->entryBytes);
+      this->consumerHead++;
+
+      /*
+       * Return the slots of a fully-consumed batch to the producer.
+       */
+      if ((this->consumerHead & (this->batch - 1)) == 0){
+        this->head.store(this->consumerHead, std::memory_order_release);
+      }
+
+      return ;
+    }
+
+    inline void flush (void){
+      this->tail.store(this->producerTail, std::memory_order_release);
+
+      return ;
+    }
+
+  private:
+
+    /*
+     * Shared indices: each one is written by a single side.
+     */
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+
+    /*
+     * Producer-private state.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t producerTail;
+    uint64_t producerCachedHead;
+
+    /*
+     * Consumer-private state.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t consumerHead;
+    uint64_t consumerCachedTail;
+
+    /*
+     * Read-only shape of the ring buffer.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t entryBytes;
+    uint64_t capacity;
+    uint64_t batch;
+    uint8_t *buffer;
+};
+
+static NOELLE_SPSCEntryQueue * NOELLE_allocateEntryQueue (uint64_t entryBytes){
+
+  /*
+   * Compute the number of entries that fill a cache line (batch) and the number of entries of the ring buffer (capacity).
+   * Both must be powers of 2.
+   */
+  uint64_t batch = 1;
+  while ((batch * 2 * entryBytes) <= CACHE_LINE_SIZE){
+    batch *= 2;
+  }
+  uint64_t capacity = batch * 4;
+  while ((capacity * 2 * entryBytes) <= NOELLE_QUEUE_BYTES){
+    capacity *= 2;
+  }
+
+  /*
+   * Allocate the queue and its ring buffer right after it.
+   */
+  void *memory = nullptr;
+  if (posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(NOELLE_SPSCEntryQueue) + (capacity * entryBytes)) != 0){
+    std::cerr << "DSWP: ERROR = not enough memory to allocate a queue\n";
+    abort();
+  }
+  auto buffer = ((uint8_t *)memory) + sizeof(NOELLE_SPSCEntryQueue);
+
+  return new (memory) NOELLE_SPSCEntryQueue(entryBytes, capacity, batch, buffer);
+}
+
+static void NOELLE_freeEntryQueue (void *queue){
+  auto q = (NOELLE_SPSCEntryQueue *) queue;
+  q->~NOELLE_SPSCEntryQueue();
+  free(q);
+
+  return ;
+}
+
+/*
+ * Ring buffer of fixed-size entries with a single producer and several consumers, where each consumer reads every entry.
+ * Each consumer has its own read index in its own cache line.
+ * The producer caches the position of the slowest consumer, and it recomputes it only when the ring buffer looks full.
+ */
+class NOELLE_BroadcastQueue {
+  public:
+    /*
+     * State of a consumer: the published read index and the private one live in different cache lines.
+     */
+    struct Consumer {
+      alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+      alignas(CACHE_LINE_SIZE) uint64_t consumerHead;
+      uint64_t consumerCachedTail;
+    };
+
+    NOELLE_BroadcastQueue (uint64_t entryBytes, uint64_t capacity, uint64_t batch, uint64_t numberOfConsumers, Consumer *consumers, uint8_t *buffer)
+      : tail{0}, producerTail{0}, producerCachedMinHead{0},
+        entryBytes{entryBytes}, capacity{capacity}, batch{batch}, numberOfConsumers{numberOfConsumers}, consumers{consumers}, buffer{buffer}
+      {
+      for (uint64_t i = 0; i < numberOfConsumers; i++){
+        this->consumers[i].head.store(0, std::memory_order_relaxed);
+        this->consumers[i].consumerHead = 0;
+        this->consumers[i].consumerCachedTail = 0;
+      }
+
+      return ;
+    }
+
+    inline void push (void *entry){
+
+      /*
+       * Check if the slowest consumer is a whole ring buffer behind.
+       */
+      if ((this->producerTail - this->producerCachedMinHead) == this->capacity){
+        this->tail.store(this->producerTail, std::memory_order_release);
+        uint64_t spins = 0;
+        for (;;){
+          auto minHead = this->consumers[0].head.load(std::memory_order_acquire);
+          for (uint64_t i = 1; i < this->numberOfConsumers; i++){
+            auto head = this->consumers[i].head.load(std::memory_order_acquire);
+            if (head < minHead){
+              minHead = head;
+            }
+          }
+          this->producerCachedMinHead = minHead;
+          if ((this->producerTail - this->producerCachedMinHead) < this->capacity){
+            break ;
+          }
+          NOELLE_queueBackoff(spins, true);
+        }
+        NOELLE_traceQueueStall(spins, true);
+      }
+
+      /*
+       * Append the entry.
+       */
+      auto slot = this->buffer + ((this->producerTail & (this->capacity - 1)) * this->entryBytes);
+      memcpy(slot, entry, this->entryBytes);
+      this->producerTail++;
+
+      /*
+       * Publish the batch if it is complete.
+       */
+      if ((this->producerTail & (this->batch - 1)) == 0){
+        this->tail.store(this->producerTail, std::memory_order_release);
+      }
+
+      return ;
+    }
+
+    inline void pop (int64_t consumerID, void *entry){
+      auto &consumer = this->consumers[consumerID];
+
+      /*
+       * Check if there is no new entry for the current consumer.
+       */
+      if (consumer.consumerHead == consumer.consumerCachedTail){
+        consumer.head.store(consumer.consumerHead, std::memory_order_release);
+        uint64_t spins = 0;
+        for (;;){
+          consumer.consumerCachedTail = this->tail.load(std::memory_order_acquire);
+          if (consumer.consumerCachedTail != consumer.consumerHead){
+            break ;
+          }
+          NOELLE_queueBackoff(spins, false);
+        }
+        NOELLE_traceQueueStall(spins, false);
+      }
+
+      /*
+       * Fetch the entry.
+       */
+      auto slot = this->buffer + ((consumer.consumerHead & (this->capacity - 1)) * this->entryBytes);
+      memcpy(entry, slot, this->entryBytes);
+      consumer.consumerHead++;
+
+      /*
+       * Return the slots of a fully-consumed batch to the producer.
+       */
+      if ((consumer.consumerHead & (this->batch - 1)) == 0){
+        consumer.head.store(consumer.consumerHead, std::memory_order_release);
+      }
+
+      return ;
+    }
+
+    inline void flush (void){
+      this->tail.store(this->producerTail, std::memory_order_release);
+
+      return ;
+    }
+
+  private:
+
+    /*
+     * Index published by the producer.
+     */
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+
+    /*
+     * Producer-private state.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t producerTail;
+    uint64_t producerCachedMinHead;
+
+    /*
+     * Read-only shape of the ring buffer.
+     */
+    alignas(CACHE_LINE_SIZE) uint64_t entryBytes;
+    uint64_t capacity;
+    uint64_t batch;
+    uint64_t numberOfConsumers;
+    Consumer *consumers;
+    uint8_t *buffer;
+};
+
+static NOELLE_BroadcastQueue * NOELLE_allocateBroadcastQueue (uint64_t entryBytes, uint64_t numberOfConsumers){
+
+  /*
+   * Compute the shape of the ring buffer as for single-consumer queues.
+   */
+  uint64_t batch = 1;
+  while ((batch * 2 * entryBytes) <= CACHE_LINE_SIZE){
+    batch *= 2;
+  }
+  uint64_t capacity = batch * 4;
+  while ((capacity * 2 * entryBytes) <= NOELLE_QUEUE_BYTES){
+    capacity *= 2;
+  }
+
+  /*
+   * Allocate the queue, the state of its consumers, and its ring buffer.
+   */
+  auto consumersBytes = sizeof(NOELLE_BroadcastQueue::Consumer) * numberOfConsumers;
+  void *memory = nullptr;
+  if (posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(NOELLE_BroadcastQueue) + consumersBytes + (capacity * entryBytes)) != 0){
+    std::cerr << "DSWP: ERROR = not enough memory to allocate a broadcast queue\n";
+    abort();
+  }
+  auto consumers = (NOELLE_BroadcastQueue::Consumer *)(((uint8_t *)memory) + sizeof(NOELLE_BroadcastQueue));
+  for (uint64_t i = 0; i < numberOfConsumers; i++){
+    new (&consumers[i]) NOELLE_BroadcastQueue::Consumer();
+  }
+  auto buffer = ((uint8_t *)memory) + sizeof(NOELLE_BroadcastQueue) + consumersBytes;
+
+  return new (memory) NOELLE_BroadcastQueue(entryBytes, capacity, batch, numberOfConsumers, consumers, buffer);
+}
+
+static void NOELLE_freeBroadcastQueue (void *queue){
+  auto q = (NOELLE_BroadcastQueue *) queue;
+  q->~NOELLE_BroadcastQueue();
+  free(q);
+
+  return ;
+}
+
+template <typename T>
+static NOELLE_SPSCQueue<T> * NOELLE_allocateQueue (void){
+
+  /*
+   * Queues are over-aligned, so we cannot rely on the C++14 "new".
+   */
+  void *memory = nullptr;
+  if (posix_memalign(&memory, CACHE_LINE_SIZE, sizeof(NOELLE_SPSCQueue<T>)) != 0){
+    std::cerr << "DSWP: ERROR = not enough memory to allocate a queue\n";
+    abort();
+  }
+
+  return new (memory) NOELLE_SPSCQueue<T>();
+}
+
+template <typename T>
+static void NOELLE_freeQueue (void *queue){
+  auto q = (NOELLE_SPSCQueue<T> *) queue;
+  q->~NOELLE_SPSCQueue<T>();
+  free(q);
+
+  return ;
+}
 
 extern "C" {
 
@@ -44,18 +2467,103 @@ extern "C" {
   };
 
   /*
-   * Return the number of cores to use for the parallelization.
+   * Return the number of cores to use for the parallelization.
+   */
+  int32_t NOELLE_getNumberOfCores (void);
+
+  /*
+   * Dispatch threads to run a DOALL loop.
+   * If areTasksWaitingForEachOther is 1 (e.g., the tasks combine their reductions in a tree), then the loop runs only on threads of the pool that are not running other tasks.
+   */
+  DispatcherInfo NOELLE_DOALLDispatcher (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t numberOfIterations,
+    int64_t loopID,
+    int64_t areTasksWaitingForEachOther
+    );
+
+  /*
+   * Choose the number of cores to use for the current invocation of a DOALL loop.
+   * The loop should run sequentially if this returns 1.
+   */
+  int64_t NOELLE_DOALLChooseNumberOfCores (
+    int64_t loopID,
+    int64_t numberOfIterations,
+    int64_t maxNumberOfCores
+    );
+
+  /*
+   * Dispatch threads to run a DOALL loop speculatively.
+   * If an iteration of the loop depends on an earlier one, then the loop is re-executed sequentially; in this case, the number of threads used is 1.
+   */
+  DispatcherInfo NOELLE_DOALLSpeculativeDispatcher (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t numberOfIterations,
+    int64_t loopID,
+    int64_t areTasksWaitingForEachOther
+    );
+
+  /*
+   * Load and store of a speculative DOALL task.
+   * The value is in the lower size bytes, and iteration identifies the iteration of the loop that performs the access (it increases with the iterations).
+   */
+  uint64_t NOELLE_DOALLSpeculativeLoad (
+    void *address,
+    int64_t size,
+    int64_t iteration
+    );
+  void NOELLE_DOALLSpeculativeStore (
+    void *address,
+    uint64_t value,
+    int64_t size,
+    int64_t iteration
+    );
+
+  /*
+   * Count the outcome of the run-time checks of aliasing that guard a DOALL loop.
+   * Only the outcome of the checks is recorded: the parallelized loop can still not run when areDisjoint is 1 (e.g., because of the number of cores chosen).
    */
-  int32_t NOELLE_getNumberOfCores (void);
+  void NOELLE_DOALLCountAliasCheck (
+    int64_t loopID,
+    int64_t areDisjoint
+    );
 
   /*
-   * Dispatch threads to run a DOALL loop.
+   * Dependence profiler.
+   * They are invoked by the code injected by noelle-prof-dependences: when a profiled loop starts, at the beginning of each of its iterations, and before each load (isWrite is 0) or store (isWrite is 1) of its may dependences.
    */
-  DispatcherInfo NOELLE_DOALLDispatcher (
-    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
-    void *env, 
-    int64_t maxNumberOfCores, 
-    int64_t chunkSize
+  void NOELLE_DependenceProfilerInvocation (
+    int64_t loopIndex
+    );
+  void NOELLE_DependenceProfilerIteration (
+    int64_t loopIndex
+    );
+  void NOELLE_DependenceProfilerAccess (
+    int64_t loopIndex,
+    int64_t instructionID,
+    void *address,
+    int64_t size,
+    int64_t isWrite
+    );
+
+  /*
+   * Loop profiler.
+   * They are invoked by the code injected by noelle-prof-loops: when a profiled loop starts, at the beginning of each of its iterations, and when it exits.
+   */
+  void NOELLE_LoopProfilerInvocationStart (
+    int64_t loopID
+    );
+  void NOELLE_LoopProfilerIteration (
+    int64_t loopID
+    );
+  void NOELLE_LoopProfilerInvocationEnd (
+    int64_t loopID
     );
 
 
@@ -67,25 +2575,39 @@ extern "C" {
    *                MISC
    **********************************************************************/
   int32_t NOELLE_getNumberOfCores (void){
-    static int32_t cores = 0;
+    static std::atomic<int32_t> cores{0};
+    static std::atomic<uint64_t> lastCheck{0};
+    static std::atomic<bool> isSetByUser{false};
 
     /*
      * Check if we have already computed the number of cores.
+     * If the user did not set it, the usable cores can change over time (e.g., a new affinity mask or cgroup quota), so we re-check them periodically.
      */
-    if (cores == 0){
+    auto currentCores = cores.load(std::memory_order_relaxed);
+    if (  true
+          && (currentCores != 0)
+          && (  false
+                || isSetByUser
+                || ((NOELLE_now() - lastCheck.load(std::memory_order_relaxed)) < NOELLE_CORES_RECHECK_PERIOD)
+             )
+      ){
+      return currentCores;
+    }
 
-      /*
-       * Compute the number of cores.
-       */
-      auto envVar = getenv("NOELLE_CORES");
-      if (envVar == nullptr){
-        cores = std::thread::hardware_concurrency();
-      } else {
-        cores = atoi(envVar);
-      }
+    /*
+     * Compute the number of cores.
+     */
+    auto envVar = getenv("NOELLE_CORES");
+    if (envVar == nullptr){
+      currentCores = NOELLE_getNumberOfUsableCores();
+    } else {
+      currentCores = atoi(envVar);
+      isSetByUser = true;
     }
+    lastCheck.store(NOELLE_now(), std::memory_order_relaxed);
+    cores.store(currentCores, std::memory_order_relaxed);
 
-    return cores;
+    return currentCores;
   }
 
   typedef void (*stageFunctionPtr_t)(void *, void*);
@@ -108,7 +2630,7 @@ extern "C" {
     printf("Pulled: %p\n", p);
   }
 
-  void queuePush8(ThreadSafeQueue<int8_t> *queue, int8_t *val) { 
+  NOELLE_INLINE void queuePush8(NOELLE_SPSCQueue<int8_t> *queue, int8_t *val) { 
     queue->push(*val); 
 
     #ifdef DSWP_STATS
@@ -118,12 +2640,12 @@ extern "C" {
     return ;
   }
 
-  void queuePop8(ThreadSafeQueue<int8_t> *queue, int8_t *val) { 
-    queue->waitPop(*val); 
+  NOELLE_INLINE void queuePop8(NOELLE_SPSCQueue<int8_t> *queue, int8_t *val) { 
+    queue->pop(*val); 
     return ;
   }
 
-  void queuePush16(ThreadSafeQueue<int16_t> *queue, int16_t *val) { 
+  NOELLE_INLINE void queuePush16(NOELLE_SPSCQueue<int16_t> *queue, int16_t *val) { 
     queue->push(*val); 
 
     #ifdef DSWP_STATS
@@ -133,11 +2655,11 @@ extern "C" {
     return ;
   }
 
-  void queuePop16(ThreadSafeQueue<int16_t> *queue, int16_t *val) { 
-    queue->waitPop(*val);
+  NOELLE_INLINE void queuePop16(NOELLE_SPSCQueue<int16_t> *queue, int16_t *val) { 
+    queue->pop(*val);
   }
 
-  void queuePush32(ThreadSafeQueue<int32_t> *queue, int32_t *val) { 
+  NOELLE_INLINE void queuePush32(NOELLE_SPSCQueue<int32_t> *queue, int32_t *val) { 
     queue->push(*val); 
 
     #ifdef DSWP_STATS
@@ -147,11 +2669,11 @@ extern "C" {
     return ;
   }
 
-  void queuePop32(ThreadSafeQueue<int32_t> *queue, int32_t *val) { 
-    queue->waitPop(*val);
+  NOELLE_INLINE void queuePop32(NOELLE_SPSCQueue<int32_t> *queue, int32_t *val) { 
+    queue->pop(*val);
   }
 
-  void queuePush64(ThreadSafeQueue<int64_t> *queue, int64_t *val) { 
+  NOELLE_INLINE void queuePush64(NOELLE_SPSCQueue<int64_t> *queue, int64_t *val) { 
     queue->push(*val); 
 
     #ifdef DSWP_STATS
@@ -161,12 +2683,63 @@ extern "C" {
     return ;
   }
 
-  void queuePop64(ThreadSafeQueue<int64_t> *queue, int64_t *val) { 
-    queue->waitPop(*val); 
+  NOELLE_INLINE void queuePop64(NOELLE_SPSCQueue<int64_t> *queue, int64_t *val) {
+    queue->pop(*val);
 
     return ;
   }
 
+  /*
+   * Publish the elements pushed since the last complete batch.
+   * A stage must flush each queue it pushes to before it ends.
+   */
+  NOELLE_INLINE void queueFlush8(NOELLE_SPSCQueue<int8_t> *queue) {
+    queue->flush();
+  }
+
+  NOELLE_INLINE void queueFlush16(NOELLE_SPSCQueue<int16_t> *queue) {
+    queue->flush();
+  }
+
+  NOELLE_INLINE void queueFlush32(NOELLE_SPSCQueue<int32_t> *queue) {
+    queue->flush();
+  }
+
+  NOELLE_INLINE void queueFlush64(NOELLE_SPSCQueue<int64_t> *queue) {
+    queue->flush();
+  }
+
+  /*
+   * Queues of entries that pack several values produced by a stage within the same iteration.
+   */
+  NOELLE_INLINE void queuePushEntry(NOELLE_SPSCEntryQueue *queue, int8_t *entry) {
+    queue->push(entry);
+  }
+
+  NOELLE_INLINE void queuePopEntry(NOELLE_SPSCEntryQueue *queue, int8_t *entry) {
+    queue->pop(entry);
+  }
+
+  NOELLE_INLINE void queueFlushEntry(NOELLE_SPSCEntryQueue *queue) {
+    queue->flush();
+  }
+
+  /*
+   * Queues that deliver each value to several stages.
+   * Each consumer stage pops with its own (constant) ID.
+   */
+  NOELLE_INLINE void queuePushBroadcast(NOELLE_BroadcastQueue *queue, int8_t *entry) {
+    queue->push(entry);
+  }
+
+  NOELLE_INLINE void queuePopBroadcast(NOELLE_BroadcastQueue *queue, int64_t consumerID, int8_t *entry) {
+    queue->pop(consumerID, entry);
+  }
+
+  NOELLE_INLINE void queueFlushBroadcast(NOELLE_BroadcastQueue *queue) {
+    queue->flush();
+  }
+
 
   /**********************************************************************
    *                DOALL
@@ -194,18 +2767,53 @@ extern "C" {
     return ;
   }
 
-  DispatcherInfo NOELLE_DOALLDispatcher (
+  /*
+   * Return the number of iterations of the block of each core when the iterations of a DOALL loop are distributed in one block per core.
+   */
+  static int64_t NOELLE_DOALLBlockSize (int64_t numberOfIterations, int64_t numCores){
+    if (numberOfIterations <= 0){
+      return 1;
+    }
+
+    return (numberOfIterations + numCores - 1) / numCores;
+  }
+
+  static DispatcherInfo NOELLE_DOALLRun (
     void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
     void *env, 
     int64_t maxNumberOfCores, 
-    int64_t chunkSize
+    int64_t chunkSize,
+    int64_t numberOfIterations,
+    int64_t loopID,
+    bool isSpeculative,
+    bool areTasksWaitingForEachOther
     ){
 
     /*
      * Set the number of cores to use.
      */
     auto runtimeNumberOfCores = NOELLE_getNumberOfCores();
-    auto numCores = runtimeNumberOfCores > maxNumberOfCores ? maxNumberOfCores : runtimeNumberOfCores;
+    int64_t numCores = runtimeNumberOfCores > maxNumberOfCores ? maxNumberOfCores : runtimeNumberOfCores;
+
+    /*
+     * Tasks that wait for each other must all run at the same time.
+     * The number of cores (e.g., NOELLE_CORES) can exceed the threads of the pool, and other loops (e.g., outer ones) can be using some of them.
+     * Hence, these tasks only use the threads of the pool that are not running other tasks.
+     */
+    if (areTasksWaitingForEachOther){
+      numCores = NOELLE_poolThreads.occupyFree(numCores);
+    } else {
+      NOELLE_poolThreads.occupy(numCores);
+    }
+
+    /*
+     * A chunk size of 0 asks for a block distribution: each core runs a single chunk of contiguous iterations.
+     * The compiler asks for it only if the number of iterations is known.
+     */
+    auto isBlockDistributed = (chunkSize == 0);
+    if (isBlockDistributed){
+      chunkSize = NOELLE_DOALLBlockSize(numberOfIterations, numCores);
+    }
     #ifdef RUNTIME_PRINT
     std::cerr << "Starting dispatcher: num cores " << numCores << ", chunk size: " << chunkSize << std::endl;
     #endif
@@ -216,9 +2824,31 @@ extern "C" {
     DOALL_args_t *argsForAllCores;
     posix_memalign((void **)&argsForAllCores, CACHE_LINE_SIZE, sizeof(DOALL_args_t) * numCores);
 
+    /*
+     * Start the telemetry of the invocation.
+     * Invocations with a known number of iterations are always measured to feed the cost model.
+     */
+    auto isModeled = NOELLE_DOALLModel.isEnabled() && (numberOfIterations > 0);
+    NOELLE_InvocationTelemetry *telemetry = nullptr;
+    if (  false
+          || isModeled
+          || NOELLE_isInstrumented()
+      ){
+      telemetry = new NOELLE_InvocationTelemetry("DOALL", loopID, numCores, chunkSize, 0);
+    }
+
+    /*
+     * Allocate the shadow memory of the tasks of a speculative loop.
+     */
+    NOELLE_SpeculationBuffer *buffers = nullptr;
+    if (isSpeculative){
+      buffers = new NOELLE_SpeculationBuffer[numCores];
+    }
+
     /*
      * Submit DOALL tasks.
      */
+    cpu_set_t cores;
     std::vector<MARC::TaskFuture<void>> localFutures;
     for (auto i = 0; i < numCores; ++i) {
 
@@ -236,7 +2866,39 @@ extern "C" {
        * Submit
        */
       //localFutures.push_back(pool.submit(NOELLE_DOALLTrampoline, argsPerCore));
-      localFutures.push_back(pool.submit(parallelizedLoop, env, i, numCores, chunkSize));
+      auto isPinned = NOELLE_placement.getCores(i, cores, NOELLE_placement.isDOALLMappingStable());
+      NOELLE_ThreadTelemetry *thread = nullptr;
+      if (telemetry != nullptr){
+
+        /*
+         * Chunks are assigned to cores round-robin, so we can count them if the number of iterations is known.
+         */
+        thread = telemetry->getThread(i);
+        if (numberOfIterations >= 0){
+          auto numberOfChunks = (numberOfIterations + chunkSize - 1) / chunkSize;
+          thread->counters.chunks = (numberOfChunks > i) ? ((numberOfChunks - i + numCores - 1) / numCores) : 0;
+        }
+      }
+      if (buffers != nullptr){
+        if (isPinned){
+          localFutures.push_back(pool.submitToCores(cores, NOELLE_runSpeculativeTask<void *, int64_t, int64_t, int64_t>, &buffers[i], thread, parallelizedLoop, env, (int64_t)i, (int64_t)numCores, chunkSize));
+        } else {
+          localFutures.push_back(pool.submit(NOELLE_runSpeculativeTask<void *, int64_t, int64_t, int64_t>, &buffers[i], thread, parallelizedLoop, env, (int64_t)i, (int64_t)numCores, chunkSize));
+        }
+
+      } else if (thread != nullptr){
+        if (isPinned){
+          localFutures.push_back(pool.submitToCores(cores, NOELLE_runTaskWithTelemetry<void *, int64_t, int64_t, int64_t>, thread, parallelizedLoop, env, (int64_t)i, (int64_t)numCores, chunkSize));
+        } else {
+          localFutures.push_back(pool.submit(NOELLE_runTaskWithTelemetry<void *, int64_t, int64_t, int64_t>, thread, parallelizedLoop, env, (int64_t)i, (int64_t)numCores, chunkSize));
+        }
+
+      } else if (isPinned){
+        localFutures.push_back(pool.submitToCores(cores, parallelizedLoop, env, (int64_t)i, (int64_t)numCores, chunkSize));
+
+      } else {
+        localFutures.push_back(pool.submit(parallelizedLoop, env, i, numCores, chunkSize));
+      }
       #ifdef RUNTIME_PRINT
       std::cerr << "Submitted DOALL task on core " << i << std::endl;
       #endif
@@ -251,20 +2913,154 @@ extern "C" {
     for (auto& future : localFutures){
       future.get();
     }
+    NOELLE_poolThreads.release(numCores);
     #ifdef RUNTIME_PRINT
     std::cerr << "Got all futures" << std::endl;
     #endif
 
+    /*
+     * Validate the speculative execution.
+     * If it failed, then nothing has been written to memory, so we re-execute the loop sequentially (without speculating) by running its task on a single core.
+     */
+    DispatcherInfo dispatcherInfo;
+    dispatcherInfo.numberOfThreadsUsed = numCores;
+    if (buffers != nullptr){
+      auto hasSucceeded = NOELLE_commitSpeculation(buffers, numCores);
+      delete[] buffers;
+      if (NOELLE_loopVersionCounters.isEnabled()){
+        NOELLE_loopVersionCounters.count("speculation", loopID, hasSucceeded);
+      }
+      if (!hasSucceeded){
+        #ifdef RUNTIME_PRINT
+        std::cerr << "DOALL: speculation of loop " << loopID << " failed" << std::endl;
+        #endif
+        parallelizedLoop(env, 0, 1, isBlockDistributed ? NOELLE_DOALLBlockSize(numberOfIterations, 1) : chunkSize);
+        dispatcherInfo.numberOfThreadsUsed = 1;
+
+        /*
+         * The cost model must not learn from the failed execution.
+         */
+        isModeled = false;
+      }
+    }
+
+    /*
+     * Log the invocation, and learn from it.
+     */
+    if (telemetry != nullptr){
+      telemetry->end();
+      if (isModeled){
+        NOELLE_DOALLModel.update(loopID, numberOfIterations, numCores, telemetry);
+      }
+      delete telemetry;
+    }
+
     /*
      * Free the memory.
      */
     free(argsForAllCores);
 
-    DispatcherInfo dispatcherInfo;
-    dispatcherInfo.numberOfThreadsUsed = numCores;
     return dispatcherInfo;
   }
 
+  DispatcherInfo NOELLE_DOALLDispatcher (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t numberOfIterations,
+    int64_t loopID,
+    int64_t areTasksWaitingForEachOther
+    ){
+    return NOELLE_DOALLRun(parallelizedLoop, env, maxNumberOfCores, chunkSize, numberOfIterations, loopID, false, areTasksWaitingForEachOther != 0);
+  }
+
+  DispatcherInfo NOELLE_DOALLSpeculativeDispatcher (
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t), 
+    void *env, 
+    int64_t maxNumberOfCores, 
+    int64_t chunkSize,
+    int64_t numberOfIterations,
+    int64_t loopID,
+    int64_t areTasksWaitingForEachOther
+    ){
+    return NOELLE_DOALLRun(parallelizedLoop, env, maxNumberOfCores, chunkSize, numberOfIterations, loopID, true, areTasksWaitingForEachOther != 0);
+  }
+
+  NOELLE_INLINE uint64_t NOELLE_DOALLSpeculativeLoad (
+    void *address,
+    int64_t size,
+    int64_t iteration
+    ){
+    auto buffer = NOELLE_currentSpeculation;
+    if (buffer == nullptr){
+      uint64_t value = 0;
+      memcpy(&value, address, size);
+      return value;
+    }
+
+    return buffer->load(address, size, iteration);
+  }
+
+  NOELLE_INLINE void NOELLE_DOALLSpeculativeStore (
+    void *address,
+    uint64_t value,
+    int64_t size,
+    int64_t iteration
+    ){
+    auto buffer = NOELLE_currentSpeculation;
+    if (buffer == nullptr){
+      memcpy(address, &value, size);
+      return ;
+    }
+
+    buffer->store(address, value, size, iteration);
+
+    return ;
+  }
+
+  int64_t NOELLE_DOALLChooseNumberOfCores (
+    int64_t loopID,
+    int64_t numberOfIterations,
+    int64_t maxNumberOfCores
+    ){
+
+    /*
+     * Never use more cores than the ones available.
+     */
+    int64_t runtimeNumberOfCores = NOELLE_getNumberOfCores();
+    auto numCores = runtimeNumberOfCores > maxNumberOfCores ? maxNumberOfCores : runtimeNumberOfCores;
+
+    /*
+     * Keep the same number of cores across invocations if the mapping between iterations and cores must be stable.
+     */
+    if (NOELLE_placement.isDOALLMappingStable()){
+      return numCores;
+    }
+
+    /*
+     * Let the cost model choose.
+     */
+    numCores = NOELLE_DOALLModel.chooseNumberOfCores(loopID, numberOfIterations, numCores);
+    #ifdef RUNTIME_PRINT
+    std::cerr << "DOALL: loop " << loopID << " with " << numberOfIterations << " iterations will run on " << numCores << " cores" << std::endl;
+    #endif
+
+    return numCores;
+  }
+
+  void NOELLE_DOALLCountAliasCheck (
+    int64_t loopID,
+    int64_t areDisjoint
+    ){
+    if (!NOELLE_loopVersionCounters.isEnabled()){
+      return ;
+    }
+    NOELLE_loopVersionCounters.count("alias", loopID, areDisjoint != 0);
+
+    return ;
+  }
+
   #ifdef RUNTIME_PRINT
   void *mySSGlobal = nullptr;
   #endif
@@ -273,7 +3069,7 @@ extern "C" {
   /**********************************************************************
    *                HELIX
    **********************************************************************/
-  void HELIX_helperThread (void *ssArray, uint32_t numOfsequentialSegments, uint64_t *theLoopIsOver){
+  void HELIX_helperThread (void *ssArray, uint32_t numOfsequentialSegments, int64_t sequentialSegmentBytes, uint64_t *theLoopIsOver){
 
     while ((*theLoopIsOver) == 0){
 
@@ -285,7 +3081,7 @@ extern "C" {
         /*
          * Fetch the pointer.
          */
-        auto ptr = (uint64_t *)(((uint64_t)ssArray) + (i * CACHE_LINE_SIZE));
+        auto ptr = (uint64_t *)(((uint64_t)ssArray) + (i * sequentialSegmentBytes));
 
         /*
          * Prefetch the cache line for the current sequential segment.
@@ -302,7 +3098,9 @@ extern "C" {
     void *env,
     void *loopCarriedArray,
     int64_t numCores, 
-    int64_t numOfsequentialSegments
+    int64_t numOfsequentialSegments,
+    int64_t sequentialSegmentBytes,
+    int64_t loopID
     ){
     #ifdef RUNTIME_PRINT
     std::cerr << "HELIX: dispatcher: Start" << std::endl;
@@ -316,21 +3114,23 @@ extern "C" {
     assert(parallelizedLoop != NULL);
     assert(env != NULL);
     assert(numCores > 1);
+    assert(sequentialSegmentBytes >= (int64_t)sizeof(pthread_spinlock_t));
 
     /*
      * Allocate the sequential segment arrays.
+     * Each sequential segment takes sequentialSegmentBytes bytes, which is the cache line size the compiler used to generate the accesses of the task.
      * We need numCores - 1 arrays.
      */
     auto numOfSSArrays = numCores;
     void *ssArrays = NULL;
-    auto ssSize = CACHE_LINE_SIZE;
+    auto ssSize = sequentialSegmentBytes;
     auto ssArraySize = ssSize * numOfsequentialSegments;
     if (numOfsequentialSegments > 0){
 
       /*
        * Allocate the sequential segment arrays.
        */
-      posix_memalign(&ssArrays, CACHE_LINE_SIZE, ssArraySize *  numOfSSArrays);
+      posix_memalign(&ssArrays, std::max<int64_t>(CACHE_LINE_SIZE, NOELLE_topology.getCacheLineBytes()), ssArraySize *  numOfSSArrays);
       if (ssArrays == NULL){
         fprintf(stderr, "HELIX: dispatcher: ERROR = not enough memory to allocate %lld sequential segment arrays\n", (long long)numCores);
         abort();
@@ -375,9 +3175,18 @@ extern "C" {
     mySSGlobal = ssArrays;
     #endif
 
+    /*
+     * Start the telemetry of the invocation.
+     */
+    NOELLE_InvocationTelemetry *telemetry = nullptr;
+    if (NOELLE_isInstrumented()){
+      telemetry = new NOELLE_InvocationTelemetry("HELIX", loopID, numCores, 1, numOfsequentialSegments);
+    }
+
     /*
      * Launch threads
      */
+    NOELLE_poolThreads.occupy(numCores);
     uint64_t loopIsOverFlag = 0;
     cpu_set_t cores;
     std::vector<MARC::TaskFuture<void>> localFutures;
@@ -405,22 +3214,37 @@ extern "C" {
       /*
        * Set the affinity for both the thread and its helper.
        */
-      CPU_ZERO(&cores);
-      auto physicalCore = i * 2;
-      CPU_SET(physicalCore, &cores);
-      CPU_SET(physicalCore + 1, &cores);
+      NOELLE_placement.getCores(i, cores, true);
 
       /*
        * Launch the thread.
        */
-      localFutures.push_back(pool.submitToCores(
-        cores,
-        parallelizedLoop,
-        env, loopCarriedArray,
-        ssArrayPast, ssArrayFuture,
-        i, numCores,
-        &loopIsOverFlag
-      ));
+      if (telemetry != nullptr){
+        auto thread = telemetry->getThread(i);
+        thread->sequentialSegments = (uint8_t *)ssArrayPast;
+        thread->futureSequentialSegments = (uint8_t *)ssArrayFuture;
+        thread->sequentialSegmentBytes = ssSize;
+        localFutures.push_back(pool.submitToCores(
+          cores,
+          NOELLE_runTaskWithTelemetry<void *, void *, void *, void *, int64_t, int64_t, uint64_t *>,
+          thread,
+          parallelizedLoop,
+          env, loopCarriedArray,
+          ssArrayPast, ssArrayFuture,
+          (int64_t)i, numCores,
+          &loopIsOverFlag
+        ));
+
+      } else {
+        localFutures.push_back(pool.submitToCores(
+          cores,
+          parallelizedLoop,
+          env, loopCarriedArray,
+          ssArrayPast, ssArrayFuture,
+          i, numCores,
+          &loopIsOverFlag
+        ));
+      }
 
       /*
        * Launch the helper thread.
@@ -431,6 +3255,7 @@ extern "C" {
         HELIX_helperThread, 
         ssArrayPast,
         numOfsequentialSegments,
+        ssSize,
         &loopIsOverFlag
       ));
     }
@@ -450,11 +3275,20 @@ extern "C" {
       fprintf(stderr, "Got future: %d\n", futureGotten++);
       #endif
     }
+    NOELLE_poolThreads.release(numCores);
 
     #ifdef RUNTIME_PRINT
     std::cerr << "Got all futures\n";
     #endif
 
+    /*
+     * Log the invocation.
+     */
+    if (telemetry != nullptr){
+      telemetry->end();
+      delete telemetry;
+    }
+
     /*
      * Free the memory.
      */
@@ -465,7 +3299,46 @@ extern "C" {
     return dispatcherInfo;
   }
 
-  void HELIX_wait (
+  /*
+   * Wait on a sequential segment that is not ready while measuring how long it takes.
+   */
+  static NOELLE_NOINLINE void HELIX_waitAndMeasure (
+    NOELLE_ThreadTelemetry *thread,
+    void *sequentialSegment
+    ){
+    auto ss = (pthread_spinlock_t *) sequentialSegment;
+
+    auto startTime = NOELLE_now();
+    pthread_spin_lock(ss);
+    auto endTime = NOELLE_now();
+    auto ssID = (((uint8_t *)sequentialSegment) - thread->sequentialSegments) / thread->sequentialSegmentBytes;
+    if (  true
+          && (((uint8_t *)sequentialSegment) >= thread->sequentialSegments)
+          && (ssID < thread->numberOfSequentialSegments)
+      ){
+      thread->waitTimes[ssID] += endTime - startTime;
+      if (NOELLE_trace.isEnabled()){
+        NOELLE_trace.complete("HELIX_wait", "sync", startTime, endTime, "segment", ssID);
+      }
+    }
+
+    return ;
+  }
+
+  /*
+   * Add a signal of a sequential segment to the timeline.
+   */
+  static NOELLE_NOINLINE void HELIX_traceSignal (
+    NOELLE_ThreadTelemetry *thread,
+    void *sequentialSegment
+    ){
+    auto ssID = (((uint8_t *)sequentialSegment) - thread->futureSequentialSegments) / thread->sequentialSegmentBytes;
+    NOELLE_trace.instant("HELIX_signal", "sync", "segment", ssID);
+
+    return ;
+  }
+
+  NOELLE_INLINE void HELIX_wait (
     void *sequentialSegment
     ){
 
@@ -482,7 +3355,17 @@ extern "C" {
     /*
      * Wait
      */
-    pthread_spin_lock(ss);
+    auto thread = NOELLE_currentThreadTelemetry;
+    if (thread == nullptr){
+      pthread_spin_lock(ss);
+
+    } else if (pthread_spin_trylock(ss) != 0){
+
+      /*
+       * The sequential segment is not ready: measure how long we wait for it.
+       */
+      HELIX_waitAndMeasure(thread, sequentialSegment);
+    }
 
     #ifdef RUNTIME_PRINT
     fprintf(stderr, "HelixDispatcher: Waited on sequential segment: %ld\n", (int *)sequentialSegment - (int *)mySSGlobal);
@@ -491,7 +3374,7 @@ extern "C" {
     return ;
   }
 
-  void HELIX_signal (
+  NOELLE_INLINE void HELIX_signal (
     void *sequentialSegment
     ){
 
@@ -509,6 +3392,13 @@ extern "C" {
      * Signal
      */
     pthread_spin_unlock(ss);
+    auto thread = NOELLE_currentThreadTelemetry;
+    if (  true
+          && (thread != nullptr)
+          && (NOELLE_trace.isEnabled())
+      ){
+      HELIX_traceSignal(thread, sequentialSegment);
+    }
 
     #ifdef RUNTIME_PRINT
     fprintf(stderr, "HelixDispatcher: Signaled on sequential segment: %ld\n", (int *)sequentialSegment - (int *)mySSGlobal);
@@ -546,7 +3436,7 @@ extern "C" {
     return ;
   }
 
-  DispatcherInfo  NOELLE_DSWPDispatcher (void *env, int64_t *queueSizes, void *stages, int64_t numberOfStages, int64_t numberOfQueues){
+  DispatcherInfo  NOELLE_DSWPDispatcher (void *env, int64_t *queueSizes, int64_t *queueConsumers, void *stages, int64_t numberOfStages, int64_t numberOfQueues, int64_t loopID){
     #ifdef RUNTIME_PRINT
     std::cerr << "Starting dispatcher: num stages " << numberOfStages << ", num queues: " << numberOfQueues << std::endl;
     #endif
@@ -556,25 +3446,44 @@ extern "C" {
      */
     void *localQueues[numberOfQueues];
     for (auto i = 0; i < numberOfQueues; ++i) {
+
+      /*
+       * Check if the queue delivers its values to several stages.
+       */
+      if (queueConsumers[i] > 1){
+        localQueues[i] = NOELLE_allocateBroadcastQueue((queueSizes[i] + 7) / 8, queueConsumers[i]);
+        continue ;
+      }
+
       switch (queueSizes[i]) {
         case 1:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int8_t>();
+          localQueues[i] = NOELLE_allocateQueue<int8_t>();
           break;
         case 8:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int8_t>();
+          localQueues[i] = NOELLE_allocateQueue<int8_t>();
           break;
         case 16:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int16_t>();
+          localQueues[i] = NOELLE_allocateQueue<int16_t>();
           break;
         case 32:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int32_t>();
+          localQueues[i] = NOELLE_allocateQueue<int32_t>();
           break;
         case 64:
-          localQueues[i] = new ThreadSafeLockFreeQueue<int64_t>();
+          localQueues[i] = NOELLE_allocateQueue<int64_t>();
           break;
         default:
-          std::cerr << "QUEUE SIZE INCORRECT!\n";
-          abort();
+
+          /*
+           * Entries that pack several values.
+           */
+          if (  false
+                || (queueSizes[i] <= 0)
+                || ((queueSizes[i] % 8) != 0)
+            ){
+            std::cerr << "QUEUE SIZE INCORRECT!\n";
+            abort();
+          }
+          localQueues[i] = NOELLE_allocateEntryQueue(queueSizes[i] / 8);
           break;
       }
     }
@@ -587,9 +3496,19 @@ extern "C" {
      */
     auto argsForAllCores = (NOELLE_DSWP_args_t *) malloc(sizeof(NOELLE_DSWP_args_t) * numberOfStages);
 
+    /*
+     * Start the telemetry of the invocation.
+     */
+    NOELLE_InvocationTelemetry *telemetry = nullptr;
+    if (NOELLE_isInstrumented()){
+      telemetry = new NOELLE_InvocationTelemetry("DSWP", loopID, numberOfStages, 1, 0);
+    }
+
     /*
      * Submit DSWP tasks
      */
+    NOELLE_poolThreads.occupy(numberOfStages);
+    cpu_set_t cores;
     std::vector<MARC::TaskFuture<void>> localFutures;
     auto allStages = (void **)stages;
     for (auto i = 0; i < numberOfStages; ++i) {
@@ -605,7 +3524,19 @@ extern "C" {
       /*
        * Submit
        */
-      localFutures.push_back(pool.submit(NOELLE_DSWPTrampoline, argsPerCore));
+      auto isPinned = NOELLE_placement.getCores(i, cores, false);
+      if (  true
+            && (telemetry != nullptr)
+            && isPinned
+        ){
+        localFutures.push_back(pool.submitToCores(cores, NOELLE_runTaskWithTelemetry<void *>, telemetry->getThread(i), NOELLE_DSWPTrampoline, (void *)argsPerCore));
+      } else if (telemetry != nullptr){
+        localFutures.push_back(pool.submit(NOELLE_runTaskWithTelemetry<void *>, telemetry->getThread(i), NOELLE_DSWPTrampoline, (void *)argsPerCore));
+      } else if (isPinned){
+        localFutures.push_back(pool.submitToCores(cores, NOELLE_DSWPTrampoline, argsPerCore));
+      } else {
+        localFutures.push_back(pool.submit(NOELLE_DSWPTrampoline, argsPerCore));
+      }
       #ifdef RUNTIME_PRINT
       std::cerr << "Submitted stage" << std::endl;
       #endif
@@ -620,29 +3551,46 @@ extern "C" {
     for (auto& future : localFutures){
       future.get();
     }
+    NOELLE_poolThreads.release(numberOfStages);
     #ifdef RUNTIME_PRINT
     std::cerr << "Got all futures" << std::endl;
     #endif
 
+    /*
+     * Log the invocation.
+     */
+    if (telemetry != nullptr){
+      telemetry->end();
+      delete telemetry;
+    }
+
     /*
      * Free the memory.
      */
     for (int i = 0; i < numberOfQueues; ++i) {
+      if (queueConsumers[i] > 1){
+        NOELLE_freeBroadcastQueue(localQueues[i]);
+        continue ;
+      }
+
       switch (queueSizes[i]) {
         case 1:
-          delete (ThreadSafeLockFreeQueue<int8_t> *)(localQueues[i]);
+          NOELLE_freeQueue<int8_t>(localQueues[i]);
           break;
         case 8:
-          delete (ThreadSafeLockFreeQueue<int8_t> *)(localQueues[i]);
+          NOELLE_freeQueue<int8_t>(localQueues[i]);
           break;
         case 16:
-          delete (ThreadSafeLockFreeQueue<int16_t> *)(localQueues[i]);
+          NOELLE_freeQueue<int16_t>(localQueues[i]);
           break;
         case 32:
-          delete (ThreadSafeLockFreeQueue<int32_t> *)(localQueues[i]);
+          NOELLE_freeQueue<int32_t>(localQueues[i]);
           break;
         case 64:
-          delete (ThreadSafeLockFreeQueue<int64_t> *)(localQueues[i]);
+          NOELLE_freeQueue<int64_t>(localQueues[i]);
+          break;
+        default:
+          NOELLE_freeEntryQueue(localQueues[i]);
           break;
       }
     }
@@ -660,4 +3608,62 @@ extern "C" {
     return dispatcherInfo;
   }
 
+  /**********************************************************************
+   *                DEPENDENCE PROFILER
+   **********************************************************************/
+  void NOELLE_DependenceProfilerInvocation (
+    int64_t loopIndex
+    ){
+    NOELLE_dependenceProfiler.startInvocation(loopIndex);
+
+    return ;
+  }
+
+  void NOELLE_DependenceProfilerIteration (
+    int64_t loopIndex
+    ){
+    NOELLE_dependenceProfiler.startIteration(loopIndex);
+
+    return ;
+  }
+
+  void NOELLE_DependenceProfilerAccess (
+    int64_t loopIndex,
+    int64_t instructionID,
+    void *address,
+    int64_t size,
+    int64_t isWrite
+    ){
+    NOELLE_dependenceProfiler.access(loopIndex, instructionID, address, size, isWrite != 0);
+
+    return ;
+  }
+
+  /**********************************************************************
+   *                LOOP PROFILER
+   **********************************************************************/
+  void NOELLE_LoopProfilerInvocationStart (
+    int64_t loopID
+    ){
+    NOELLE_loopProfiler.startInvocation(loopID);
+
+    return ;
+  }
+
+  void NOELLE_LoopProfilerIteration (
+    int64_t loopID
+    ){
+    NOELLE_loopProfiler.startIteration(loopID);
+
+    return ;
+  }
+
+  void NOELLE_LoopProfilerInvocationEnd (
+    int64_t loopID
+    ){
+    NOELLE_loopProfiler.endInvocation(loopID);
+
+    return ;
+  }
+
 }
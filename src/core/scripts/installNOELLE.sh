@@ -35,13 +35,18 @@ patchInstallDir "noelle-pdg" ;
 patchInstallDir "noelle-meta-clean" ;
 patchInstallDir "noelle-meta-pdg-clean " ;
 patchInstallDir "noelle-meta-loop-embed" ;
+patchInstallDir "noelle-meta-parallel-embed" ;
 patchInstallDir "noelle-meta-pdg-embed" ;
 patchInstallDir "noelle-meta-prof-embed" ;
+patchInstallDir "noelle-meta-dep-prof-embed" ;
+patchInstallDir "noelle-meta-loop-prof-embed" ;
 patchInstallDir "noelle-pdg-stats" ;
 patchInstallDir "noelle-loop-stats" ;
 patchInstallDir "noelle-enable" ;
 patchInstallDir "noelle-deadcode" ;
 patchInstallDir "noelle-prof-coverage" ;
+patchInstallDir "noelle-prof-dependences" ;
+patchInstallDir "noelle-prof-loops" ;
 patchInstallDir "noelle-config" ;
 patchInstallDir "noelle-simplification" ;
 patchInstallDir "loopaa" ;
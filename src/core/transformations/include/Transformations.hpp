@@ -24,6 +24,7 @@ namespace llvm {
     LOOP_DISTRIBUTION_ID,
     LOOP_INVARIANT_CODE_MOTION_ID,
     LOOP_WHILIFIER_ID,
+    LOOP_COLLAPSE_ID,
     SCEV_SIMPLIFICATION_ID,
     DEVIRTUALIZER_ID,
 
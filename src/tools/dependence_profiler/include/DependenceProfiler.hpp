@@ -0,0 +1,48 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "Noelle.hpp"
+
+using namespace llvm;
+
+namespace llvm {
+
+  /*
+   * Profiler of the may memory dependences of the hot loops.
+   *
+   * Without options, it injects the code that records which of these dependences manifest within the invocations of their loops at run time (see noelle-prof-dependences).
+   * With -noelle-dep-prof-embed=FILE, it marks as removable the embedded PDG edges that were profiled but never manifested (see noelle-meta-dep-prof-embed).
+   *
+   * Loads and stores are identified by the IDs of their embedded PDG nodes, so the PDG must be embedded first.
+   */
+  struct DependenceProfiler : public ModulePass {
+    public:
+      static char ID;
+
+      DependenceProfiler();
+      virtual ~DependenceProfiler();
+
+      bool doInitialization(Module &M) override;
+      void getAnalysisUsage(AnalysisUsage &AU) const override;
+      bool runOnModule(Module &M) override;
+
+    private:
+      bool instrumentLoops (Noelle &noelle, Module &M);
+
+      bool embedProfile (Module &M, std::string const &profileFileName);
+
+      std::set<Instruction *> getProfiledInstructions (LoopDependenceInfo *LDI) const ;
+
+      static int64_t getInstructionID (Instruction *inst) ;
+  };
+
+}
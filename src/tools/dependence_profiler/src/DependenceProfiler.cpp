@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "DependenceProfiler.hpp"
+
+using namespace llvm;
+
+DependenceProfiler::DependenceProfiler()
+  : ModulePass{ID} {
+  return;
+}
+
+DependenceProfiler::~DependenceProfiler() {
+  return;
+}
+
+int64_t DependenceProfiler::getInstructionID (Instruction *inst) {
+
+  /*
+   * Fetch the ID of the PDG node of the instruction.
+   */
+  auto m = inst->getMetadata("noelle.pdg.inst.id");
+  if (m == nullptr){
+    return -1;
+  }
+
+  return cast<ConstantInt>(cast<ConstantAsMetadata>(m->getOperand(0))->getValue())->getSExtValue();
+}
+
+std::set<Instruction *> DependenceProfiler::getProfiledInstructions (LoopDependenceInfo *LDI) const {
+  std::set<Instruction *> insts;
+
+  /*
+   * Collect the loads and stores of the loop connected by may memory dependences.
+   */
+  auto loopStructure = LDI->getLoopStructure();
+  auto loopDG = LDI->getLoopDG();
+  for (auto edge : loopDG->getEdges()){
+    if (  false
+          || !edge->isMemoryDependence()
+          || edge->isMustDependence()
+      ){
+      continue ;
+    }
+
+    auto fromInst = dyn_cast<Instruction>(edge->getOutgoingT());
+    auto toInst = dyn_cast<Instruction>(edge->getIncomingT());
+    if (  false
+          || (fromInst == nullptr)
+          || (toInst == nullptr)
+          || !loopStructure->isIncluded(fromInst)
+          || !loopStructure->isIncluded(toInst)
+          || (!isa<LoadInst>(fromInst) && !isa<StoreInst>(fromInst))
+          || (!isa<LoadInst>(toInst) && !isa<StoreInst>(toInst))
+          || (getInstructionID(fromInst) == -1)
+          || (getInstructionID(toInst) == -1)
+      ){
+      continue ;
+    }
+    insts.insert(fromInst);
+    insts.insert(toInst);
+  }
+
+  return insts;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "DependenceProfiler.hpp"
+#include <fstream>
+
+using namespace llvm;
+
+static cl::opt<bool> PrintNeverManifested("noelle-dep-prof-embed-verbose", cl::ZeroOrMore, cl::Hidden, cl::desc("Print the profiled may memory dependences that never manifested"));
+
+static int64_t getNodeID (const MDOperand &operand) {
+  auto m = cast<MDNode>(operand);
+  return cast<ConstantInt>(cast<ConstantAsMetadata>(m->getOperand(0))->getValue())->getSExtValue();
+}
+
+bool DependenceProfiler::embedProfile (Module &M, std::string const &profileFileName) {
+  errs() << "DependenceProfiler: Embed the profile " << profileFileName << "\n";
+
+  /*
+   * Check that the PDG has been embedded.
+   */
+  if (M.getNamedMetadata("noelle.module.pdg") == nullptr){
+    errs() << "DependenceProfiler: ERROR = the PDG has not been embedded\n";
+    abort();
+  }
+
+  /*
+   * Load the profile.
+   */
+  std::ifstream profileFile(profileFileName);
+  if (!profileFile.is_open()){
+    errs() << "DependenceProfiler: ERROR = cannot open " << profileFileName << "\n";
+    abort();
+  }
+  std::map<int64_t, std::set<int64_t>> loopsOfInstructions;
+  std::set<std::pair<int64_t, int64_t>> manifested;
+  std::string kind;
+  while (profileFile >> kind){
+    int64_t first, second;
+    profileFile >> first >> second;
+    if (kind == "executed"){
+      loopsOfInstructions[second].insert(first);
+    } else if (kind == "manifested"){
+      manifested.insert(std::make_pair(first, second));
+    }
+  }
+
+  /*
+   * A dependence has been profiled if both its instructions ran in the same profiled loop.
+   */
+  auto isProfiled = [&loopsOfInstructions](int64_t fromID, int64_t toID) -> bool {
+    auto fromIt = loopsOfInstructions.find(fromID);
+    auto toIt = loopsOfInstructions.find(toID);
+    if (  false
+          || (fromIt == loopsOfInstructions.end())
+          || (toIt == loopsOfInstructions.end())
+      ){
+      return false;
+    }
+    for (auto loop : fromIt->second){
+      if (toIt->second.find(loop) != toIt->second.end()){
+        return true;
+      }
+    }
+    return false;
+  };
+
+  /*
+   * Mark as removable the may memory dependences that have been profiled and that never manifested (neither between iterations nor within one).
+   */
+  auto &C = M.getContext();
+  auto trueMetadata = MDNode::get(C, MDString::get(C, "true"));
+  uint64_t profiledDependences = 0;
+  uint64_t removableDependences = 0;
+  for (auto &F : M){
+    auto edgesM = F.getMetadata("noelle.pdg.edges");
+    if (edgesM == nullptr){
+      continue ;
+    }
+
+    std::unordered_map<int64_t, Instruction *> instructionsByID;
+    for (auto &I : instructions(F)){
+      auto id = getInstructionID(&I);
+      if (id != -1){
+        instructionsByID[id] = &I;
+      }
+    }
+
+    std::vector<Metadata *> newEdges;
+    for (auto &operand : edgesM->operands()){
+      auto edgeM = cast<MDNode>(operand);
+      auto isMemory = cast<MDString>(cast<MDNode>(edgeM->getOperand(2))->getOperand(0))->getString() == "true";
+      auto isMust = cast<MDString>(cast<MDNode>(edgeM->getOperand(3))->getOperand(0))->getString() == "true";
+      auto fromID = getNodeID(edgeM->getOperand(0));
+      auto toID = getNodeID(edgeM->getOperand(1));
+      if (  false
+            || !isMemory
+            || isMust
+            || !isProfiled(fromID, toID)
+        ){
+        newEdges.push_back(edgeM);
+        continue ;
+      }
+      profiledDependences++;
+      if (manifested.find(std::make_pair(fromID, toID)) != manifested.end()){
+        newEdges.push_back(edgeM);
+        continue ;
+      }
+
+      /*
+       * The dependence never manifested.
+       */
+      removableDependences++;
+      if (PrintNeverManifested) {
+        errs() << "DependenceProfiler:   Never manifested: " << *instructionsByID[fromID] << " ---> " << *instructionsByID[toID] << "\n";
+      }
+      std::vector<Metadata *> newEdge(edgeM->op_begin(), edgeM->op_end());
+      newEdge[7] = trueMetadata;
+      newEdges.push_back(MDNode::get(C, newEdge));
+    }
+    F.setMetadata("noelle.pdg.edges", MDTuple::get(C, newEdges));
+  }
+  errs() << "DependenceProfiler:   " << removableDependences << " out of " << profiledDependences << " profiled may memory dependences never manifested\n";
+
+  /*
+   * Let the parallelization techniques know that removable dependences come from a profile.
+   */
+  auto n = M.getOrInsertNamedMetadata("noelle.module.dependence_profile");
+  if (n->getNumOperands() == 0){
+    n->addOperand(trueMetadata);
+  }
+
+  return true;
+}
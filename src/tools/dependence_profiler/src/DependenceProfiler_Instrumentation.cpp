@@ -0,0 +1,113 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "DependenceProfiler.hpp"
+
+using namespace llvm;
+
+bool DependenceProfiler::instrumentLoops (Noelle &noelle, Module &M) {
+  if (noelle.getVerbosity() > Verbosity::Disabled) {
+    errs() << "DependenceProfiler: Start instrumenting\n";
+  }
+
+  /*
+   * Fetch the runtime.
+   */
+  auto invocationFunction = M.getFunction("NOELLE_DependenceProfilerInvocation");
+  auto iterationFunction = M.getFunction("NOELLE_DependenceProfilerIteration");
+  auto accessFunction = M.getFunction("NOELLE_DependenceProfilerAccess");
+  if (  false
+        || (invocationFunction == nullptr)
+        || (iterationFunction == nullptr)
+        || (accessFunction == nullptr)
+    ){
+    errs() << "DependenceProfiler: ERROR = the NOELLE runtime has not been linked\n";
+    abort();
+  }
+
+  /*
+   * Fetch the hot loops.
+   */
+  auto loops = noelle.getLoops();
+  auto &DL = M.getDataLayout();
+  auto int64 = Type::getInt64Ty(M.getContext());
+  auto int8Ptr = Type::getInt8PtrTy(M.getContext());
+
+  /*
+   * Instrument the loops.
+   */
+  auto modified = false;
+  int64_t loopIndex = 0;
+  for (auto LDI : *loops){
+
+    /*
+     * Fetch the instructions to profile.
+     */
+    auto insts = this->getProfiledInstructions(LDI);
+    if (insts.size() == 0){
+      continue ;
+    }
+    auto loopStructure = LDI->getLoopStructure();
+    if (noelle.getVerbosity() > Verbosity::Disabled) {
+      errs() << "DependenceProfiler:   Loop " << loopStructure->getID() << " (index " << loopIndex << ") with " << insts.size() << " loads and stores\n";
+    }
+    auto loopIndexValue = ConstantInt::get(int64, loopIndex);
+
+    /*
+     * Mark the beginning of the invocations and of the iterations.
+     */
+    IRBuilder<> preheaderBuilder(loopStructure->getPreHeader()->getTerminator());
+    preheaderBuilder.CreateCall(invocationFunction, ArrayRef<Value *>({ loopIndexValue }));
+    IRBuilder<> headerBuilder(&*loopStructure->getHeader()->getFirstInsertionPt());
+    headerBuilder.CreateCall(iterationFunction, ArrayRef<Value *>({ loopIndexValue }));
+
+    /*
+     * Record the accesses.
+     */
+    for (auto inst : insts){
+      Value *pointer;
+      Type *accessedType;
+      int64_t isWrite;
+      if (auto load = dyn_cast<LoadInst>(inst)){
+        pointer = load->getPointerOperand();
+        accessedType = load->getType();
+        isWrite = 0;
+      } else {
+        auto store = cast<StoreInst>(inst);
+        pointer = store->getPointerOperand();
+        accessedType = store->getValueOperand()->getType();
+        isWrite = 1;
+      }
+
+      IRBuilder<> builder(inst);
+      builder.CreateCall(accessFunction, ArrayRef<Value *>({
+        loopIndexValue,
+        ConstantInt::get(int64, getInstructionID(inst)),
+        builder.CreateBitCast(pointer, int8Ptr),
+        ConstantInt::get(int64, DL.getTypeStoreSize(accessedType)),
+        ConstantInt::get(int64, isWrite)
+      }));
+    }
+
+    loopIndex++;
+    modified = true;
+  }
+
+  /*
+   * Free the memory.
+   */
+  delete loops;
+
+  if (noelle.getVerbosity() > Verbosity::Disabled) {
+    errs() << "DependenceProfiler: Exit\n";
+  }
+
+  return modified;
+}
@@ -47,6 +47,12 @@ namespace llvm::noelle {
         Heuristics *h
       ) const override ;
 
+      double estimateParallelExecutionTime (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        Heuristics *h
+      ) const override ;
+
 
     protected:
 
@@ -59,6 +65,66 @@ namespace llvm::noelle {
       void addChunkFunctionExecutionAsideOriginalLoop (
         LoopDependenceInfo *LDI,
         Function *loopFunction,
+        Noelle &par,
+        Value *numberOfIterations
+      );
+
+      bool canDistributeIterationsInBlocks (
+        LoopDependenceInfo *LDI,
+        Value *numberOfIterations
+      ) const ;
+
+      std::set<Instruction *> getRepeatableHeaderInstructions (
+        LoopDependenceInfo *LDI
+      ) const ;
+
+      Value * generateCodeToChooseTheNumberOfCores (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        Value *numberOfIterations
+      );
+
+      Value * generateCodeToComputeTheNumberOfIterations (
+        LoopDependenceInfo *LDI,
+        Noelle &par
+      );
+
+      /*
+       * Run-time checks of aliasing
+       */
+      bool canCheckAtRunTimeThatMemoryAccessesAreDisjoint (
+        LoopDependenceInfo *LDI,
+        Instruction *from,
+        Instruction *to
+      ) const ;
+
+      std::set<std::pair<Instruction *, Instruction *>> getMemoryDependencesToCheckAtRunTime (
+        LoopDependenceInfo *LDI
+      ) const ;
+
+      Value * generateCodeToCheckThatMemoryAccessesAreDisjoint (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        Value *numberOfIterations
+      );
+
+      /*
+       * Speculation
+       */
+      bool canSpeculateLoop (
+        LoopDependenceInfo *LDI
+      ) const ;
+
+      bool canSpeculateMemoryDependence (
+        DGEdge<Value> *dep
+      ) const ;
+
+      bool isSpeculationRequired (
+        LoopDependenceInfo *LDI
+      ) const ;
+
+      void speculateMemoryAccessesInTask (
+        LoopDependenceInfo *LDI,
         Noelle &par
       );
 
@@ -66,6 +132,15 @@ namespace llvm::noelle {
        * Helpers
        */
       Value *fetchClone(Value *original) const ;
+
+    private:
+      Function *coresChooser;
+      Function *aliasChecksCounter;
+      Function *speculativeTaskDispatcher;
+      Function *speculativeLoad;
+      Function *speculativeStore;
+      bool areDependencesProfiled;
+      bool distributesIterationsInBlocks;
   };
 
 }
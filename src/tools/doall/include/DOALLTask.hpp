@@ -42,6 +42,11 @@ namespace llvm::noelle {
       BranchInst *cloneOfOriginalBr;
       PHINode *outermostLoopIV;
 
+      /*
+       * Calls to the runtime that perform the loads and stores of a speculative task
+       */
+      std::set<CallInst *> speculativeAccesses;
+
       void extractFuncArgs () override ;
   };
 }
@@ -40,9 +40,27 @@ void DOALL::rewireLoopToIterateChunks (
 
   /*
    * Generate PHI to track progress on the current chunk
+   *
+   * With a block distribution, each core runs a single chunk (its block), so the PHI simply counts the iterations executed by the core.
    */
   auto chunkCounterType = task->chunkSizeArg->getType();
-  auto chunkPHI = IVUtility::createChunkPHI(preheaderClone, headerClone, chunkCounterType, task->chunkSizeArg);
+  PHINode *chunkPHI = nullptr;
+  if (this->distributesIterationsInBlocks) {
+    std::vector<BasicBlock *> headerPreds(pred_begin(headerClone), pred_end(headerClone));
+    IRBuilder<> headerBuilder(headerClone->getFirstNonPHIOrDbgOrLifetime());
+    chunkPHI = headerBuilder.CreatePHI(chunkCounterType, headerPreds.size(), "blockIteration");
+    for (auto B : headerPreds) {
+      if (B == preheaderClone) {
+        chunkPHI->addIncoming(ConstantInt::get(chunkCounterType, 0), B);
+        continue ;
+      }
+      IRBuilder<> latchBuilder(B->getTerminator());
+      chunkPHI->addIncoming(latchBuilder.CreateAdd(chunkPHI, ConstantInt::get(chunkCounterType, 1)), B);
+    }
+
+  } else {
+    chunkPHI = IVUtility::createChunkPHI(preheaderClone, headerClone, chunkCounterType, task->chunkSizeArg);
+  }
 
   /*
    * Collect clones of step size deriving values for all induction variables
@@ -76,8 +94,13 @@ void DOALL::rewireLoopToIterateChunks (
    * Determine additional step size from the beginning of the next core's chunk
    * to the start of this core's next chunk
    * chunk_step_size: original_step_size * (num_cores - 1) * chunk_size
+   *
+   * With a block distribution there is no next chunk, so induction variables keep their original step and stay affine.
    */
   for (auto ivInfo : allIVInfo->getInductionVariables(*loopSummary)) {
+    if (this->distributesIterationsInBlocks) {
+      break ;
+    }
     auto stepOfIV = clonedStepSizeMap.at(ivInfo);
     auto ivPHI = cast<PHINode>(fetchClone(ivInfo->getLoopEntryPHI()));
 
@@ -108,6 +131,19 @@ void DOALL::rewireLoopToIterateChunks (
   ivUtility.updateConditionAndBranchToCatchIteratingPastExitValue(cmpInst, brInst, task->getLastBlock(0));
   auto updatedCmpInst = cmpInst;
 
+  /*
+   * With a block distribution, the loop also exits at the end of the block of the core.
+   * The header stays the only exiting block, so the loop of the task is a counted loop that can be vectorized.
+   */
+  Instruction *isBlockCompleted = nullptr;
+  Instruction *exitCondition = nullptr;
+  if (this->distributesIterationsInBlocks) {
+    IRBuilder<> headerBuilder(brInst);
+    isBlockCompleted = cast<Instruction>(headerBuilder.CreateICmpUGE(chunkPHI, task->chunkSizeArg, "isBlockCompleted"));
+    exitCondition = cast<Instruction>(headerBuilder.CreateOr(cmpInst, isBlockCompleted));
+    brInst->setCondition(exitCondition);
+  }
+
   /*
    * The exit condition value does not need to be computed each iteration
    * and so the value's derivation can be hoisted into the preheader
@@ -156,66 +192,19 @@ void DOALL::rewireLoopToIterateChunks (
 
   /*
 	 * Identify any instructions in the header that are NOT sensitive to the number of times they execute:
-	 * 1) IV instructions, including the comparison and branch of the loop governing IV
-	 * 2) The PHI used to chunk iterations 
-	 * 3) Any PHIs of reducible variables
-	 * 4) Any loop invariant instructions that belong to independent-execution SCCs
+	 * 1) The instructions of the original header that are repeatable (see getRepeatableHeaderInstructions)
+	 * 2) The PHI used to chunk iterations, and the check of the end of the block of the core
    */
   std::set<Instruction *> repeatableInstructions;
-
-	/*
-	 * Collect (1) by iterating the InductionVariableManager
-	 */
-  auto sccdag = LDI->sccdagAttrs.getSCCDAG();
-  for (auto ivInfo : allIVInfo->getInductionVariables(*loopSummary)) {
-    for (auto I : ivInfo->getAllInstructions()) {
-      repeatableInstructions.insert(task->getCloneOfOriginalInstruction(I));
-    }
+  for (auto I : this->getRepeatableHeaderInstructions(LDI)) {
+    repeatableInstructions.insert(task->getCloneOfOriginalInstruction(I));
   }
-  repeatableInstructions.insert(cmpInst);
-  repeatableInstructions.insert(brInst);
-
-	/*
-	 * Collect (2)
-	 */
   repeatableInstructions.insert(chunkPHI);
-
-	/*
-	 * Collect (3) by identifying all reducible SCCs
-	 */
-  auto nonDOALLSCCs = LDI->sccdagAttrs.getSCCsWithLoopCarriedDataDependencies();
-  for (auto scc : nonDOALLSCCs) {
-    auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
-    if (!sccInfo->canExecuteReducibly()) continue;
-
-    // HACK:
-    for (auto nodePair : scc->internalNodePairs()) {
-      auto value = nodePair.first;
-      auto inst = cast<Instruction>(value);
-      if (inst->getParent() != loopHeader) continue;
-
-      auto instClone = task->getCloneOfOriginalInstruction(inst);
-      repeatableInstructions.insert(instClone);
-    }
-
-    // assert(sccInfo->getSingleHeaderPHI());
-    // repeatableInstructions.insert(task->getCloneOfOriginalInstruction(sccInfo->getSingleHeaderPHI()));
+  if (this->distributesIterationsInBlocks) {
+    repeatableInstructions.insert(isBlockCompleted);
+    repeatableInstructions.insert(exitCondition);
   }
 
-	/*
-	 * Collect (4) by identifying header instructions belonging to independent SCCs that are loop invariant
-	 */
-  for (auto &I : *loopHeader) {
-		auto scc = sccdag->sccOfValue(&I);
-    auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
-		if (!sccInfo->canExecuteIndependently()) continue;
-
-    auto isInvariant = invariantManager->isLoopInvariant(&I);
-    if (!isInvariant) continue;
-
-		repeatableInstructions.insert(task->getCloneOfOriginalInstruction(&I));
-	}
-
   bool requiresConditionBeforeEnteringHeader = false;
   for (auto &I : *headerClone) {
     if (repeatableInstructions.find(&I) == repeatableInstructions.end()) {
@@ -223,6 +212,8 @@ void DOALL::rewireLoopToIterateChunks (
       break;
     }
   }
+  assert(!(requiresConditionBeforeEnteringHeader && this->distributesIterationsInBlocks)
+    && "DOALL: iterations can be distributed in blocks only if the header is repeatable");
 
   if (requiresConditionBeforeEnteringHeader) {
     auto &loopGoverningIV = loopGoverningIVAttr->getInductionVariable();
@@ -271,3 +262,67 @@ void DOALL::rewireLoopToIterateChunks (
     );
   }
 }
+
+std::set<Instruction *> DOALL::getRepeatableHeaderInstructions (
+  LoopDependenceInfo *LDI
+  ) const {
+  auto loopSummary = LDI->getLoopStructure();
+  auto loopHeader = loopSummary->getHeader();
+  auto invariantManager = LDI->getInvariantManager();
+  auto allIVInfo = LDI->getInductionVariableManager();
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+
+  /*
+	 * Identify any instructions in the header that are NOT sensitive to the number of times they execute:
+	 * 1) IV instructions, including the comparison and branch of the loop governing IV
+	 * 2) Any PHIs of reducible variables
+	 * 3) Any loop invariant instructions that belong to independent-execution SCCs
+   */
+  std::set<Instruction *> repeatableInstructions;
+
+	/*
+	 * Collect (1) by iterating the InductionVariableManager
+	 */
+  auto sccdag = LDI->sccdagAttrs.getSCCDAG();
+  for (auto ivInfo : allIVInfo->getInductionVariables(*loopSummary)) {
+    for (auto I : ivInfo->getAllInstructions()) {
+      repeatableInstructions.insert(I);
+    }
+  }
+  repeatableInstructions.insert(loopGoverningIVAttr->getHeaderCmpInst());
+  repeatableInstructions.insert(loopGoverningIVAttr->getHeaderBrInst());
+
+	/*
+	 * Collect (2) by identifying all reducible SCCs
+	 */
+  auto nonDOALLSCCs = LDI->sccdagAttrs.getSCCsWithLoopCarriedDataDependencies();
+  for (auto scc : nonDOALLSCCs) {
+    auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
+    if (!sccInfo->canExecuteReducibly()) continue;
+
+    // HACK:
+    for (auto nodePair : scc->internalNodePairs()) {
+      auto value = nodePair.first;
+      auto inst = cast<Instruction>(value);
+      if (inst->getParent() != loopHeader) continue;
+
+      repeatableInstructions.insert(inst);
+    }
+  }
+
+	/*
+	 * Collect (3) by identifying header instructions belonging to independent SCCs that are loop invariant
+	 */
+  for (auto &I : *loopHeader) {
+		auto scc = sccdag->sccOfValue(&I);
+    auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
+		if (!sccInfo->canExecuteIndependently()) continue;
+
+    auto isInvariant = invariantManager->isLoopInvariant(&I);
+    if (!isInvariant) continue;
+
+		repeatableInstructions.insert(&I);
+	}
+
+  return repeatableInstructions;
+}
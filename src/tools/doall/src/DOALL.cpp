@@ -11,12 +11,16 @@
 #include "DOALL.hpp"
 #include "DOALLTask.hpp"
 
+static cl::opt<bool> DisableBlockDistribution("noelle-doall-disable-block-distribution", cl::ZeroOrMore, cl::Hidden, cl::desc("Distribute the iterations of every DOALL loop in chunks assigned to cores round-robin rather than in one contiguous block per core"));
+static cl::opt<bool> SpeculateDOALL("noelle-doall-speculate", cl::ZeroOrMore, cl::Hidden, cl::desc("Parallelize with DOALL the loops that have only may memory dependences left by validating them at run time"));
+
 DOALL::DOALL (
   Module &module,
   Hot &p,
   Verbosity v
 ) :
-  ParallelizationTechnique{module, p, v}
+  ParallelizationTechnique{module, p, v},
+  distributesIterationsInBlocks{false}
   {
 
   /*
@@ -28,6 +32,44 @@ DOALL::DOALL (
     abort();
   }
 
+  /*
+   * Fetch the function that chooses, for each invocation of a DOALL loop, how many cores to use.
+   */
+  this->coresChooser = this->module.getFunction("NOELLE_DOALLChooseNumberOfCores");
+  if (this->coresChooser == nullptr){
+    errs() << "NOELLE: ERROR = function NOELLE_DOALLChooseNumberOfCores couldn't be found\n";
+    abort();
+  }
+
+  /*
+   * Fetch the function that counts, for each DOALL loop guarded by run-time checks of aliasing, how many times these checks pass and fail.
+   */
+  this->aliasChecksCounter = this->module.getFunction("NOELLE_DOALLCountAliasCheck");
+  if (this->aliasChecksCounter == nullptr){
+    errs() << "NOELLE: ERROR = function NOELLE_DOALLCountAliasCheck couldn't be found\n";
+    abort();
+  }
+
+  /*
+   * Fetch the functions used by speculative DOALL loops.
+   */
+  this->speculativeTaskDispatcher = this->module.getFunction("NOELLE_DOALLSpeculativeDispatcher");
+  this->speculativeLoad = this->module.getFunction("NOELLE_DOALLSpeculativeLoad");
+  this->speculativeStore = this->module.getFunction("NOELLE_DOALLSpeculativeStore");
+  if (  false
+        || (this->speculativeTaskDispatcher == nullptr)
+        || (this->speculativeLoad == nullptr)
+        || (this->speculativeStore == nullptr)
+    ){
+    errs() << "NOELLE: ERROR = functions of speculative DOALL couldn't be found\n";
+    abort();
+  }
+
+  /*
+   * Check if the may memory dependences have been profiled (see noelle-prof-dependences).
+   */
+  this->areDependencesProfiled = (this->module.getNamedMetadata("noelle.module.dependence_profile") != nullptr);
+
   /*
    * Define the signature of the task, which will be invoked by the DOALL dispatcher.
    */
@@ -101,60 +143,26 @@ bool DOALL::canBeAppliedToLoop (
   }
 
   /*
-   * The compiler must be able to remove loop-carried data dependences of all SCCs with loop-carried data dependences.
+   * Check if the loop can run speculatively.
    */
-  auto nonDOALLSCCs = LDI->sccdagAttrs.getSCCsWithLoopCarriedDataDependencies();
-  for (auto scc : nonDOALLSCCs) {
-
-    /*
-     * Fetch the SCC metadata.
-     */
-    auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
-
-    /*
-     * If the SCC is reducable, then it does not block the loop to be a DOALL.
-     */
-    if (sccInfo->canExecuteReducibly()){
-      continue ;
-    }
-
-    /*
-     * If the SCC can be cloned, then it does not block the loop to be a DOALL.
-     */
-    if (sccInfo->canBeCloned()){
-      continue ;
-    }
-
-    /*
-     * If all loop carried data dependencies within the SCC do not overlap between
-     * iterations, then DOALL can ignore them
-     */
-    auto areAllDataLCDsFromDisjointMemoryAccesses = true;
-    auto domainSpaceAnalysis = LDI->getLoopIterationDomainSpaceAnalysis();
-    LDI->sccdagAttrs.iterateOverLoopCarriedDataDependences(scc, [
-      &areAllDataLCDsFromDisjointMemoryAccesses, domainSpaceAnalysis
-    ](DGEdge<Value> *dep) -> bool {
-      if (dep->isControlDependence()) return false;
-
-      if (!dep->isMemoryDependence()) {
-        areAllDataLCDsFromDisjointMemoryAccesses = false;
-        return true;
-      }
-
-      auto fromInst = dyn_cast<Instruction>(dep->getOutgoingT());
-      auto toInst = dyn_cast<Instruction>(dep->getIncomingT());
-      areAllDataLCDsFromDisjointMemoryAccesses &= fromInst && toInst && domainSpaceAnalysis->
-        areInstructionsAccessingDisjointMemoryLocationsBetweenIterations(fromInst, toInst);
-      return !areAllDataLCDsFromDisjointMemoryAccesses;
-    });
-    if (areAllDataLCDsFromDisjointMemoryAccesses) {
-      // if (this->verbose >= Verbosity::Maximal) {
-      //   scc->printMinimal(errs() << "SCC has memory LCDs that are disjoint between iterations!\n"); errs() << "\n";
-      // }
-      continue;
-    }
+  auto isSpeculationAllowed = SpeculateDOALL && this->canSpeculateLoop(LDI);
 
+  /*
+   * The compiler must be able to remove loop-carried data dependences of all SCCs with loop-carried data dependences.
+   * Reducible and clonable SCCs, and memory dependences between accesses that do not overlap between iterations, do not block the loop to be a DOALL.
+   * Memory dependences that the compiler cannot disprove are ignored as well if the run-time can check that the accesses are disjoint.
+   * In this case, the parallelized loop runs only when the check passes.
+   *
+   * Finally, may memory dependences are ignored if the loop can run speculatively.
+   */
+  auto scc = LDI->getSCCBlockingParallelization([this, LDI, isSpeculationAllowed](Instruction *fromInst, Instruction *toInst, DGEdge<Value> *dep) -> bool {
+    return false
+           || this->canCheckAtRunTimeThatMemoryAccessesAreDisjoint(LDI, fromInst, toInst)
+           || (isSpeculationAllowed && this->canSpeculateMemoryDependence(dep));
+  });
+  if (scc != nullptr) {
     if (this->verbose != Verbosity::Disabled) {
+      auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
       errs() << "DOALL:   We found an SCC of type " << sccInfo->getType() << " of the loop that is non clonable and non commutative\n" ;
       if (this->verbose >= Verbosity::Maximal) {
         // scc->printMinimal(errs(), "DOALL:     ") ;
@@ -184,6 +192,24 @@ bool DOALL::canBeAppliedToLoop (
   }
   return true;
 }
+
+double DOALL::estimateParallelExecutionTime (
+  LoopDependenceInfo *LDI,
+  Noelle &par,
+  Heuristics *h
+) const {
+
+  /*
+   * Iterations run in parallel without synchronizing with each other.
+   */
+  auto profiles = par.getProfiles();
+  auto loopStructure = LDI->getLoopStructure();
+  auto totalInstructions = (double)profiles->getTotalInstructions(loopStructure);
+  auto cores = this->computeNumberOfCoresUsablePerInvocation(LDI, par);
+  auto parallelTime = totalInstructions / cores;
+
+  return parallelTime + this->estimateDispatchTime(LDI, par, h);
+}
       
 bool DOALL::apply (
   LoopDependenceInfo *LDI,
@@ -219,6 +245,21 @@ bool DOALL::apply (
   this->generateEmptyTasks(LDI, { chunkerTask });
   this->numTaskInstances = LDI->getMaximumNumberOfCores();
 
+  /*
+   * Compute the number of iterations of the current invocation of the loop (-1 if it is unknown).
+   *
+   * When it is known, each core can run a single contiguous block of iterations.
+   * This keeps the loop of the task a counted loop with affine induction variables, which can be vectorized.
+   */
+  auto numberOfIterations = this->generateCodeToComputeTheNumberOfIterations(LDI, par);
+  this->distributesIterationsInBlocks = this->canDistributeIterationsInBlocks(LDI, numberOfIterations);
+  if (  true
+        && this->distributesIterationsInBlocks
+        && (this->verbose != Verbosity::Disabled)
+    ) {
+    errs() << "DOALL:   Iterations are distributed in one block per core\n";
+  }
+
   /*
    * Allocate memory for all environment variables
    */
@@ -285,11 +326,35 @@ bool DOALL::apply (
    */
   this->generateCodeToStoreLiveOutVariables(LDI, 0);
 
+  /*
+   * With many cores, let the task instances combine their private copies of the reducible live-out variables in a tree before the join.
+   */
+  if (this->shouldReduceLiveOutVariablesInTasks(LDI)) {
+    auto doallTask = (DOALLTask *)tasks[0];
+    this->generateCodeToReduceLiveOutVariablesInTask(LDI, 0, doallTask->numCoresArg);
+  }
+
   if (this->verbose >= Verbosity::Maximal) {
     errs() << "DOALL:  Stored live outs\n";
   }
 
-  this->addChunkFunctionExecutionAsideOriginalLoop(LDI, loopFunction, par);
+  /*
+   * Let the loads and stores of the task go through the shadow memory of the runtime if the loop runs speculatively.
+   */
+  if (this->isSpeculationRequired(LDI)){
+    this->speculateMemoryAccessesInTask(LDI, par);
+    if (this->verbose >= Verbosity::Maximal) {
+      errs() << "DOALL:  The loop runs speculatively\n";
+    }
+  }
+
+  this->addChunkFunctionExecutionAsideOriginalLoop(LDI, loopFunction, par, numberOfIterations);
+
+  /*
+   * Inline the speculative loads and stores, so their fast path (no shadow memory) runs without calls.
+   */
+  auto doallTask = (DOALLTask *)tasks[0];
+  this->doNestedInlineOfCalls(doallTask->getTaskBody(), doallTask->speculativeAccesses);
 
   /*
    * Final printing.
@@ -314,7 +379,8 @@ bool DOALL::apply (
 void DOALL::addChunkFunctionExecutionAsideOriginalLoop (
   LoopDependenceInfo *LDI,
   Function *loopFunction,
-  Noelle &par
+  Noelle &par,
+  Value *numberOfIterations
 ) {
 
   /*
@@ -329,24 +395,55 @@ void DOALL::addChunkFunctionExecutionAsideOriginalLoop (
   auto envPtr = envBuilder->getEnvArrayInt8Ptr();
 
   /*
-   * Fetch the number of cores
+   * Let the runtime choose the number of cores to use for the current invocation.
+   * The original loop runs when the runtime chooses a single core.
+   */
+  auto numCores = this->generateCodeToChooseTheNumberOfCores(LDI, par, numberOfIterations);
+
+  /*
+   * Fetch the loop ID.
    */
-  auto numCores = ConstantInt::get(par.int64, LDI->getMaximumNumberOfCores());
+  auto loopID = ConstantInt::get(par.int64, LDI->getID());
+
+  /*
+   * Run the parallelized loop only if the memory accesses that could not be disambiguated at compile time are disjoint.
+   */
+  auto areMemoryAccessesDisjoint = this->generateCodeToCheckThatMemoryAccessesAreDisjoint(LDI, par, numberOfIterations);
+  if (areMemoryAccessesDisjoint != nullptr){
+    auto loopPreHeader = LDI->getLoopStructure()->getPreHeader();
+    IRBuilder<> preheaderBuilder(loopPreHeader->getTerminator());
+    this->conditionToRunTheParallelizedLoop = preheaderBuilder.CreateAnd(this->conditionToRunTheParallelizedLoop, areMemoryAccessesDisjoint);
+    preheaderBuilder.CreateCall(this->aliasChecksCounter, ArrayRef<Value *>({
+      loopID,
+      preheaderBuilder.CreateZExt(areMemoryAccessesDisjoint, par.int64)
+    }));
+  }
 
   /*
    * Fetch the chunk size.
+   * A chunk size of 0 asks the runtime to split the iterations in one block per core.
+   */
+  auto chunkSize = ConstantInt::get(par.int64, this->distributesIterationsInBlocks ? 0 : LDI->DOALLChunkSize);
+
+  /*
+   * Tasks that combine their reducible live-out variables in a tree wait for each other.
+   * The runtime must then run all of them at the same time.
    */
-  auto chunkSize = ConstantInt::get(par.int64, LDI->DOALLChunkSize);
+  auto areTasksWaitingForEachOther = ConstantInt::get(par.int64, this->envBuilder->areLiveOutVariablesReducedInTasks() ? 1 : 0);
 
   /*
    * Call the function that incudes the parallelized loop.
    */
+  auto dispatcher = this->isSpeculationRequired(LDI) ? this->speculativeTaskDispatcher : this->taskDispatcher;
   IRBuilder<> doallBuilder(this->entryPointOfParallelizedLoop);
-  auto doallCallInst = doallBuilder.CreateCall(this->taskDispatcher, ArrayRef<Value *>({
+  auto doallCallInst = doallBuilder.CreateCall(dispatcher, ArrayRef<Value *>({
     tasks[0]->getTaskBody(),
     envPtr,
     numCores,
-    chunkSize
+    chunkSize,
+    numberOfIterations,
+    loopID,
+    areTasksWaitingForEachOther
   }));
   auto numThreadsUsed = doallBuilder.CreateExtractValue(doallCallInst, (uint64_t)0);
 
@@ -364,6 +461,228 @@ void DOALL::addChunkFunctionExecutionAsideOriginalLoop (
   return ;
 }
 
+Value * DOALL::generateCodeToComputeTheNumberOfIterations (
+  LoopDependenceInfo *LDI,
+  Noelle &par
+  ){
+
+  /*
+   * Check if the number of iterations is known at compile time.
+   */
+  if (LDI->doesHaveCompileTimeKnownTripCount()){
+    return ConstantInt::get(par.int64, LDI->getCompileTimeTripCount());
+  }
+
+  /*
+   * Compute the number of iterations in the preheader of the original loop.
+   */
+  auto loopSummary = LDI->getLoopStructure();
+  auto loopPreHeader = loopSummary->getPreHeader();
+  IRBuilder<> preheaderBuilder(loopPreHeader->getTerminator());
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+  LoopGoverningIVUtility ivUtility(loopGoverningIVAttr->getInductionVariable(), *loopGoverningIVAttr);
+  auto numberOfIterations = ivUtility.generateCodeToComputeTheTripCount(preheaderBuilder, par.int64);
+  if (numberOfIterations == nullptr){
+    return ConstantInt::get(par.int64, -1);
+  }
+
+  return numberOfIterations;
+}
+
+bool DOALL::canDistributeIterationsInBlocks (
+  LoopDependenceInfo *LDI,
+  Value *numberOfIterations
+  ) const {
+  if (DisableBlockDistribution) {
+    return false;
+  }
+
+  /*
+   * The runtime computes the size of the blocks from the number of iterations, so it must be known when the loop starts.
+   */
+  if (auto constantIterations = dyn_cast<ConstantInt>(numberOfIterations)) {
+    if (constantIterations->getSExtValue() < 0) {
+      return false;
+    }
+  }
+
+  /*
+   * The header of the task runs once more at the end of the block of each core.
+   * Hence, all its instructions must be insensitive to the number of times they execute.
+   */
+  auto repeatableInstructions = this->getRepeatableHeaderInstructions(LDI);
+  for (auto &I : *LDI->getLoopStructure()->getHeader()) {
+    if (repeatableInstructions.find(&I) == repeatableInstructions.end()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Value * DOALL::generateCodeToChooseTheNumberOfCores (
+  LoopDependenceInfo *LDI,
+  Noelle &par,
+  Value *numberOfIterations
+  ){
+
+  /*
+   * Invoke the runtime in the preheader of the original loop.
+   */
+  auto loopSummary = LDI->getLoopStructure();
+  auto loopPreHeader = loopSummary->getPreHeader();
+  IRBuilder<> preheaderBuilder(loopPreHeader->getTerminator());
+  auto numCores = preheaderBuilder.CreateCall(this->coresChooser, ArrayRef<Value *>({
+    ConstantInt::get(par.int64, LDI->getID()),
+    numberOfIterations,
+    ConstantInt::get(par.int64, LDI->getMaximumNumberOfCores())
+  }));
+
+  /*
+   * Run the parallelized loop only if the runtime chose more than one core.
+   */
+  this->conditionToRunTheParallelizedLoop = preheaderBuilder.CreateICmpSGT(numCores, ConstantInt::get(par.int64, 1));
+
+  return numCores;
+}
+
+bool DOALL::canCheckAtRunTimeThatMemoryAccessesAreDisjoint (
+  LoopDependenceInfo *LDI,
+  Instruction *from,
+  Instruction *to
+  ) const {
+
+  /*
+   * Both accesses must have ranges that are known before the loop starts.
+   */
+  auto domainSpaceAnalysis = LDI->getLoopIterationDomainSpaceAnalysis();
+  auto fromRange = domainSpaceAnalysis->getMemoryAccessRange(from);
+  auto toRange = domainSpaceAnalysis->getMemoryAccessRange(to);
+  if (  false
+        || (fromRange == nullptr)
+        || (toRange == nullptr)
+    ){
+    return false;
+  }
+
+  /*
+   * Accesses from the same base overlap depending only on their offsets and steps, which are known at compile time.
+   * Hence, a run-time check can only help for accesses from different bases.
+   */
+  return fromRange->base != toRange->base;
+}
+
+std::set<std::pair<Instruction *, Instruction *>> DOALL::getMemoryDependencesToCheckAtRunTime (
+  LoopDependenceInfo *LDI
+  ) const {
+  std::set<std::pair<Instruction *, Instruction *>> dependences;
+
+  /*
+   * Collect the loop-carried memory dependences that canBeAppliedToLoop ignored because of a run-time check.
+   */
+  auto domainSpaceAnalysis = LDI->getLoopIterationDomainSpaceAnalysis();
+  for (auto scc : LDI->sccdagAttrs.getSCCsWithLoopCarriedDataDependencies()) {
+    auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
+    if (  false
+          || sccInfo->canExecuteReducibly()
+          || sccInfo->canBeCloned()
+      ){
+      continue ;
+    }
+
+    LDI->sccdagAttrs.iterateOverLoopCarriedDataDependences(scc, [
+      this, LDI, &dependences, domainSpaceAnalysis
+    ](DGEdge<Value> *dep) -> bool {
+      if (!dep->isMemoryDependence()) return false;
+
+      auto fromInst = dyn_cast<Instruction>(dep->getOutgoingT());
+      auto toInst = dyn_cast<Instruction>(dep->getIncomingT());
+      if (  false
+            || (fromInst == nullptr)
+            || (toInst == nullptr)
+            || domainSpaceAnalysis->areInstructionsAccessingDisjointMemoryLocationsBetweenIterations(fromInst, toInst)
+            || !this->canCheckAtRunTimeThatMemoryAccessesAreDisjoint(LDI, fromInst, toInst)
+        ){
+        return false;
+      }
+
+      /*
+       * The check is symmetric.
+       */
+      if (dependences.find(std::make_pair(toInst, fromInst)) == dependences.end()){
+        dependences.insert(std::make_pair(fromInst, toInst));
+      }
+      return false;
+    });
+  }
+
+  return dependences;
+}
+
+Value * DOALL::generateCodeToCheckThatMemoryAccessesAreDisjoint (
+  LoopDependenceInfo *LDI,
+  Noelle &par,
+  Value *numberOfIterations
+  ){
+
+  /*
+   * Check if there is something to check.
+   */
+  auto dependences = this->getMemoryDependencesToCheckAtRunTime(LDI);
+  if (dependences.size() == 0){
+    return nullptr;
+  }
+  if (this->verbose != Verbosity::Disabled) {
+    errs() << "DOALL:  The parallelized loop is guarded by " << dependences.size() << " run-time checks of aliasing\n";
+  }
+
+  /*
+   * The checks are computed in the preheader of the original loop.
+   * They cannot pass if the number of iterations is unknown (i.e., -1).
+   */
+  auto loopPreHeader = LDI->getLoopStructure()->getPreHeader();
+  IRBuilder<> preheaderBuilder(loopPreHeader->getTerminator());
+  auto isNumberOfIterationsKnown = preheaderBuilder.CreateICmpSGE(numberOfIterations, ConstantInt::get(par.int64, 0));
+
+  /*
+   * Compute the range of addresses [low, high) touched by a memory instruction across all iterations of the current invocation.
+   * The last value of the step is included because the instruction might belong to the header of the loop, which runs once more.
+   */
+  auto domainSpaceAnalysis = LDI->getLoopIterationDomainSpaceAnalysis();
+  auto computeRange = [&preheaderBuilder, &par, numberOfIterations, domainSpaceAnalysis](Instruction *memoryInst) -> std::pair<Value *, Value *> {
+    auto range = domainSpaceAnalysis->getMemoryAccessRange(memoryInst);
+    assert(range != nullptr);
+
+    Value *base;
+    if (range->base->getType()->isPointerTy()){
+      base = preheaderBuilder.CreatePtrToInt(range->base, par.int64);
+    } else {
+      base = preheaderBuilder.CreateSExtOrTrunc(range->base, par.int64);
+    }
+    auto start = preheaderBuilder.CreateAdd(base, ConstantInt::get(par.int64, range->offset));
+    auto end = preheaderBuilder.CreateAdd(start, preheaderBuilder.CreateMul(numberOfIterations, ConstantInt::get(par.int64, range->step)));
+    auto size = ConstantInt::get(par.int64, range->accessSize);
+    if (range->step >= 0){
+      return std::make_pair(start, preheaderBuilder.CreateAdd(end, size));
+    }
+    return std::make_pair(end, preheaderBuilder.CreateAdd(start, size));
+  };
+
+  /*
+   * Check every pair of memory instructions.
+   */
+  Value *areDisjoint = isNumberOfIterationsKnown;
+  for (auto &dependence : dependences){
+    auto fromRange = computeRange(dependence.first);
+    auto toRange = computeRange(dependence.second);
+    auto isFromBeforeTo = preheaderBuilder.CreateICmpULE(fromRange.second, toRange.first);
+    auto isToBeforeFrom = preheaderBuilder.CreateICmpULE(toRange.second, fromRange.first);
+    areDisjoint = preheaderBuilder.CreateAnd(areDisjoint, preheaderBuilder.CreateOr(isFromBeforeTo, isToBeforeFrom));
+  }
+
+  return areDisjoint;
+}
+
 Value * DOALL::fetchClone (Value *original) const {
   auto task = (DOALLTask *)this->tasks[0];
   if (isa<ConstantData>(original)) return original;
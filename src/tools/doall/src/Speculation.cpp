@@ -0,0 +1,254 @@
+/*
+ * Copyright 2016 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "DOALL.hpp"
+#include "DOALLTask.hpp"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/IR/IntrinsicInst.h"
+
+/*
+ * Types of the values that a speculative task can load and store through the shadow memory of the runtime.
+ */
+static bool isSpeculativeAccessType (Type *type) {
+  if (auto intType = dyn_cast<IntegerType>(type)){
+    return intType->getBitWidth() <= 64;
+  }
+
+  return false
+         || type->isPointerTy()
+         || type->isFloatTy()
+         || type->isDoubleTy();
+}
+
+bool DOALL::canSpeculateLoop (
+  LoopDependenceInfo *LDI
+  ) const {
+
+  /*
+   * Iterations are identified by the value of the loop-governing induction variable, which must be an integer with a constant step.
+   */
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+  auto &iv = loopGoverningIVAttr->getInductionVariable();
+  if (!iv.getLoopEntryPHI()->getType()->isIntegerTy()){
+    return false;
+  }
+  auto step = dyn_cast_or_null<ConstantInt>(iv.getSingleComputedStepValue());
+  if (  false
+        || (step == nullptr)
+        || step->isZero()
+    ){
+    return false;
+  }
+
+  /*
+   * The only instructions of the loop that can access memory are loads and stores that the runtime can buffer.
+   * Every other side effect could not be undone if the speculation fails.
+   */
+  for (auto inst : LDI->getLoopStructure()->getInstructions()){
+    if (!inst->mayReadOrWriteMemory()){
+      continue ;
+    }
+
+    if (auto load = dyn_cast<LoadInst>(inst)){
+      if (  true
+            && load->isSimple()
+            && isSpeculativeAccessType(load->getType())
+        ){
+        continue ;
+      }
+
+    } else if (auto store = dyn_cast<StoreInst>(inst)){
+      if (  true
+            && store->isSimple()
+            && isSpeculativeAccessType(store->getValueOperand()->getType())
+        ){
+        continue ;
+      }
+
+    } else if (auto call = dyn_cast<CallInst>(inst)){
+      if (isa<DbgInfoIntrinsic>(call)){
+        continue ;
+      }
+      if (auto intrinsic = dyn_cast<IntrinsicInst>(call)){
+        if (  false
+              || (intrinsic->getIntrinsicID() == Intrinsic::lifetime_start)
+              || (intrinsic->getIntrinsicID() == Intrinsic::lifetime_end)
+          ){
+          continue ;
+        }
+      }
+    }
+
+    if (this->verbose >= Verbosity::Maximal) {
+      errs() << "DOALL:   The loop cannot run speculatively because of " << *inst << "\n";
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool DOALL::canSpeculateMemoryDependence (
+  DGEdge<Value> *dep
+  ) const {
+
+  /*
+   * Only may dependences between loads and stores are worth speculating.
+   */
+  if (  false
+        || !dep->isMemoryDependence()
+        || dep->isMustDependence()
+    ){
+    return false;
+  }
+  auto fromInst = dep->getOutgoingT();
+  auto toInst = dep->getIncomingT();
+
+  /*
+   * If the dependences have been profiled, then only those that never manifested are speculated.
+   * The others would make the speculation fail.
+   */
+  if (  true
+        && this->areDependencesProfiled
+        && !dep->isRemovableDependence()
+    ){
+    return false;
+  }
+
+  return true
+         && (isa<LoadInst>(fromInst) || isa<StoreInst>(fromInst))
+         && (isa<LoadInst>(toInst) || isa<StoreInst>(toInst));
+}
+
+bool DOALL::isSpeculationRequired (
+  LoopDependenceInfo *LDI
+  ) const {
+
+  /*
+   * The loop runs speculatively if canBeAppliedToLoop ignored a memory dependence that is neither disproved at compile time nor checked at run time.
+   */
+  auto scc = LDI->getSCCBlockingParallelization([this, LDI](Instruction *fromInst, Instruction *toInst, DGEdge<Value> *dep) -> bool {
+    return this->canCheckAtRunTimeThatMemoryAccessesAreDisjoint(LDI, fromInst, toInst);
+  });
+
+  return (scc != nullptr);
+}
+
+void DOALL::speculateMemoryAccessesInTask (
+  LoopDependenceInfo *LDI,
+  Noelle &par
+  ){
+
+  /*
+   * Fetch the task.
+   */
+  auto task = (DOALLTask *)tasks[0];
+  auto taskBody = task->getTaskBody();
+  auto &DL = this->module.getDataLayout();
+
+  /*
+   * Identify the current iteration at the beginning of the header.
+   * The runtime needs identifiers that increase with the iterations, so we negate the induction variable if it decreases.
+   */
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+  auto &iv = loopGoverningIVAttr->getInductionVariable();
+  auto ivPHI = cast<PHINode>(fetchClone(iv.getLoopEntryPHI()));
+  IRBuilder<> headerBuilder(ivPHI->getParent()->getFirstNonPHI());
+  Value *iteration = headerBuilder.CreateSExtOrTrunc(ivPHI, par.int64);
+  if (cast<ConstantInt>(iv.getSingleComputedStepValue())->isNegative()){
+    iteration = headerBuilder.CreateNeg(iteration);
+  }
+
+  /*
+   * Collect the loads and stores of the task that could access shared memory.
+   * Stack locations allocated by the task are private to it.
+   */
+  std::vector<std::pair<Instruction *, Instruction *>> accesses;
+  for (auto inst : LDI->getLoopStructure()->getInstructions()){
+    if (  true
+          && !isa<LoadInst>(inst)
+          && !isa<StoreInst>(inst)
+      ){
+      continue ;
+    }
+    auto cloneInst = task->getCloneOfOriginalInstruction(inst);
+    auto pointer = isa<LoadInst>(cloneInst) ? cast<LoadInst>(cloneInst)->getPointerOperand() : cast<StoreInst>(cloneInst)->getPointerOperand();
+    auto object = GetUnderlyingObject(pointer, DL);
+    if (  true
+          && isa<AllocaInst>(object)
+          && (cast<AllocaInst>(object)->getFunction() == taskBody)
+      ){
+      continue ;
+    }
+    accesses.push_back(std::make_pair(inst, cloneInst));
+  }
+
+  /*
+   * Replace the loads and stores with calls to the runtime.
+   * Values go through the runtime as 64-bit integers.
+   */
+  auto int8Ptr = PointerType::getUnqual(par.int8);
+  for (auto &access : accesses){
+    auto cloneInst = access.second;
+    IRBuilder<> builder(cloneInst);
+
+    if (auto load = dyn_cast<LoadInst>(cloneInst)){
+      auto type = load->getType();
+      auto address = builder.CreateBitCast(load->getPointerOperand(), int8Ptr);
+      auto size = ConstantInt::get(par.int64, DL.getTypeStoreSize(type));
+      auto call = builder.CreateCall(this->speculativeLoad, ArrayRef<Value *>({
+        address,
+        size,
+        iteration
+      }));
+      task->speculativeAccesses.insert(call);
+      Value *value = call;
+      if (type->isPointerTy()){
+        value = builder.CreateIntToPtr(value, type);
+      } else if (type->isFloatTy()){
+        value = builder.CreateBitCast(builder.CreateTrunc(value, par.int32), type);
+      } else if (type->isDoubleTy()){
+        value = builder.CreateBitCast(value, type);
+      } else {
+        value = builder.CreateZExtOrTrunc(value, type);
+      }
+      load->replaceAllUsesWith(value);
+      task->addInstruction(access.first, cast<Instruction>(value));
+
+    } else {
+      auto store = cast<StoreInst>(cloneInst);
+      auto value = store->getValueOperand();
+      auto type = value->getType();
+      if (type->isPointerTy()){
+        value = builder.CreatePtrToInt(value, par.int64);
+      } else if (type->isFloatTy()){
+        value = builder.CreateZExt(builder.CreateBitCast(value, par.int32), par.int64);
+      } else if (type->isDoubleTy()){
+        value = builder.CreateBitCast(value, par.int64);
+      } else {
+        value = builder.CreateZExtOrTrunc(value, par.int64);
+      }
+      auto address = builder.CreateBitCast(store->getPointerOperand(), int8Ptr);
+      auto size = ConstantInt::get(par.int64, DL.getTypeStoreSize(type));
+      auto call = builder.CreateCall(this->speculativeStore, ArrayRef<Value *>({
+        address,
+        value,
+        size,
+        iteration
+      }));
+      task->speculativeAccesses.insert(call);
+      task->addInstruction(access.first, call);
+    }
+
+    cloneInst->eraseFromParent();
+  }
+
+  return ;
+}
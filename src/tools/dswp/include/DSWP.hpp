@@ -49,6 +49,12 @@ namespace llvm::noelle {
         Heuristics *h
       ) const override ;
 
+      double estimateParallelExecutionTime (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        Heuristics *h
+      ) const override ;
+
       void reset () override ;
 
     private:
@@ -58,10 +64,16 @@ namespace llvm::noelle {
        */
       bool enableMergingSCC;
 
+      /*
+       * Whether queues need to publish every element as soon as it is pushed
+       */
+      bool publishEachPush;
+
       /*
        * Stores new pipeline execution
        */
       std::unordered_map<SCC *, DSWPTask *> sccToStage;
+      std::unordered_map<DSWPTask *, std::vector<DSWPTask *>> replicasOfStage;
       std::vector<std::unique_ptr<QueueInfo>> queues;
 
       /*
@@ -83,11 +95,18 @@ namespace llvm::noelle {
       void clusterSubloops (LoopDependenceInfo *LDI);
       void generateStagesFromPartitionedSCCs (LoopDependenceInfo *LDI);
       void addClonableSCCsToStages (LoopDependenceInfo *LDI);
+      SCCSet * identifyParallelStage (
+        LoopDependenceInfo *LDI,
+        std::vector<SCCSet *> &stages
+      ) const ;
+      void distributeIterationsAmongReplicas (LoopDependenceInfo *LDI, Noelle &par, int taskIndex);
+      void selectValuesOfReplicatedStages (LoopDependenceInfo *LDI, Noelle &par, int taskIndex);
       bool isCompleteAndValidStageStructure(LoopDependenceInfo *LDI) const ;
       void generateLoopSubsetForStage (LoopDependenceInfo *LDI, int taskIndex);
       void generateLoadsOfQueuePointers (Noelle &par, int taskIndex);
       void popValueQueues (LoopDependenceInfo *LDI, Noelle &par, int taskIndex);
       void pushValueQueues (LoopDependenceInfo *LDI, Noelle &par, int taskIndex);
+      void flushPushQueues (Noelle &par, int taskIndex);
       void createPipelineFromStages (LoopDependenceInfo *LDI, Noelle &par);
       Value * createStagesArrayFromStages (
         LoopDependenceInfo *LDI,
@@ -99,6 +118,11 @@ namespace llvm::noelle {
         IRBuilder<> funcBuilder,
         Noelle &par
       );
+      Value * createQueueConsumersArrayFromStages (
+        LoopDependenceInfo *LDI,
+        IRBuilder<> funcBuilder,
+        Noelle &par
+      );
 
       /*
        * Recursively inline queue push/pop functions in DSWP Utils and ThreadPool API
@@ -123,6 +147,12 @@ namespace llvm::noelle {
         Instruction *consumer,
         bool isMemoryDependence
       );
+      void createBroadcastQueues (void);
+      void coalesceQueues (void);
+      void redirectStagesToQueues (
+        std::vector<std::unique_ptr<QueueInfo>> &newQueues,
+        std::vector<int> &oldToNewQueueIndex
+      );
       void collectLiveInEnvInfo (LoopDependenceInfo *LDI);
       void collectLiveOutEnvInfo (LoopDependenceInfo *LDI);
       bool areQueuesAcyclical () const ;
@@ -45,6 +45,12 @@ namespace llvm::noelle {
       std::set<SCC *> stageSCCs;
       std::set<SCC *> clonableSCCs;
 
+      /*
+       * Replicas of a stage without loop-carried data dependences; each one executes the iterations congruent to its ID
+       */
+      uint32_t replicaID;
+      uint32_t numberOfReplicas;
+
       /*
        * Maps from producer to the queues they push to
        */
@@ -55,6 +61,11 @@ namespace llvm::noelle {
        */
       unordered_map<Instruction *, int> producedPopQueue;
 
+      /*
+       * Maps from a producer of a replicated stage to the values popped from the queues of its replicas, indexed by replica ID
+       */
+      unordered_map<Instruction *, std::vector<Instruction *>> producerToReplicaLoads;
+
       /*
        * Stores queue indices and pointers for the stage
        */
@@ -78,8 +89,21 @@ namespace llvm::noelle {
     std::set<Instruction *> consumers;
     unordered_map<Instruction *, int> consumerToPushIndex;
 
+    /*
+     * Values carried by each entry of the queue, ordered as they are produced within their basic block.
+     * When there is more than one, dependentType is the structure that packs them.
+     */
+    std::vector<Instruction *> producers;
+
+    /*
+     * Stages that consume every entry of the queue.
+     * When there is more than one, toStage is the first of them.
+     */
+    std::set<int> toStages;
+
     QueueInfo(Instruction *p, Instruction *c, Type *type, bool isMemoryDependence)
         : producer{p}, dependentType{type}, isMemoryDependence{isMemoryDependence} {
+      producers.push_back(p);
       consumers.insert(c);
       if (isMemoryDependence) {
         dependentType = IntegerType::get(c->getContext(), 1);
@@ -93,10 +117,37 @@ namespace llvm::noelle {
       }
     }
 
+    bool isPacked (void) const {
+      return producers.size() > 1;
+    }
+
+    bool isBroadcast (void) const {
+      return toStages.size() > 1;
+    }
+
+    /*
+     * Deliver the entries of this queue also to the stages of another queue that carries the same values.
+     */
+    void broadcastTo (QueueInfo *other) {
+      toStages.insert(other->toStages.begin(), other->toStages.end());
+      consumers.insert(other->consumers.begin(), other->consumers.end());
+      toStage = *toStages.begin();
+    }
+
+    /*
+     * Carry the values of another queue between the same stages in the entries of this queue.
+     */
+    void pack (QueueInfo *other) {
+      producers.insert(producers.end(), other->producers.begin(), other->producers.end());
+      consumers.insert(other->consumers.begin(), other->consumers.end());
+    }
+
     raw_ostream &print (raw_ostream &stream, std::string prefixToUse = "") {
-      producer->print(stream << prefixToUse
-        << "From stage: " << fromStage << " To stage: " << toStage
-        << " Number of bits: " << bitLength << " Producer: ");
+      stream << prefixToUse << "From stage: " << fromStage << " To stage:";
+      for (auto stage : toStages) {
+        stream << " " << stage;
+      }
+      producer->print(stream << " Number of bits: " << bitLength << " Producer: ");
       return stream << "\n";
     }
   };
@@ -104,6 +155,7 @@ namespace llvm::noelle {
   struct QueueInstrs {
     Value *queuePtr;
     Value *queueCall;
+    Value *flushCall;
     Value *alloca;
     Value *allocaCast;
     Value *load;
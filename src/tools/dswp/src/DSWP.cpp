@@ -21,6 +21,7 @@ DSWP::DSWP (
 ) :
   ParallelizationTechniqueForLoopsWithLoopCarriedDataDependences{module, p, forceParallelization, v},
   enableMergingSCC{enableSCCMerging},
+  publishEachPush{false},
   queues{}, queueArrayType{nullptr},
   sccToStage{}, stageArrayType{nullptr},
   zeroIndexForBaseArray{nullptr}
@@ -49,12 +50,14 @@ void DSWP::reset () {
   ParallelizationTechnique::reset();
 
   sccToStage.clear();
+  replicasOfStage.clear();
 
   for (auto &queue : queues) {
     queue.release();
   }
   queues.clear();
 
+  publishEachPush = false;
   queueArrayType = nullptr;
   stageArrayType = nullptr;
   zeroIndexForBaseArray = nullptr;
@@ -181,6 +184,66 @@ bool DSWP::canBeAppliedToLoop (
   return true ;
 }
 
+double DSWP::estimateParallelExecutionTime (
+  LoopDependenceInfo *LDI,
+  Noelle &par,
+  Heuristics *h
+) const {
+
+  /*
+   * Fetch the profiles.
+   */
+  auto profiles = par.getProfiles();
+  auto &invocationLatency = h->getInvocationLatency();
+  auto loopStructure = LDI->getLoopStructure();
+  auto totalInstructions = (double)profiles->getTotalInstructions(loopStructure);
+  auto iterations = (double)profiles->getIterations(loopStructure);
+
+  /*
+   * Fetch the biggest SCC that cannot be cloned among stages and the values that need to be communicated between stages.
+   */
+  uint64_t biggestSCCTime = 0;
+  uint64_t sequentialSCCs = 0;
+  std::set<Value *> queueValues;
+  for (auto nodePair : LDI->sccdagAttrs.getSCCDAG()->internalNodePairs()) {
+    auto currentSCC = nodePair.first;
+    auto currentSCCInfo = LDI->sccdagAttrs.getSCCAttrs(currentSCC);
+    if (currentSCCInfo->canBeCloned()) {
+      continue ;
+    }
+    sequentialSCCs++;
+    auto currentSCCTime = invocationLatency.latencyPerInvocation(currentSCC);
+    if (currentSCCTime > biggestSCCTime){
+      biggestSCCTime = currentSCCTime;
+    }
+    auto &externals = invocationLatency.memoizeExternals(&LDI->sccdagAttrs, currentSCC);
+    queueValues.insert(externals.begin(), externals.end());
+  }
+  uint64_t queueLatencyPerIteration = 0;
+  for (auto queueValue : queueValues){
+    queueLatencyPerIteration += invocationLatency.queueLatency(queueValue);
+  }
+
+  /*
+   * Stages run in a pipeline, so the execution is bound by the biggest stage.
+   * Moreover, stages pay to push and pop the values communicated between them at every iteration.
+   */
+  auto stages = this->computeNumberOfCoresUsablePerInvocation(LDI, par);
+  if (((double)sequentialSCCs) < stages){
+    stages = (double)sequentialSCCs;
+  }
+  if (stages < 1){
+    stages = 1;
+  }
+  auto parallelTime = totalInstructions / stages;
+  if (((double)biggestSCCTime) > parallelTime){
+    parallelTime = (double)biggestSCCTime;
+  }
+  parallelTime += (iterations * ((double)queueLatencyPerIteration)) / stages;
+
+  return parallelTime + this->estimateDispatchTime(LDI, par, h);
+}
+
 bool DSWP::apply (
   LoopDependenceInfo *LDI,
   Noelle &par,
@@ -246,7 +309,26 @@ bool DSWP::apply (
    */
   collectDataAndMemoryQueueInfo(LDI, par);
   collectControlQueueInfo(LDI, par);
+
+  /*
+   * Deliver values consumed by several stages (e.g., loop exit conditions) through a single queue.
+   */
+  createBroadcastQueues();
   // assert(areQueuesAcyclical());
+
+  /*
+   * Queues publish their elements in batches.
+   * This is safe only if no stage waits for a value produced by a later stage, as that stage could wait for a batch that will never be completed.
+   */
+  this->publishEachPush = !this->areQueuesAcyclical();
+
+  /*
+   * Pack values that flow between the same pair of stages into single queue entries.
+   * This delays a value until the last one of its entry is produced, so it also requires the stages to form a pipeline.
+   */
+  if (!this->publishEachPush) {
+    coalesceQueues();
+  }
   // writeStageQueuesAsDot(*LDI);
 
   /*
@@ -354,12 +436,23 @@ bool DSWP::apply (
     IRBuilder<> entryBuilder(task->getEntry());
     entryBuilder.CreateBr(task->getCloneOfOriginalBasicBlock(loopHeader));
 
+    /*
+     * Execute only the iterations owned by the current replica of a parallel stage.
+     */
+    distributeIterationsAmongReplicas(LDI, par, i);
+    selectValuesOfReplicatedStages(LDI, par, i);
+
     /*
      * Add the return instruction at the end of the exit basic block.
      */
     IRBuilder<> exitBuilder(task->getExit());
     exitBuilder.CreateRetVoid();
 
+    /*
+     * Publish the last elements pushed to the queues before the stage ends.
+     */
+    flushPushQueues(par, i);
+
     /*
      * Store final results to loop live-out variables.
      * Generate a store to propagate the information about which exit block has been taken from the parallelized loop to the code outside it.
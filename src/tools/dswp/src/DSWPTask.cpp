@@ -21,7 +21,9 @@ namespace llvm::noelle {
     )
     : Task{ID, taskSignature, M},
       stageSCCs{},
-      clonableSCCs{}
+      clonableSCCs{},
+      replicaID{0},
+      numberOfReplicas{1}
     {
 
     return ;
@@ -35,12 +35,17 @@ void DSWP::collectLiveInEnvInfo (LoopDependenceInfo *LDI) {
       }
 
       /*
-       * If not clonable, one and only task uses the consumer and must load it
+       * If not clonable, one and only stage uses the consumer; all of its replicas must load it
        */
       assert(this->sccToStage.find(consumerSCC) != this->sccToStage.end());
       auto task = this->sccToStage.at(consumerSCC);
       auto id = task->getID();
       envBuilder->getUser(id)->addLiveInIndex(envIndex);
+      if (this->replicasOfStage.find(task) != this->replicasOfStage.end()) {
+        for (auto replica : this->replicasOfStage.at(task)) {
+          envBuilder->getUser(replica->getID())->addLiveInIndex(envIndex);
+        }
+      }
     }
   }
 }
@@ -18,6 +18,9 @@ void DSWP::inlineQueueCalls (int taskIndex) {
   for (auto &queueInstrPair : task->queueInstrMap) {
     auto &queueInstr = queueInstrPair.second;
     callsToInline.insert(cast<CallInst>(queueInstr->queueCall));
+    if (queueInstr->flushCall != nullptr) {
+      callsToInline.insert(cast<CallInst>(queueInstr->flushCall));
+    }
   }
   doNestedInlineOfCalls(task->getTaskBody(), callsToInline);
 }
@@ -12,6 +12,8 @@
 
 using namespace llvm;
 
+static cl::opt<bool> DisableParallelStages("noelle-dswp-disable-parallel-stages", cl::ZeroOrMore, cl::Hidden, cl::desc("Do not replicate the DSWP stages without loop-carried data dependences"));
+
 void DSWP::generateStagesFromPartitionedSCCs (LoopDependenceInfo *LDI) {
   assert(LDI != nullptr);
 
@@ -22,6 +24,16 @@ void DSWP::generateStagesFromPartitionedSCCs (LoopDependenceInfo *LDI) {
   auto depthOrdered = this->partitioner->getDepthOrderedSets();
   auto taskID = 0;
 
+  /*
+   * Identify the stage whose iterations are independent, if any.
+   * It is replicated over the cores left unused by the pipeline.
+   */
+  auto parallelSubset = this->identifyParallelStage(LDI, depthOrdered);
+  auto replicas = 1;
+  if (parallelSubset != nullptr) {
+    replicas = LDI->getMaximumNumberOfCores() - depthOrdered.size() + 1;
+  }
+
   /*
    * Create the tasks.
    */
@@ -37,10 +49,291 @@ void DSWP::generateStagesFromPartitionedSCCs (LoopDependenceInfo *LDI) {
       task->stageSCCs.insert(scc);
       this->sccToStage[scc] = task;
     }
+    if (subset != parallelSubset) {
+      continue ;
+    }
+
+    /*
+     * Create the replicas of the parallel stage right after it, so queues keep flowing from earlier stages to later ones.
+     * The SCCs of the stage keep being mapped to its first replica.
+     */
+    task->numberOfReplicas = replicas;
+    for (auto replicaID = 1; replicaID < replicas; replicaID++) {
+      auto replica = new DSWPTask(taskID, this->taskType, this->module);
+      taskID++;
+      techniqueTasks.push_back(replica);
+      replica->stageSCCs = task->stageSCCs;
+      replica->replicaID = replicaID;
+      replica->numberOfReplicas = replicas;
+      this->replicasOfStage[task].push_back(replica);
+    }
+    if (this->verbose != Verbosity::Disabled) {
+      errs() << "DSWP:  Stage " << task->getID() << " is replicated " << replicas << " times\n";
+    }
   }
+
   this->generateEmptyTasks(LDI, techniqueTasks);
   this->numTaskInstances = techniqueTasks.size();
-  assert(this->numTaskInstances == this->partitioner->numberOfPartitions());
+  assert(this->numTaskInstances >= this->partitioner->numberOfPartitions());
+
+  return ;
+}
+
+SCCSet * DSWP::identifyParallelStage (
+  LoopDependenceInfo *LDI,
+  std::vector<SCCSet *> &stages
+) const {
+
+  /*
+   * Check if replicating stages is enabled.
+   */
+  if (DisableParallelStages) {
+    return nullptr;
+  }
+
+  /*
+   * The stage to replicate is chosen by its weight, so profiles are required.
+   */
+  if (!this->profile.isAvailable()) {
+    return nullptr;
+  }
+
+  /*
+   * Check if there are cores left for at least another replica.
+   */
+  int64_t cores = LDI->getMaximumNumberOfCores();
+  if ((cores - ((int64_t)stages.size())) < 1) {
+    return nullptr;
+  }
+
+  /*
+   * Fetch the SCCs that cannot be executed by replicas.
+   */
+  auto sccdag = LDI->sccdagAttrs.getSCCDAG();
+  auto sccsWithLoopCarriedDependences = LDI->sccdagAttrs.getSCCsWithLoopCarriedDependencies();
+  std::set<SCC *> sccsOfLiveOuts;
+  for (auto envIndex : LDI->environment->getEnvIndicesOfLiveOutVars()) {
+    auto producer = LDI->environment->producerAt(envIndex);
+    sccsOfLiveOuts.insert(sccdag->sccOfValue(producer));
+  }
+
+  /*
+   * Choose the biggest stage that can be replicated.
+   */
+  SCCSet *parallelStage = nullptr;
+  uint64_t parallelStageInsts = 0;
+  for (auto stage : stages) {
+    auto canBeReplicated = true;
+    uint64_t stageInsts = 0;
+    for (auto scc : stage->sccs) {
+
+      /*
+       * Iterations of the stage must not depend on each other, and only one replica executes the last one.
+       */
+      if (  false
+            || (sccsWithLoopCarriedDependences.find(scc) != sccsWithLoopCarriedDependences.end())
+            || (sccsOfLiveOuts.find(scc) != sccsOfLiveOuts.end())
+        ){
+        canBeReplicated = false;
+        break ;
+      }
+
+      /*
+       * Replicas skip the instructions of the iterations they do not own, but they all follow the whole control flow of the loop.
+       * Hence, neither the stage nor the conditions it computes for other stages can steer that control flow.
+       *
+       * PHIs are fine: they keep being executed at every iteration, and they merge undefined values only in the iterations a replica does not own.
+       */
+      for (auto nodePair : scc->internalNodePairs()) {
+        auto inst = cast<Instruction>(nodePair.first);
+        if (inst->isTerminator()) {
+          canBeReplicated = false;
+          break ;
+        }
+        for (auto user : inst->users()) {
+          auto userInst = dyn_cast<Instruction>(user);
+          if (  true
+                && (userInst != nullptr)
+                && userInst->isTerminator()
+            ){
+            canBeReplicated = false;
+            break ;
+          }
+        }
+        if (!canBeReplicated) {
+          break ;
+        }
+      }
+      if (!canBeReplicated) {
+        break ;
+      }
+
+      stageInsts += this->profile.getTotalInstructions(scc);
+    }
+    if (  false
+          || !canBeReplicated
+          || (stageInsts == 0)
+      ){
+      continue ;
+    }
+
+    if (stageInsts > parallelStageInsts) {
+      parallelStage = stage;
+      parallelStageInsts = stageInsts;
+    }
+  }
+
+  return parallelStage;
+}
+
+void DSWP::distributeIterationsAmongReplicas (LoopDependenceInfo *LDI, Noelle &par, int taskIndex) {
+  auto task = (DSWPTask *)this->tasks[taskIndex];
+
+  /*
+   * Check if the stage is replicated.
+   */
+  if (task->numberOfReplicas == 1) {
+    return ;
+  }
+
+  /*
+   * Fetch the clones of the instructions of the stage.
+   * Clonable SCCs, control flow, PHIs, and queue operations are executed by every replica at every iteration.
+   */
+  std::set<Instruction *> stageInsts;
+  for (auto scc : task->stageSCCs) {
+    for (auto nodePair : scc->internalNodePairs()) {
+      auto inst = cast<Instruction>(nodePair.first);
+      if (  false
+            || !task->isAnOriginalInstruction(inst)
+            || isa<PHINode>(inst)
+        ){
+        continue ;
+      }
+      stageInsts.insert(task->getCloneOfOriginalInstruction(inst));
+    }
+  }
+
+  /*
+   * Iterations are assigned to replicas in round-robin order.
+   * Compute whether the current iteration is owned by the replica at the beginning of the header.
+   */
+  auto loopHeader = LDI->getLoopStructure()->getHeader();
+  auto headerClone = task->getCloneOfOriginalBasicBlock(loopHeader);
+  auto replicas = ConstantInt::get(par.int64, task->numberOfReplicas);
+  auto replicaIterationPHI = IVUtility::createChunkPHI(task->getEntry(), headerClone, par.int64, replicas);
+  IRBuilder<> headerBuilder(headerClone->getFirstNonPHIOrDbgOrLifetime());
+  auto replicaID = ConstantInt::get(par.int64, task->replicaID);
+  auto isIterationOwned = headerBuilder.CreateICmpEQ(replicaIterationPHI, replicaID);
+
+  /*
+   * Collect the sequences of consecutive instructions of the stage.
+   */
+  std::vector<std::vector<Instruction *>> sequences;
+  for (auto &B : *task->getTaskBody()) {
+    std::vector<Instruction *> sequence;
+    for (auto &I : B) {
+      if (stageInsts.find(&I) != stageInsts.end()) {
+        sequence.push_back(&I);
+        continue ;
+      }
+      if (sequence.size() > 0) {
+        sequences.push_back(sequence);
+        sequence.clear();
+      }
+    }
+    if (sequence.size() > 0) {
+      sequences.push_back(sequence);
+    }
+  }
+
+  /*
+   * Execute each sequence only if the iteration is owned by the replica.
+   * Values of the stage are used only within the iteration that produces them, so they are undefined in the iterations skipped.
+   * This holds for the values pushed to other stages as well: these stages select the ones of the replica that owns the iteration.
+   */
+  for (auto &sequence : sequences) {
+    auto firstInst = sequence.front();
+    auto guardBlock = firstInst->getParent();
+    auto ownedTerminator = SplitBlockAndInsertIfThen(isIterationOwned, firstInst, false);
+    auto ownedBlock = ownedTerminator->getParent();
+    auto continuationBlock = firstInst->getParent();
+    for (auto inst : sequence) {
+      inst->moveBefore(ownedTerminator);
+    }
+
+    for (auto inst : sequence) {
+      if (  false
+            || inst->getType()->isVoidTy()
+            || !inst->isUsedOutsideOfBlock(ownedBlock)
+        ){
+        continue ;
+      }
+      auto mergePHI = PHINode::Create(inst->getType(), 2, "", &*continuationBlock->begin());
+      inst->replaceUsesOutsideBlock(mergePHI, ownedBlock);
+      mergePHI->addIncoming(inst, ownedBlock);
+      mergePHI->addIncoming(UndefValue::get(inst->getType()), guardBlock);
+    }
+  }
+
+  return ;
+}
+
+void DSWP::selectValuesOfReplicatedStages (LoopDependenceInfo *LDI, Noelle &par, int taskIndex) {
+  auto task = (DSWPTask *)this->tasks[taskIndex];
+
+  /*
+   * Check if the stage consumes values of a replicated stage.
+   */
+  if (task->producerToReplicaLoads.size() == 0) {
+    return ;
+  }
+
+  /*
+   * Every replica pushes a value at every iteration, but only the one that owns the iteration pushes a defined one.
+   * Track which replica owns the current iteration the same way replicas do (see distributeIterationsAmongReplicas).
+   */
+  auto loopHeader = LDI->getLoopStructure()->getHeader();
+  auto headerClone = task->getCloneOfOriginalBasicBlock(loopHeader);
+  auto replicas = task->producerToReplicaLoads.begin()->second.size();
+  auto ownerPHI = IVUtility::createChunkPHI(task->getEntry(), headerClone, par.int64, ConstantInt::get(par.int64, replicas));
+
+  /*
+   * Select the value popped from the queue of the owner.
+   */
+  for (auto &producerLoads : task->producerToReplicaLoads) {
+    auto &replicaLoads = producerLoads.second;
+    assert(replicaLoads.size() == replicas);
+
+    /*
+     * Fetch the users of the value; they currently use the one popped from the queue of the first replica.
+     */
+    auto firstLoad = replicaLoads[0];
+    std::vector<Use *> uses;
+    for (auto &use : firstLoad->uses()) {
+      uses.push_back(&use);
+    }
+
+    /*
+     * The values are popped together, so select the right one after the last pop.
+     */
+    std::set<Instruction *> loads(replicaLoads.begin(), replicaLoads.end());
+    Instruction *lastLoad = nullptr;
+    for (auto &I : *firstLoad->getParent()) {
+      if (loads.find(&I) != loads.end()) {
+        lastLoad = &I;
+      }
+    }
+    IRBuilder<> builder(lastLoad->getNextNode());
+    Value *ownerValue = firstLoad;
+    for (uint64_t replicaID = 1; replicaID < replicas; replicaID++) {
+      auto isOwner = builder.CreateICmpEQ(ownerPHI, ConstantInt::get(par.int64, replicaID));
+      ownerValue = builder.CreateSelect(isOwner, replicaLoads[replicaID], ownerValue);
+    }
+    for (auto use : uses) {
+      use->set(ownerValue);
+    }
+  }
 
   return ;
 }
@@ -82,6 +375,9 @@ bool DSWP::isCompleteAndValidStageStructure (LoopDependenceInfo *LDI) const {
   std::set<SCC *> allSCCs;
   for (auto techniqueTask : this->tasks) {
     auto task = (DSWPTask *)techniqueTask;
+    if (task->replicaID > 0) {
+      continue ;
+    }
     for (auto scc : task->stageSCCs) {
       if (allSCCs.find(scc) != allSCCs.end()) {
         errs() << "DSWP:  ERROR! A non-clonable SCC is present in more than one DSWP stage";
@@ -141,11 +437,18 @@ void DSWP::createPipelineFromStages (LoopDependenceInfo *LDI, Noelle &par) {
    */
   auto queueSizesPtr = createQueueSizesArrayFromStages(LDI, builder, par);
 
+  /*
+   * Allocate an array of integers.
+   * Each integer represents the number of pipeline stages that consume each queue.
+   */
+  auto queueConsumersPtr = createQueueConsumersArrayFromStages(LDI, builder, par);
+
   /*
    * Call the stage dispatcher with the environment, queues array, and stages array
    */
   auto queuesCount = cast<Value>(ConstantInt::get(par.int64, this->queues.size()));
   auto stagesCount = cast<Value>(ConstantInt::get(par.int64, this->numTaskInstances));
+  auto loopID = cast<Value>(ConstantInt::get(par.int64, LDI->getID()));
 
   /*
    * Add the call to the task dispatcher
@@ -153,9 +456,11 @@ void DSWP::createPipelineFromStages (LoopDependenceInfo *LDI, Noelle &par) {
   auto runtimeCall = builder.CreateCall(taskDispatcher, ArrayRef<Value*>({
     envPtr,
     queueSizesPtr,
+    queueConsumersPtr,
     stagesPtr,
     stagesCount,
-    queuesCount
+    queuesCount,
+    loopID
   }));
   auto numThreadsUsed = builder.CreateExtractValue(runtimeCall, (uint64_t)0);
 
@@ -210,3 +515,23 @@ Value * DSWP::createQueueSizesArrayFromStages (
 
   return cast<Value>(funcBuilder.CreateBitCast(queuesAlloca, PointerType::getUnqual(par.int64)));
 }
+
+Value * DSWP::createQueueConsumersArrayFromStages (
+  LoopDependenceInfo *LDI,
+  IRBuilder<> funcBuilder,
+  Noelle &par
+) {
+  auto queuesAlloca = cast<Value>(funcBuilder.CreateAlloca(ArrayType::get(par.int64, this->queues.size())));
+  for (int i = 0; i < this->queues.size(); ++i) {
+    auto &queue = this->queues[i];
+    auto queueIndex = cast<Value>(ConstantInt::get(par.int64, i));
+    auto queuePtr = funcBuilder.CreateInBoundsGEP(queuesAlloca, ArrayRef<Value*>({
+      this->zeroIndexForBaseArray,
+      queueIndex
+    }));
+    auto queueCast = funcBuilder.CreateBitCast(queuePtr, PointerType::getUnqual(par.int64));
+    funcBuilder.CreateStore(ConstantInt::get(par.int64, queue->toStages.size()), queueCast);
+  }
+
+  return cast<Value>(funcBuilder.CreateBitCast(queuesAlloca, PointerType::getUnqual(par.int64)));
+}
@@ -68,7 +68,9 @@ void DSWP::printStageQueues (LoopDependenceInfo *LDI) const {
   int count = 0;
   for (auto &queue : this->queues) {
     errs() << "DSWP:    Queue: " << count++ << "\n";
-    queue->producer->print(errs() << "DSWP:     Producer:\t"); errs() << "\n";
+    for (auto producer : queue->producers) {
+      producer->print(errs() << "DSWP:     Producer:\t"); errs() << "\n";
+    }
     for (auto consumer : queue->consumers) {
       consumer->print(errs() << "DSWP:     Consumer:\t"); errs() << "\n";
     }
@@ -187,11 +189,38 @@ void DSWP::writeStageQueuesAsDot (const LoopDependenceInfo &LDI) const {
     return queueGraph.addNode(element, true);
   };
 
+  /*
+   * Fetch the stages a consumer belongs to among the ones a queue delivers to.
+   * Consumers of control queues (branches) are cloned in every stage they control.
+   */
+  auto sccdag = LDI.sccdagAttrs.getSCCDAG();
+  auto getStagesOfConsumer = [&](QueueInfo *queue, Instruction *consumerI) -> std::set<int> {
+    std::set<int> consumerStages;
+    auto consumerSCC = sccdag->sccOfValue(consumerI);
+    for (auto stageIndex : queue->toStages) {
+      auto stage = (DSWPTask *)this->tasks[stageIndex];
+      if (  false
+            || (stage->stageSCCs.find(consumerSCC) != stage->stageSCCs.end())
+            || (stage->clonableSCCs.find(consumerSCC) != stage->clonableSCCs.end())
+        ){
+        consumerStages.insert(stageIndex);
+      }
+    }
+    if (consumerStages.empty()) {
+      return queue->toStages;
+    }
+    return consumerStages;
+  };
+
   for (auto &queue : this->queues) {
-    auto producerNode = addNode(queue->fromStage, queue->producer);
-    for (auto consumerI : queue->consumers) {
-      auto consumerNode = addNode(queue->toStage, consumerI);
-      queueGraph.addEdge(producerNode->getT(), consumerNode->getT());
+    for (auto producerI : queue->producers) {
+      auto producerNode = addNode(queue->fromStage, producerI);
+      for (auto consumerI : queue->consumers) {
+        for (auto stageIndex : getStagesOfConsumer(queue.get(), consumerI)) {
+          auto consumerNode = addNode(stageIndex, consumerI);
+          queueGraph.addEdge(producerNode->getT(), consumerNode->getT());
+        }
+      }
     }
   }
 
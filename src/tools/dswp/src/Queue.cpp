@@ -63,6 +63,7 @@ void DSWP::registerQueue (
   queueInfo->consumers.insert(consumer);
   queueInfo->fromStage = fromStage->getID();
   queueInfo->toStage = toStage->getID();
+  queueInfo->toStages.insert(toStage->getID());
 
   return ;
 }
@@ -184,6 +185,14 @@ std::set<Task *> DSWP::collectTransitivelyControlledTasks (
       Task *dependentTask = getTaskOfNode(dependentNode);
       if (dependentTask) {
         tasksControlledByCondition.insert(dependentTask);
+
+        /*
+         * Replicas of a stage follow the same control flow
+         */
+        auto replicasIt = this->replicasOfStage.find((DSWPTask *)dependentTask);
+        if (replicasIt != this->replicasOfStage.end()) {
+          tasksControlledByCondition.insert(replicasIt->second.begin(), replicasIt->second.end());
+        }
       }
     }
   }
@@ -212,8 +221,16 @@ void DSWP::collectDataAndMemoryQueueInfo (LoopDependenceInfo *LDI, Noelle &par)
           continue;
         }
 
+        /*
+         * Replicas of a stage share its SCCs, so they do not communicate among themselves
+         */
         auto fromStage = this->sccToStage[fromSCC];
-        if (fromStage == toStage) continue;
+        if (  false
+              || (fromStage == toStage)
+              || (toStage->stageSCCs.find(fromSCC) != toStage->stageSCCs.end())
+          ){
+          continue;
+        }
 
         /*
          * Create value queues for each dependency of the form: producer -> consumers
@@ -231,12 +248,161 @@ void DSWP::collectDataAndMemoryQueueInfo (LoopDependenceInfo *LDI, Noelle &par)
           assert(!isMemoryDependence && "FIXME: Support memory synchronization with queues");
 
           registerQueue(par, LDI, fromStage, toStage, producer, consumer, isMemoryDependence);
+
+          /*
+           * Each replica of a parallel stage produces the values of the iterations it owns, so the consumer receives them from all replicas
+           */
+          if (this->replicasOfStage.find(fromStage) != this->replicasOfStage.end()) {
+            for (auto replica : this->replicasOfStage.at(fromStage)) {
+              registerQueue(par, LDI, replica, toStage, producer, consumer, isMemoryDependence);
+            }
+          }
         }
       }
     }
   }
 }
 
+void DSWP::coalesceQueues (void) {
+
+  /*
+   * Group the queues that connect the same pair of stages and whose producers belong to the same basic block.
+   * These producers execute the same number of times, so their values can travel together as a single entry.
+   * Memory dependences are synchronized without values, so their queues are left untouched.
+   */
+  std::vector<std::unique_ptr<QueueInfo>> coalescedQueues;
+  std::map<std::tuple<int, std::set<int>, BasicBlock *>, int> groupToQueue;
+  std::vector<int> oldToNewQueueIndex(this->queues.size());
+  for (auto queueIndex = 0; queueIndex < this->queues.size(); ++queueIndex) {
+    auto queueInfo = std::move(this->queues[queueIndex]);
+    auto group = std::make_tuple(queueInfo->fromStage, queueInfo->toStages, queueInfo->producer->getParent());
+
+    auto groupIt = groupToQueue.find(group);
+    if (  false
+          || queueInfo->isMemoryDependence
+          || (groupIt == groupToQueue.end())
+      ){
+      auto newQueueIndex = coalescedQueues.size();
+      if (!queueInfo->isMemoryDependence) {
+        groupToQueue[group] = newQueueIndex;
+      }
+      coalescedQueues.push_back(std::move(queueInfo));
+      oldToNewQueueIndex[queueIndex] = newQueueIndex;
+      continue ;
+    }
+
+    coalescedQueues[groupIt->second]->pack(queueInfo.get());
+    oldToNewQueueIndex[queueIndex] = groupIt->second;
+  }
+
+  /*
+   * Lay out the entries of the queues that pack several values.
+   * Values are stored in the order they are produced so the entry can be pushed right after the last of them.
+   */
+  for (auto &queueInfo : coalescedQueues) {
+    if (!queueInfo->isPacked()) {
+      continue ;
+    }
+
+    auto producerBlock = queueInfo->producer->getParent();
+    std::unordered_map<Instruction *, int> positionInBlock;
+    auto position = 0;
+    for (auto &I : *producerBlock) {
+      positionInBlock[&I] = position++;
+    }
+    std::sort(queueInfo->producers.begin(), queueInfo->producers.end(), [&positionInBlock](Instruction *a, Instruction *b) -> bool {
+      return positionInBlock[a] < positionInBlock[b];
+    });
+    queueInfo->producer = queueInfo->producers.front();
+
+    std::vector<Type *> fieldTypes;
+    for (auto producer : queueInfo->producers) {
+      fieldTypes.push_back(producer->getType());
+    }
+    auto entryType = StructType::get(producerBlock->getContext(), fieldTypes);
+    queueInfo->dependentType = entryType;
+    queueInfo->bitLength = DataLayout(producerBlock->getModule()).getTypeAllocSize(entryType) * 8;
+  }
+
+  redirectStagesToQueues(coalescedQueues, oldToNewQueueIndex);
+
+  return ;
+}
+
+void DSWP::createBroadcastQueues (void) {
+
+  /*
+   * Merge the queues that carry the same value from a stage to different stages.
+   * Memory dependences are synchronized without values, so their queues are left untouched.
+   */
+  std::vector<std::unique_ptr<QueueInfo>> mergedQueues;
+  std::map<std::pair<int, Instruction *>, int> valueToQueue;
+  std::vector<int> oldToNewQueueIndex(this->queues.size());
+  for (auto queueIndex = 0; queueIndex < this->queues.size(); ++queueIndex) {
+    auto queueInfo = std::move(this->queues[queueIndex]);
+    auto value = std::make_pair(queueInfo->fromStage, queueInfo->producer);
+
+    auto valueIt = valueToQueue.find(value);
+    if (  false
+          || queueInfo->isMemoryDependence
+          || (valueIt == valueToQueue.end())
+      ){
+      auto newQueueIndex = mergedQueues.size();
+      if (!queueInfo->isMemoryDependence) {
+        valueToQueue[value] = newQueueIndex;
+      }
+      mergedQueues.push_back(std::move(queueInfo));
+      oldToNewQueueIndex[queueIndex] = newQueueIndex;
+      continue ;
+    }
+
+    mergedQueues[valueIt->second]->broadcastTo(queueInfo.get());
+    oldToNewQueueIndex[queueIndex] = valueIt->second;
+  }
+
+  redirectStagesToQueues(mergedQueues, oldToNewQueueIndex);
+
+  return ;
+}
+
+void DSWP::redirectStagesToQueues (
+  std::vector<std::unique_ptr<QueueInfo>> &newQueues,
+  std::vector<int> &oldToNewQueueIndex
+) {
+
+  /*
+   * Redirect the stages to the new queues.
+   */
+  for (auto techniqueTask : this->tasks) {
+    auto task = (DSWPTask *)techniqueTask;
+
+    std::set<int> pushValueQueues, popValueQueues;
+    for (auto queueIndex : task->pushValueQueues) {
+      pushValueQueues.insert(oldToNewQueueIndex[queueIndex]);
+    }
+    for (auto queueIndex : task->popValueQueues) {
+      popValueQueues.insert(oldToNewQueueIndex[queueIndex]);
+    }
+    task->pushValueQueues = pushValueQueues;
+    task->popValueQueues = popValueQueues;
+
+    for (auto &producerQueues : task->producerToQueues) {
+      std::set<int> queueIndices;
+      for (auto queueIndex : producerQueues.second) {
+        queueIndices.insert(oldToNewQueueIndex[queueIndex]);
+      }
+      producerQueues.second = queueIndices;
+    }
+    for (auto &producerQueue : task->producedPopQueue) {
+      producerQueue.second = oldToNewQueueIndex[producerQueue.second];
+    }
+  }
+
+  this->queues = std::move(newQueues);
+
+  return ;
+}
+
 bool DSWP::areQueuesAcyclical () const {
 
   /*
@@ -248,19 +414,24 @@ bool DSWP::areQueuesAcyclical () const {
     DSWPTask *task = (DSWPTask *)this->tasks[i];
 
     for (auto queueIdx : task->pushValueQueues) {
-      int toTaskIdx = this->queues[queueIdx]->toStage;
-      if (toTaskIdx <= i) {
-        errs() << "DSWP:  ERROR! Push queue " << queueIdx << " loops back from stage "
-          << i << " to stage " << toTaskIdx;
-        return false;
+      for (auto toTaskIdx : this->queues[queueIdx]->toStages) {
+        if (toTaskIdx <= i) {
+          if (this->verbose != Verbosity::Disabled) {
+            errs() << "DSWP:  Push queue " << queueIdx << " loops back from stage "
+              << i << " to stage " << toTaskIdx << "\n";
+          }
+          return false;
+        }
       }
     }
 
     for (auto queueIdx : task->popValueQueues) {
       int fromTaskIdx = this->queues[queueIdx]->fromStage;
       if (fromTaskIdx >= i) {
-        errs() << "DSWP:  ERROR! Pop queue " << queueIdx << " goes from stage "
-          << fromTaskIdx << " to stage " << i;
+        if (this->verbose != Verbosity::Disabled) {
+          errs() << "DSWP:  Pop queue " << queueIdx << " goes from stage "
+            << fromTaskIdx << " to stage " << i << "\n";
+        }
         return false;
       }
     }
@@ -290,7 +461,7 @@ void DSWP::generateLoadsOfQueuePointers (
       this->zeroIndexForBaseArray,
       queueIndexValue
     }));
-    auto parQueueIndex = par.queues.queueSizeToIndex[queueInfo->bitLength];
+    auto parQueueIndex = par.queues.getQueueIndex(queueInfo->bitLength, queueInfo->isBroadcast());
     auto queueType = par.queues.queueTypes[parQueueIndex];
     auto queueElemType = par.queues.queueElementTypes[parQueueIndex];
     auto queueCast = entryBuilder.CreateBitCast(queuePtr, PointerType::getUnqual(queueType));
@@ -298,6 +469,18 @@ void DSWP::generateLoadsOfQueuePointers (
     auto queueInstrs = std::make_unique<QueueInstrs>();
     queueInstrs->queuePtr = entryBuilder.CreateLoad(queueCast);
     queueInstrs->alloca = entryBuilder.CreateAlloca(queueInfo->dependentType);
+
+    /*
+     * An entry that packs several values travels through a queue of integers if it has the size of one of them, and the queue accesses the entry as such an integer.
+     * Hence, the entry needs the alignment of that integer, which can be stricter than the one of its values.
+     */
+    if (  true
+          && queueInfo->isPacked()
+          && (parQueueIndex != par.queues.entryQueueIndex)
+          && (parQueueIndex != par.queues.broadcastQueueIndex)
+      ){
+      cast<AllocaInst>(queueInstrs->alloca)->setAlignment(queueInfo->bitLength / 8);
+    }
     queueInstrs->allocaCast = entryBuilder.CreateBitCast(
       queueInstrs->alloca,
       PointerType::getUnqual(queueElemType)
@@ -316,7 +499,32 @@ void DSWP::popValueQueues (LoopDependenceInfo *LDI, Noelle &par, int taskIndex)
   for (auto queueIndex : task->popValueQueues) {
     auto &queueInfo = this->queues[queueIndex];
     auto queueInstrs = task->queueInstrMap[queueIndex].get();
-    auto queueCallArgs = ArrayRef<Value*>({ queueInstrs->queuePtr, queueInstrs->allocaCast });
+
+    /*
+     * Values of a replicated stage are popped from the queues of all its replicas.
+     * The one of the first replica is used until selectValuesOfReplicatedStages picks the one of the replica that owns the iteration.
+     */
+    auto fromStage = (DSWPTask *)this->tasks[queueInfo->fromStage];
+    auto mapProducerToLoad = [task, fromStage](Instruction *producer, Instruction *load) -> void {
+      if (fromStage->numberOfReplicas > 1) {
+        auto &replicaLoads = task->producerToReplicaLoads[producer];
+        replicaLoads.resize(fromStage->numberOfReplicas, nullptr);
+        replicaLoads[fromStage->replicaID] = load;
+        if (fromStage->replicaID > 0) {
+          return ;
+        }
+      }
+      task->addInstruction(producer, load);
+    };
+    std::vector<Value *> queueCallArgs{ queueInstrs->queuePtr, queueInstrs->allocaCast };
+
+    /*
+     * A stage that consumes a broadcast queue pops it with its rank among the consumer stages
+     */
+    if (queueInfo->isBroadcast()) {
+      auto consumerID = std::distance(queueInfo->toStages.begin(), queueInfo->toStages.find(task->getID()));
+      queueCallArgs.insert(queueCallArgs.begin() + 1, ConstantInt::get(par.int64, consumerID));
+    }
 
     /*
      * Determine the clone of the basic block of the original producer
@@ -327,14 +535,29 @@ void DSWP::popValueQueues (LoopDependenceInfo *LDI, Noelle &par, int taskIndex)
     auto clonedB = task->getCloneOfOriginalBasicBlock(originalB);
     Instruction *insertionPoint = clonedB->getFirstNonPHIOrDbgOrLifetime();
     IRBuilder<> builder(insertionPoint);
-    auto queuePopFunction = par.queues.queuePops[par.queues.queueSizeToIndex[queueInfo->bitLength]];
+    auto queuePopFunction = par.queues.queuePops[par.queues.getQueueIndex(queueInfo->bitLength, queueInfo->isBroadcast())];
     queueInstrs->queueCall = builder.CreateCall(queuePopFunction, queueCallArgs);
-    queueInstrs->load = builder.CreateLoad(queueInstrs->alloca);
+    if (!queueInfo->isPacked()) {
+      queueInstrs->load = builder.CreateLoad(queueInstrs->alloca);
+
+      /*
+       * Map from producer to queue load 
+       */
+      mapProducerToLoad(queueInfo->producer, cast<Instruction>(queueInstrs->load));
+      continue ;
+    }
 
     /*
-     * Map from producer to queue load 
+     * Map from each producer to the load of its field of the popped entry
      */
-    task->addInstruction(queueInfo->producer, cast<Instruction>(queueInstrs->load));
+    for (auto fieldIndex = 0; fieldIndex < queueInfo->producers.size(); ++fieldIndex) {
+      auto fieldPtr = builder.CreateStructGEP(queueInstrs->alloca, fieldIndex);
+      auto fieldLoad = builder.CreateLoad(fieldPtr);
+      if (fieldIndex == 0) {
+        queueInstrs->load = fieldLoad;
+      }
+      mapProducerToLoad(queueInfo->producers[fieldIndex], cast<Instruction>(fieldLoad));
+    }
   }
 }
 
@@ -346,22 +569,63 @@ void DSWP::pushValueQueues (LoopDependenceInfo *LDI, Noelle &par, int taskIndex)
     auto queueInstrs = task->queueInstrMap[queueIndex].get();
     auto queueInfo = this->queues[queueIndex].get();
     auto queueCallArgs = ArrayRef<Value*>({ queueInstrs->queuePtr, queueInstrs->allocaCast });
-    auto queuePushFunction = par.queues.queuePushes[par.queues.queueSizeToIndex[queueInfo->bitLength]];
+    auto queuePushFunction = par.queues.queuePushes[par.queues.getQueueIndex(queueInfo->bitLength, queueInfo->isBroadcast())];
 
     /*
      * Store the produced value immediately
      * Push the value immediately
+     *
+     * An entry that packs several values is pushed as soon as the last of them is produced
      */
-    auto producerBlock = queueInfo->producer->getParent();
-    auto producerClone = task->getCloneOfOriginalInstruction(queueInfo->producer);
+    auto lastProducer = queueInfo->producers.back();
+    auto producerClone = task->getCloneOfOriginalInstruction(lastProducer);
     auto producerCloneBlock = producerClone->getParent();
     auto insertPoint = producerClone->getNextNode();
     if (isa<PHINode>(insertPoint)) {
       insertPoint = producerCloneBlock->getFirstNonPHIOrDbgOrLifetime();
     }
     IRBuilder<> builder(insertPoint);
-    builder.CreateStore(producerClone, queueInstrs->alloca);
+    if (!queueInfo->isPacked()) {
+      builder.CreateStore(producerClone, queueInstrs->alloca);
+    } else {
+      for (auto fieldIndex = 0; fieldIndex < queueInfo->producers.size(); ++fieldIndex) {
+        auto fieldClone = task->getCloneOfOriginalInstruction(queueInfo->producers[fieldIndex]);
+        auto fieldPtr = builder.CreateStructGEP(queueInstrs->alloca, fieldIndex);
+        builder.CreateStore(fieldClone, fieldPtr);
+      }
+    }
     queueInstrs->queueCall = builder.CreateCall(queuePushFunction, queueCallArgs);
 
+    /*
+     * Publish the value immediately if batching it could block a stage
+     */
+    if (this->publishEachPush) {
+      auto queueFlushFunction = par.queues.queueFlushes[par.queues.getQueueIndex(queueInfo->bitLength, queueInfo->isBroadcast())];
+      queueInstrs->flushCall = builder.CreateCall(queueFlushFunction, ArrayRef<Value*>({ queueInstrs->queuePtr }));
+    }
   }
 }
+
+void DSWP::flushPushQueues (Noelle &par, int taskIndex) {
+  auto task = (DSWPTask *)this->tasks[taskIndex];
+
+  /*
+   * Check if values have been published by the pushes already
+   */
+  if (this->publishEachPush) {
+    return ;
+  }
+
+  /*
+   * Publish the last (partial) batch of each queue at the exit of the stage
+   */
+  IRBuilder<> builder(task->getExit()->getTerminator());
+  for (auto queueIndex : task->pushValueQueues) {
+    auto queueInstrs = task->queueInstrMap[queueIndex].get();
+    auto queueInfo = this->queues[queueIndex].get();
+    auto queueFlushFunction = par.queues.queueFlushes[par.queues.getQueueIndex(queueInfo->bitLength, queueInfo->isBroadcast())];
+    queueInstrs->flushCall = builder.CreateCall(queueFlushFunction, ArrayRef<Value*>({ queueInstrs->queuePtr }));
+  }
+
+  return ;
+}
@@ -19,7 +19,8 @@ namespace llvm::noelle {
       LoopUnroll &loopUnroll,
       LoopWhilifier &loopWhilifier,
       LoopInvariantCodeMotion &loopInvariantCodeMotion,
-      SCEVSimplification &scevSimplification
+      SCEVSimplification &scevSimplification,
+      LoopCollapser &loopCollapser
       ){
 
     /*
@@ -85,9 +86,53 @@ namespace llvm::noelle {
       }
     }
 
+    /*
+     * Collapse perfectly nested loops.
+     */
+    if (par.isTransformationEnabled(Transformation::LOOP_COLLAPSE_ID)){
+      errs() << "EnablersManager:   Try to collapse perfectly nested loops\n";
+      if (this->applyLoopCollapse(LDI, par, loopCollapser)){
+        errs() << "EnablersManager:     The loop has been collapsed with its nested loop\n";
+        return true;
+      }
+    }
+
     return false;
   }
 
+  bool EnablersManager::applyLoopCollapse (
+      LoopDependenceInfo *LDI,
+      Noelle &par,
+      LoopCollapser &loopCollapser
+      ){
+
+    /*
+     * Collapsing a loop nest is useful only if the collapsed loop can then run its iterations in parallel (e.g., by DOALL).
+     * This is the case if neither the outer loop nor the inner one carries data dependences that cannot be removed.
+     */
+    auto ls = LDI->getLoopStructure();
+    auto subLoops = ls->getChildren();
+    if (subLoops.size() != 1){
+      return false;
+    }
+    if (LDI->getSCCBlockingParallelization() != nullptr){
+      return false;
+    }
+    auto innerLDI = par.getLoop(*subLoops.begin());
+    auto isInnerLoopParallelizable = (innerLDI->getSCCBlockingParallelization() == nullptr);
+    delete innerLDI;
+    if (!isInnerLoopParallelizable){
+      return false;
+    }
+
+    /*
+     * Collapse the loops.
+     */
+    auto modified = loopCollapser.collapseLoop(*LDI);
+
+    return modified;
+  }
+
   bool EnablersManager::applyLoopWhilifier (
       LoopDependenceInfo *LDI,
       Noelle &par,
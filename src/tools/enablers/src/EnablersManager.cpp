@@ -46,6 +46,7 @@ namespace llvm::noelle {
     auto loopWhilify = LoopWhilifier(noelle);
     auto loopInvariantCodeMotion = LoopInvariantCodeMotion(noelle);
     auto scevSimplification = SCEVSimplification(noelle);
+    auto loopCollapse = LoopCollapser();
 
     /*
     * Fetch all the loops we want to parallelize.
@@ -88,7 +89,8 @@ namespace llvm::noelle {
         loopUnroll,
         loopWhilify,
         loopInvariantCodeMotion,
-        scevSimplification
+        scevSimplification,
+        loopCollapse
       );
       modified |= modifiedFunctions[f];
     }
@@ -23,6 +23,7 @@
 #include "LoopWhilify.hpp"
 #include "LoopInvariantCodeMotion.hpp"
 #include "SCEVSimplification.hpp"
+#include "LoopCollapse.hpp"
 
 namespace llvm::noelle {
 
@@ -64,7 +65,8 @@ namespace llvm::noelle {
         LoopUnroll &loopUnroll,
         LoopWhilifier &LoopWhilifier,
         LoopInvariantCodeMotion &loopInvariantCodeMotion,
-        SCEVSimplification &scevSimplification
+        SCEVSimplification &scevSimplification,
+        LoopCollapser &loopCollapser
         );
 
       bool applyLoopWhilifier (
@@ -79,6 +81,12 @@ namespace llvm::noelle {
           LoopDistribution &loopDist
         );
 
+      bool applyLoopCollapse (
+          LoopDependenceInfo *LDI,
+          Noelle &par,
+          LoopCollapser &loopCollapser
+        );
+
       bool applyDevirtualizer (
         LoopDependenceInfo *LDI,
         Noelle &par,
@@ -26,6 +26,7 @@
 namespace llvm::noelle {
 
   class SpilledLoopCarriedDependency;
+  class ForwardedLoopCarriedDependency;
 
   class HELIX : public ParallelizationTechniqueForLoopsWithLoopCarriedDataDependences {
     public:
@@ -52,6 +53,12 @@ namespace llvm::noelle {
         Heuristics *h
         ) const override ;
 
+      double estimateParallelExecutionTime (
+        LoopDependenceInfo *LDI, 
+        Noelle &par, 
+        Heuristics *h
+        ) const override ;
+
       PDG * constructTaskInternalDependenceGraphFromOriginalLoopDG (
         LoopDependenceInfo *LDI,
         PostDominatorTree &postDomTreeOfTaskFunction
@@ -121,7 +128,15 @@ namespace llvm::noelle {
       std::vector<SequentialSegment *> identifySequentialSegments (
         LoopDependenceInfo *originalLDI,
         LoopDependenceInfo *LDI,
-        DataFlowResult *reachabilityDFR
+        DataFlowResult *reachabilityDFR,
+        Heuristics *h
+      );
+
+      void mergeSequentialSegmentSets (
+        LoopDependenceInfo *originalLDI,
+        std::vector<SCCSet *> &ssSets,
+        std::unordered_map<SCC *, SCC *> &taskToOriginalFunctionSCCMap,
+        Heuristics *h
       );
  
       void squeezeSequentialSegments (
@@ -141,6 +156,13 @@ namespace llvm::noelle {
         std::vector<SequentialSegment *> *sss
       );
 
+      std::unordered_map<int32_t, std::vector<ForwardedLoopCarriedDependency>> forwardLoopCarriedDataDependencies (
+        LoopDependenceInfo *LDI,
+        std::vector<SequentialSegment *> *sss,
+        std::vector<Value *> &ssPastPtrs,
+        std::vector<Value *> &ssFuturePtrs
+      );
+
       void inlineCalls (
         void
       );
@@ -149,6 +171,12 @@ namespace llvm::noelle {
         LoopDependenceInfo *LDI
       );
 
+      uint64_t computeNumberOfIterationsPerBatch (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        Heuristics *h
+      ) const ;
+
     private:
       Function *waitSSCall, *signalSSCall;
       LoopDependenceInfo *originalLDI;
@@ -159,6 +187,13 @@ namespace llvm::noelle {
       std::unordered_map<Instruction *, Instruction *> lastIterationExecutionDuplicateMap;
       BasicBlock *lastIterationExecutionBlock;
 
+      /*
+       * Each core executes batches of consecutive iterations and it passes the sequential segments to the next core only at the end of a batch.
+       * The PHI counts the iterations of the current batch that have been executed (it is null when batches have a single iteration).
+       */
+      uint64_t iterationsPerBatch;
+      PHINode *batchIterationPHI;
+
       void squeezeSequentialSegment (
         LoopDependenceInfo *LDI,
         DataFlowResult *reachabilityDFR,
@@ -167,6 +202,8 @@ namespace llvm::noelle {
 
       DataFlowResult *computeReachabilityFromInstructions (LoopDependenceInfo *LDI) ;
 
+      uint64_t computeNumberOfSequentialSegments (LoopDependenceInfo *LDI) const ;
+
   };
 
   class SpilledLoopCarriedDependency {
@@ -178,4 +215,11 @@ namespace llvm::noelle {
       std::unordered_set<StoreInst *> environmentStores;
   };
 
+  class ForwardedLoopCarriedDependency {
+    public:
+      AllocaInst *localCopy;
+      Value *pastValuePtr;
+      Value *futureValuePtr;
+  };
+
 }
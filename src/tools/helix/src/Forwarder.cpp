@@ -0,0 +1,155 @@
+/*
+ * Copyright 2016 - 2019  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "HELIX.hpp"
+#include "HELIXTask.hpp"
+#include "Architecture.hpp"
+
+using namespace llvm ;
+
+static cl::opt<bool> DisableForwarding("noelle-helix-disable-forwarding", cl::ZeroOrMore, cl::Hidden, cl::desc("Keep the loop-carried values of HELIX loops in the loop-carried environment rather than in the cache lines of the sequential segments that protect them"));
+
+std::unordered_map<int32_t, std::vector<ForwardedLoopCarriedDependency>> HELIX::forwardLoopCarriedDataDependencies (
+  LoopDependenceInfo *LDI,
+  std::vector<SequentialSegment *> *sss,
+  std::vector<Value *> &ssPastPtrs,
+  std::vector<Value *> &ssFuturePtrs
+){
+  std::unordered_map<int32_t, std::vector<ForwardedLoopCarriedDependency>> forwardedDependences;
+  if (DisableForwarding) {
+    return forwardedDependences;
+  }
+
+  /*
+   * Fetch the task and the loop.
+   */
+  auto helixTask = static_cast<HELIXTask *>(this->tasks[0]);
+  auto loopStructure = LDI->getLoopStructure();
+  auto &DL = this->module.getDataLayout();
+  auto &cxt = this->module.getContext();
+  auto int64 = IntegerType::get(cxt, 64);
+  auto entryBlock = helixTask->getEntry();
+  IRBuilder<> entryBuilder(entryBlock->getTerminator());
+
+  /*
+   * Fetch the instructions of each sequential segment.
+   */
+  std::unordered_map<SequentialSegment *, std::unordered_set<Instruction *>> ssInstructions;
+  for (auto ss : *sss) {
+    ssInstructions[ss] = ss->getInstructions();
+  }
+
+  /*
+   * The lock of a sequential segment is at the beginning of its cache line.
+   * Loop-carried values protected by the sequential segment are placed in the rest of the line.
+   */
+  std::unordered_map<int32_t, uint64_t> firstFreeByteOfSS;
+  for (auto ss : *sss) {
+    firstFreeByteOfSS[ss->getID()] = DL.getTypeAllocSize(int64);
+  }
+
+  /*
+   * Define a helper to fetch the pointer to a value stored in the cache line of a sequential segment entry
+   */
+  auto fetchValuePtr = [&entryBuilder, int64](Value *ssEntry, uint64_t offset, Type *valueType) -> Value * {
+    auto ssEntryAsInt = entryBuilder.CreatePtrToInt(ssEntry, int64);
+    auto valueAsInt = entryBuilder.CreateAdd(ConstantInt::get(int64, offset), ssEntryAsInt);
+    return entryBuilder.CreateIntToPtr(valueAsInt, PointerType::getUnqual(valueType));
+  };
+
+  Value *isFirstCore = nullptr;
+  for (auto spill : this->spills) {
+
+    /*
+     * Identify the sequential segment that protects every access of the spilled variable within the loop.
+     *
+     * NOTE: Loads after the loop are executed after waiting for all sequential segments, so they do not need to be protected.
+     */
+    std::vector<Instruction *> accesses{spill->environmentStores.begin(), spill->environmentStores.end()};
+    accesses.insert(accesses.end(), spill->environmentLoads.begin(), spill->environmentLoads.end());
+    SequentialSegment *protectingSS = nullptr;
+    auto isProtectedBySingleSS = true;
+    for (auto access : accesses) {
+      if (!loopStructure->isIncluded(access)) continue;
+
+      SequentialSegment *ssOfAccess = nullptr;
+      for (auto ss : *sss) {
+        if (ssInstructions[ss].find(access) == ssInstructions[ss].end()) continue;
+        ssOfAccess = ss;
+        break;
+      }
+      if (  false
+            || (ssOfAccess == nullptr)
+            || ((protectingSS != nullptr) && (protectingSS != ssOfAccess))
+        ){
+        isProtectedBySingleSS = false;
+        break;
+      }
+      protectingSS = ssOfAccess;
+    }
+    if (  false
+          || !isProtectedBySingleSS
+          || (protectingSS == nullptr)
+      ){
+      continue ;
+    }
+
+    /*
+     * Check that the value fits in the cache line of the sequential segment.
+     */
+    auto anyStore = *spill->environmentStores.begin();
+    auto envPtr = anyStore->getPointerOperand();
+    auto valueType = anyStore->getValueOperand()->getType();
+    auto valueBytes = DL.getTypeAllocSize(valueType);
+    auto valueAlignment = DL.getABITypeAlignment(valueType);
+    auto ssID = protectingSS->getID();
+    auto offset = alignTo(firstFreeByteOfSS[ssID], valueAlignment);
+    if (offset + valueBytes > Architecture::getCacheLineBytes()) {
+      continue ;
+    }
+    firstFreeByteOfSS[ssID] = offset + valueBytes;
+
+    /*
+     * Keep the value of the current core in a local copy.
+     * The local copy is received from the previous core when waiting for the sequential segment and sent to the next core when signaling it.
+     */
+    ForwardedLoopCarriedDependency forwarded;
+    forwarded.localCopy = entryBuilder.CreateAlloca(valueType);
+    forwarded.localCopy->moveBefore(entryBlock->getFirstNonPHIOrDbgOrLifetime());
+    forwarded.pastValuePtr = fetchValuePtr(ssPastPtrs.at(ssID), offset, valueType);
+    forwarded.futureValuePtr = fetchValuePtr(ssFuturePtrs.at(ssID), offset, valueType);
+    forwardedDependences[ssID].push_back(forwarded);
+
+    /*
+     * The first core receives the initial value from the loop-carried environment.
+     * Other cores write their local copy instead, as the cache line they receive from is written by the previous core.
+     */
+    if (isFirstCore == nullptr) {
+      isFirstCore = entryBuilder.CreateICmpEQ(
+        helixTask->coreArg,
+        ConstantInt::get(helixTask->coreArg->getType(), 0)
+      );
+    }
+    auto initialValuePtr = entryBuilder.CreateSelect(isFirstCore, forwarded.pastValuePtr, forwarded.localCopy);
+    entryBuilder.CreateStore(entryBuilder.CreateLoad(envPtr), initialValuePtr);
+
+    /*
+     * Redirect the accesses of the spilled variable to the local copy.
+     */
+    for (auto store : spill->environmentStores) {
+      store->setOperand(StoreInst::getPointerOperandIndex(), forwarded.localCopy);
+    }
+    for (auto load : spill->environmentLoads) {
+      load->setOperand(LoadInst::getPointerOperandIndex(), forwarded.localCopy);
+    }
+  }
+
+  return forwardedDependences;
+}
@@ -11,6 +11,8 @@
 #include "HELIX.hpp"
 #include "HELIXTask.hpp"
 
+static cl::opt<bool> DisableBatching("noelle-helix-disable-batching", cl::ZeroOrMore, cl::Hidden, cl::desc("Pass the sequential segments of HELIX loops from a core to the next one at every iteration rather than at the end of batches of iterations"));
+
 HELIX::HELIX (
   Module &module, 
   Hot &p,
@@ -19,7 +21,7 @@ HELIX::HELIX (
   )
   : ParallelizationTechniqueForLoopsWithLoopCarriedDataDependences{module, p, forceParallelization, v},
     loopCarriedEnvBuilder{nullptr}, taskFunctionDG{nullptr},
-    lastIterationExecutionBlock{nullptr}
+    lastIterationExecutionBlock{nullptr}, iterationsPerBatch{1}, batchIterationPHI{nullptr}
   {
 
   /*
@@ -85,6 +87,9 @@ void HELIX::reset () {
   }
   lastIterationExecutionDuplicateMap.clear();
 
+  iterationsPerBatch = 1;
+  batchIterationPHI = nullptr;
+
 }
 
 bool HELIX::canBeAppliedToLoop (LoopDependenceInfo *LDI, Noelle &par, Heuristics *h) const {
@@ -134,6 +139,119 @@ bool HELIX::canBeAppliedToLoop (LoopDependenceInfo *LDI, Noelle &par, Heuristics
   return true ;
 }
 
+double HELIX::estimateParallelExecutionTime (
+  LoopDependenceInfo *LDI,
+  Noelle &par,
+  Heuristics *h
+) const {
+
+  /*
+   * Fetch the profiles.
+   */
+  auto profiles = par.getProfiles();
+  auto loopStructure = LDI->getLoopStructure();
+  auto totalInstructions = (double)profiles->getTotalInstructions(loopStructure);
+  auto iterations = (double)profiles->getIterations(loopStructure);
+  if (iterations == 0){
+    return totalInstructions + this->estimateDispatchTime(LDI, par, h);
+  }
+
+  /*
+   * Iterations run in parallel, but the sequential segments of consecutive iterations cannot overlap.
+   * Moreover, every batch of iterations waits for the signals of the previous one before running its sequential segments.
+   * Hence, the execution is bound by both the parallel work and the chain of sequential segments across iterations.
+   */
+  auto sequentialSegments = this->computeNumberOfSequentialSegments(LDI);
+  auto iterationsPerBatch = (double)this->computeNumberOfIterationsPerBatch(LDI, par, h);
+  auto cores = this->computeNumberOfCoresUsablePerInvocation(LDI, par);
+  auto sequentialFraction = (double)this->computeSequentialFractionOfExecution(LDI, par);
+  auto instructionsPerIteration = totalInstructions / iterations;
+  auto synchronizationPerIteration = (double)(sequentialSegments * h->getInvocationLatency().synchronizationLatency()) / iterationsPerBatch;
+  auto parallelTime = totalInstructions / cores;
+  auto sequentialChainTime = iterations * ((sequentialFraction * instructionsPerIteration) + synchronizationPerIteration);
+  if (sequentialChainTime > parallelTime){
+    parallelTime = sequentialChainTime;
+  }
+
+  return parallelTime + this->estimateDispatchTime(LDI, par, h);
+}
+
+uint64_t HELIX::computeNumberOfSequentialSegments (LoopDependenceInfo *LDI) const {
+
+  /*
+   * Count the sequential segments that every iteration needs to synchronize.
+   */
+  uint64_t sequentialSegments = 0;
+  for (auto scc : LDI->sccdagAttrs.getSCCsWithLoopCarriedDependencies()) {
+    auto sccInfo = LDI->sccdagAttrs.getSCCAttrs(scc);
+    if (  false
+          || sccInfo->canExecuteReducibly()
+          || sccInfo->canBeCloned()
+          || LDI->isSCCContainedInSubloop(scc)
+      ){
+      continue ;
+    }
+    sequentialSegments++;
+  }
+
+  return sequentialSegments;
+}
+
+uint64_t HELIX::computeNumberOfIterationsPerBatch (
+  LoopDependenceInfo *LDI,
+  Noelle &par,
+  Heuristics *h
+) const {
+  if (DisableBatching) {
+    return 1;
+  }
+
+  /*
+   * Without profiles, we cannot tell whether signals dominate the execution of an iteration.
+   */
+  auto profiles = par.getProfiles();
+  if (!profiles->isAvailable()) {
+    return 1;
+  }
+  auto loopStructure = LDI->getLoopStructure();
+  auto iterations = profiles->getIterations(loopStructure);
+  if (iterations == 0){
+    return 1;
+  }
+
+  /*
+   * A batch must not be bigger than the share of iterations of a core; otherwise, some cores would stay idle.
+   */
+  auto cores = this->computeNumberOfCoresUsablePerInvocation(LDI, par);
+  auto averageIterations = profiles->getAverageLoopIterationsPerInvocation(loopStructure);
+  auto maximumIterationsPerBatch = (uint64_t)(averageIterations / cores);
+  if (maximumIterationsPerBatch <= 1){
+    return 1;
+  }
+
+  /*
+   * Each batch passes every sequential segment to the next core once.
+   * Choose the smallest batch whose parallel work is at least the latency of these signals.
+   */
+  auto sequentialSegments = this->computeNumberOfSequentialSegments(LDI);
+  auto signalLatency = (double)(sequentialSegments * h->getInvocationLatency().synchronizationLatency());
+  auto instructionsPerIteration = ((double)profiles->getTotalInstructions(loopStructure)) / ((double)iterations);
+  auto sequentialFraction = (double)this->computeSequentialFractionOfExecution(LDI, par);
+  auto parallelInstructionsPerIteration = instructionsPerIteration * (1 - sequentialFraction);
+  if (parallelInstructionsPerIteration <= 0){
+    return maximumIterationsPerBatch;
+  }
+  auto iterationsPerBatch = (uint64_t)std::ceil(signalLatency / parallelInstructionsPerIteration);
+  if (iterationsPerBatch < 1){
+    iterationsPerBatch = 1;
+  }
+  if (iterationsPerBatch > maximumIterationsPerBatch){
+    iterationsPerBatch = maximumIterationsPerBatch;
+  }
+
+  return iterationsPerBatch;
+}
+
 bool HELIX::apply (
   LoopDependenceInfo *LDI,
   Noelle &par,
@@ -172,12 +290,18 @@ void HELIX::createParallelizableTask (
    */
   this->originalLDI = LDI;
 
+  /*
+   * Decide how many consecutive iterations each core executes before passing the sequential segments to the next core.
+   */
+  this->iterationsPerBatch = this->computeNumberOfIterationsPerBatch(LDI, par, h);
+
   /*
    * Print the parallelization request.
    */
   if (this->verbose != Verbosity::Disabled) {
     errs() << "HELIX: Start the parallelization\n";
     errs() << "HELIX:   Number of threads to extract = " << LDI->getMaximumNumberOfCores() << "\n";
+    errs() << "HELIX:   Iterations per batch = " << this->iterationsPerBatch << "\n";
     auto nonDOALLSCCs = LDI->sccdagAttrs.getSCCsWithLoopCarriedDependencies();
     for (auto scc : nonDOALLSCCs) {
 
@@ -374,7 +498,7 @@ bool HELIX::synchronizeTask (
    * aren't adjusted after squeezing. Delay computing entry and exit frontiers for identified
    * sequential segments until AFTER squeezing.
    */
-  auto sequentialSegments = this->identifySequentialSegments(originalLDI, LDI, reachabilityDFR);
+  auto sequentialSegments = this->identifySequentialSegments(originalLDI, LDI, reachabilityDFR, h);
   this->squeezeSequentialSegments(LDI, &sequentialSegments, reachabilityDFR);
   delete reachabilityDFR;
   for (auto ss : sequentialSegments) delete ss;
@@ -387,7 +511,7 @@ bool HELIX::synchronizeTask (
     errs() << "HELIX:  Identifying sequential segments\n";
   }
   reachabilityDFR = this->computeReachabilityFromInstructions(LDI);
-  sequentialSegments = this->identifySequentialSegments(originalLDI, LDI, reachabilityDFR);
+  sequentialSegments = this->identifySequentialSegments(originalLDI, LDI, reachabilityDFR, h);
 
   /*
    * Schedule the sequential segments to overlap parallel and sequential segments.
@@ -508,7 +632,7 @@ bool HELIX::synchronizeTask (
   /*
    * Inline calls to HELIX functions.
    */
-  // this->inlineCalls();
+  this->inlineCalls();
 
   /*
    * Print the HELIX task.
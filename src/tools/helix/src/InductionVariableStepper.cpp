@@ -73,9 +73,19 @@ void HELIX::rewireLoopForIVsToIterateNthIterations(LoopDependenceInfo *LDI) {
    */
   auto clonedStepSizeMap = cloneIVStepValueComputation(LDI, 0, entryBuilder);
 
+  /*
+   * Generate PHI to track the iterations of the current batch executed by the core
+   * (only if each core executes more than one consecutive iteration at a time)
+   */
+  if (this->iterationsPerBatch > 1) {
+    auto int64 = IntegerType::get(task->getTaskBody()->getContext(), 64);
+    auto batchSize = ConstantInt::get(int64, this->iterationsPerBatch);
+    this->batchIterationPHI = IVUtility::createChunkPHI(preheaderClone, headerClone, int64, batchSize);
+  }
+
   /*
    * Determine start value of the IV for the task
-   * core_start: original_start + original_step_size * core_id
+   * core_start: original_start + original_step_size * core_id * batch_size
    */
   for (auto ivInfo : ivInfos) {
     auto startOfIV = fetchClone(ivInfo->getStartValue());
@@ -83,12 +93,20 @@ void HELIX::rewireLoopForIVsToIterateNthIterations(LoopDependenceInfo *LDI) {
     auto originalIVPHI = ivInfo->getLoopEntryPHI();
     auto ivPHI = cast<PHINode>(fetchClone(originalIVPHI));
 
+    auto firstIterationOfCore = entryBuilder.CreateZExtOrTrunc(
+      task->coreArg,
+      stepOfIV->getType()
+    );
+    if (this->batchIterationPHI) {
+      firstIterationOfCore = entryBuilder.CreateMul(
+        firstIterationOfCore,
+        ConstantInt::get(stepOfIV->getType(), this->iterationsPerBatch),
+        "coreIdx_X_batchSize"
+      );
+    }
     auto nthCoreOffset = entryBuilder.CreateMul(
       stepOfIV,
-      entryBuilder.CreateZExtOrTrunc(
-        task->coreArg,
-        stepOfIV->getType()
-      ),
+      firstIterationOfCore,
       "stepSize_X_coreIdx"
     );
 
@@ -98,7 +116,9 @@ void HELIX::rewireLoopForIVsToIterateNthIterations(LoopDependenceInfo *LDI) {
 
   /*
    * Determine additional step size to account for n cores each executing the task
-   * jump_step_size: original_step_size * (num_cores - 1)
+   * jump_step_size: original_step_size * (num_cores - 1) * batch_size
+   *
+   * With batches, the additional step is taken only at the end of a batch.
    */
   for (auto ivInfo : ivInfos) {
     auto stepOfIV = clonedStepSizeMap.at(ivInfo);
@@ -117,7 +137,16 @@ void HELIX::rewireLoopForIVsToIterateNthIterations(LoopDependenceInfo *LDI) {
       "nCoresStepSize"
     );
 
-    IVUtility::stepInductionVariablePHI(preheaderClone, ivPHI, jumpStepSize);
+    if (this->batchIterationPHI == nullptr) {
+      IVUtility::stepInductionVariablePHI(preheaderClone, ivPHI, jumpStepSize);
+      continue ;
+    }
+    auto batchStepSize = entryBuilder.CreateMul(
+      jumpStepSize,
+      ConstantInt::get(stepOfIV->getType(), this->iterationsPerBatch),
+      "nCoresStepSize_X_batchSize"
+    );
+    IVUtility::chunkInductionVariablePHI(preheaderClone, ivPHI, this->batchIterationPHI, batchStepSize);
   }
 
   /*
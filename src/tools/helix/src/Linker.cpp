@@ -10,6 +10,7 @@
  */
 #include "HELIX.hpp"
 #include "HELIXTask.hpp"
+#include "Architecture.hpp"
 
 using namespace llvm ;
 
@@ -53,6 +54,16 @@ void HELIX::addChunkFunctionExecutionAsideOriginalLoop (
    */
   auto numOfSS = ConstantInt::get(par.int64, numberOfSequentialSegments);
 
+  /*
+   * Fetch the size of a sequential segment entry, which must match the offsets used by the task.
+   */
+  auto ssSize = ConstantInt::get(par.int64, Architecture::getCacheLineBytes());
+
+  /*
+   * Fetch the loop ID.
+   */
+  auto loopID = ConstantInt::get(par.int64, LDI->getID());
+
   /*
    * Call the function that incudes the parallelized loop.
    */
@@ -62,7 +73,9 @@ void HELIX::addChunkFunctionExecutionAsideOriginalLoop (
     envPtr,
     loopCarriedEnvPtr,
     numCores,
-    numOfSS
+    numOfSS,
+    ssSize,
+    loopID
   }));
   auto numThreadsUsed = helixBuilder.CreateExtractValue(runtimeCall, (uint64_t)0);
 
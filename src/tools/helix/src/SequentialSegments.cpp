@@ -16,7 +16,8 @@ using namespace llvm ;
 std::vector<SequentialSegment *> HELIX::identifySequentialSegments (
   LoopDependenceInfo *originalLDI,
   LoopDependenceInfo *LDI,
-  DataFlowResult *reachabilityDFR
+  DataFlowResult *reachabilityDFR,
+  Heuristics *h
 ){
 
   auto helixTask = static_cast<HELIXTask *>(this->tasks[0]);
@@ -108,9 +109,9 @@ std::vector<SequentialSegment *> HELIX::identifySequentialSegments (
   auto depsSCCs = LDI->sccdagAttrs.getSCCsWithLoopCarriedDataDependencies();
 
   /*
-   * Allocate the sequential segments, one per partition.
+   * Identify the partitions that require a sequential segment.
    */
-  int32_t ssID = 0;
+  std::vector<SCCSet *> ssSets;
   for (auto set : sets){
 
     /*
@@ -164,6 +165,19 @@ std::vector<SequentialSegment *> HELIX::identifySequentialSegments (
     if (!requireSS){
       continue ;
     }
+    ssSets.push_back(set);
+  }
+
+  /*
+   * Decide which sequential segments to merge.
+   */
+  this->mergeSequentialSegmentSets(originalLDI, ssSets, taskToOriginalFunctionSCCMap, h);
+
+  /*
+   * Allocate the sequential segments, one per partition that requires it.
+   */
+  int32_t ssID = 0;
+  for (auto set : ssSets){
 
     /*
      * Allocate a sequential segment.
@@ -179,3 +193,119 @@ std::vector<SequentialSegment *> HELIX::identifySequentialSegments (
 
   return sss;
 }
+
+void HELIX::mergeSequentialSegmentSets (
+  LoopDependenceInfo *originalLDI,
+  std::vector<SCCSet *> &ssSets,
+  std::unordered_map<SCC *, SCC *> &taskToOriginalFunctionSCCMap,
+  Heuristics *h
+){
+
+  /*
+   * The decision relies on the time spent in each sequential segment, so we need profiles.
+   */
+  if (ssSets.size() < 2) {
+    return ;
+  }
+  if (!this->profile.isAvailable()) {
+    return ;
+  }
+  auto originalLoop = originalLDI->getLoopStructure();
+  auto iterations = (double)this->profile.getIterations(originalLoop);
+  if (iterations == 0){
+    return ;
+  }
+
+  /*
+   * Compute the instructions executed within each sequential segment per iteration.
+   */
+  std::unordered_map<SCCSet *, double> sequentialInstructions;
+  for (auto set : ssSets){
+    uint64_t instructions = 0;
+    for (auto scc : set->sccs){
+      if (taskToOriginalFunctionSCCMap.find(scc) == taskToOriginalFunctionSCCMap.end()) continue;
+      auto originalSCC = taskToOriginalFunctionSCCMap.at(scc);
+      instructions += this->profile.getTotalInstructions(originalSCC);
+    }
+    sequentialInstructions[set] = ((double)instructions) / iterations;
+  }
+
+  /*
+   * Define the estimated time per iteration of a HELIX execution with the given sequential segments.
+   *
+   * Every sequential segment adds the latency of a signal to each iteration of a core.
+   * Moreover, a sequential segment runs one iteration at a time: the next iteration enters it only after having received the signal.
+   * Hence, separate segments cost more waits, but they overlap with each other across iterations, while a merged segment is a longer chain.
+   */
+  auto signalLatency = (double)h->getInvocationLatency().synchronizationLatency();
+  auto instructionsPerIteration = this->profile.getAverageTotalInstructionsPerIteration(originalLoop);
+  auto cores = (double)originalLDI->getMaximumNumberOfCores();
+  auto estimateTimePerIteration = [&](uint64_t numberOfSegments, double longestSegment) -> double {
+    auto parallelTime = (instructionsPerIteration + (numberOfSegments * signalLatency)) / cores;
+    auto chainTime = longestSegment + signalLatency;
+    return std::max(parallelTime, chainTime);
+  };
+  auto computeLongestSegment = [&](void) -> double {
+    double longestSegment = 0;
+    for (auto set : ssSets){
+      longestSegment = std::max(longestSegment, sequentialInstructions[set]);
+    }
+    return longestSegment;
+  };
+
+  /*
+   * Greedily merge the pair of sequential segments that reduces the estimated time the most, until no merge reduces it.
+   */
+  auto mergedSegments = 0;
+  while (ssSets.size() > 1){
+    auto longestSegment = computeLongestSegment();
+    auto bestTime = estimateTimePerIteration(ssSets.size(), longestSegment);
+    SCCSet *bestSetA = nullptr;
+    SCCSet *bestSetB = nullptr;
+    for (auto i = 0; i < ssSets.size(); i++){
+      for (auto j = i + 1; j < ssSets.size(); j++){
+        auto setA = ssSets[i];
+        auto setB = ssSets[j];
+
+        /*
+         * Merging two segments that depend on each other through other partitions would merge these partitions as well.
+         */
+        if (this->partitioner->isMergeIntroducingCycle(setA, setB)) continue;
+
+        auto mergedTime = estimateTimePerIteration(
+          ssSets.size() - 1,
+          std::max(longestSegment, sequentialInstructions[setA] + sequentialInstructions[setB])
+        );
+        if (mergedTime >= bestTime) continue;
+        bestTime = mergedTime;
+        bestSetA = setA;
+        bestSetB = setB;
+      }
+    }
+    if (bestSetA == nullptr){
+      break ;
+    }
+
+    /*
+     * Merge the two segments.
+     */
+    auto mergedInstructions = sequentialInstructions[bestSetA] + sequentialInstructions[bestSetB];
+    auto positionOfA = std::find(ssSets.begin(), ssSets.end(), bestSetA);
+    auto mergedSet = this->partitioner->mergePair(bestSetA, bestSetB);
+    *positionOfA = mergedSet;
+    ssSets.erase(std::find(ssSets.begin(), ssSets.end(), bestSetB));
+    sequentialInstructions.erase(bestSetA);
+    sequentialInstructions.erase(bestSetB);
+    sequentialInstructions[mergedSet] = mergedInstructions;
+    mergedSegments++;
+  }
+
+  if (  true
+        && (mergedSegments > 0)
+        && (this->verbose != Verbosity::Disabled)
+    ){
+    errs() << "HELIX:  Merged " << mergedSegments << " sequential segments to reduce the synchronizations\n";
+  }
+
+  return ;
+}
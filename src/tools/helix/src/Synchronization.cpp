@@ -101,17 +101,35 @@ void HELIX::addSynchronizations (
     ssFuturePtrs.push_back(fetchEntry(helixTask->ssFutureArrayArg, ss->getID()));
 
     /*
-     * We must execute exactly one wait instruction for each sequential segment, for each loop iteration, and for each thread.
+     * We must execute exactly one wait instruction for each sequential segment, for each batch of loop iterations, and for each thread.
      *
      * Create a new variable at the beginning of the iteration.
      * We call this new variable, ssState.
-     * This new variable is reponsible to store the information about whether a wait instruction of the current sequential segment has already been executed in the current iteration for the current thread.
+     * This new variable is reponsible to store the information about whether a wait instruction of the current sequential segment has already been executed in the current batch for the current thread.
      */
     auto ssStateAlloca = entryBuilder.CreateAlloca(int64);
     ssStateAlloca->moveBefore(helixTask->getEntry()->getFirstNonPHIOrDbgOrLifetime());
     ssStates.push_back(ssStateAlloca);
   }
 
+  /*
+   * Move the loop-carried values protected by sequential segments into the cache lines of these segments.
+   * This way, the next core receives both the signal and the values with a single cache line transfer.
+   */
+  auto forwardedDependences = this->forwardLoopCarriedDataDependencies(LDI, sss, ssPastPtrs, ssFuturePtrs);
+
+  /*
+   * Define the code that generates a call to HELIX_signal.
+   * The loop-carried values protected by the sequential segment are sent to the next core before signaling.
+   */
+  auto createSignal = [&](SequentialSegment *ss, IRBuilder<> &signalBuilder) -> void {
+    for (auto &forwarded : forwardedDependences[ss->getID()]) {
+      signalBuilder.CreateStore(signalBuilder.CreateLoad(forwarded.localCopy), forwarded.futureValuePtr);
+    }
+    auto signal = signalBuilder.CreateCall(this->signalSSCall, { ssFuturePtrs.at(ss->getID()) });
+    helixTask->signals.insert(cast<CallInst>(signal));
+  };
+
   /*
    * Define the code that inject wait instructions.
    */
@@ -151,6 +169,9 @@ void HELIX::addSynchronizations (
     auto ssWaitBB = BasicBlock::Create(cxt, ssWaitBBName, helixTask->getTaskBody());
     IRBuilder<> ssWaitBuilder(ssWaitBB);
     auto wait = ssWaitBuilder.CreateCall(this->waitSSCall, { ssPastPtrs.at(ss->getID()) });
+    for (auto &forwarded : forwardedDependences[ss->getID()]) {
+      ssWaitBuilder.CreateStore(ssWaitBuilder.CreateLoad(forwarded.pastValuePtr), forwarded.localCopy);
+    }
     auto ssState = ssStates.at(ss->getID());
     ssWaitBuilder.CreateStore(ConstantInt::get(int64, 1), ssState);
     ssWaitBuilder.CreateBr(ssEntryBB);
@@ -186,18 +207,68 @@ void HELIX::addSynchronizations (
     if (!justBeforeExitBr || justBeforeExitBr->isUnconditional()) {
       Instruction *insertPoint = terminator == justBeforeExit ? terminator : justBeforeExit->getNextNode();
       IRBuilder<> beforeExitBuilder(insertPoint);
-      auto signal = beforeExitBuilder.CreateCall(this->signalSSCall, { ssFuturePtrs.at(ss->getID()) });
-      helixTask->signals.insert(cast<CallInst>(signal));
+      createSignal(ss, beforeExitBuilder);
       return;
     }
 
     for (auto successorBlock : successors(block)) {
       IRBuilder<> beforeExitBuilder(successorBlock->getFirstNonPHIOrDbgOrLifetime());
-      auto signal = beforeExitBuilder.CreateCall(this->signalSSCall, { ssFuturePtrs.at(ss->getID()) });
-      helixTask->signals.insert(cast<CallInst>(signal));
+      createSignal(ss, beforeExitBuilder);
     }
   };
 
+  /*
+   * Define the code that inject signals that pass a sequential segment to the next core only at the end of a batch of iterations.
+   */
+  PHINode *hasBatchBeenCompletedPHI = nullptr;
+  auto injectSignalAtTheEndOfBatch = [&](SequentialSegment *ss, Instruction *justBeforeExit) -> void {
+    if (this->batchIterationPHI == nullptr) {
+      injectSignal(ss, justBeforeExit);
+      return ;
+    }
+
+    /*
+     * Inject a call to HELIX_signal just after "justBeforeExit" that executes only in the last iteration of the batch
+     * NOTE: exits of sequential segments are never conditional branches (they are replaced by the beginning of their successors)
+     */
+    auto terminator = justBeforeExit->getParent()->getTerminator();
+    Instruction *insertPoint = terminator == justBeforeExit ? terminator : justBeforeExit->getNextNode();
+    IRBuilder<> beforeExitBuilder(insertPoint);
+    auto batchIterationType = this->batchIterationPHI->getType();
+    Value *isLastIterationOfBatch = nullptr;
+    auto headerClone = this->batchIterationPHI->getParent();
+    if (insertPoint->getParent() != headerClone) {
+      isLastIterationOfBatch = beforeExitBuilder.CreateICmpEQ(
+        this->batchIterationPHI,
+        ConstantInt::get(batchIterationType, this->iterationsPerBatch - 1)
+      );
+
+    } else {
+
+      /*
+       * Exits at the beginning of the header are reached after the previous iteration is over, when the batch index already refers to the next iteration.
+       * Hence, signal only if the iteration that just completed (coming from a latch) was the last one of its batch.
+       */
+      if (hasBatchBeenCompletedPHI == nullptr) {
+        auto int1 = IntegerType::get(cxt, 1);
+        hasBatchBeenCompletedPHI = PHINode::Create(int1, this->batchIterationPHI->getNumIncomingValues(), "", &*headerClone->begin());
+        for (auto i = 0; i < this->batchIterationPHI->getNumIncomingValues(); ++i) {
+          auto incomingBlock = this->batchIterationPHI->getIncomingBlock(i);
+          auto incomingValue = this->batchIterationPHI->getIncomingValue(i);
+          Value *isChunkCompleted = ConstantInt::getFalse(cxt);
+          if (auto chunkWrap = dyn_cast<SelectInst>(incomingValue)) {
+            isChunkCompleted = chunkWrap->getCondition();
+          }
+          hasBatchBeenCompletedPHI->addIncoming(isChunkCompleted, incomingBlock);
+        }
+      }
+      isLastIterationOfBatch = hasBatchBeenCompletedPHI;
+    }
+    auto signalTerminator = SplitBlockAndInsertIfThen(isLastIterationOfBatch, insertPoint, false);
+    IRBuilder<> signalBuilder(signalTerminator);
+    createSignal(ss, signalBuilder);
+  };
+
   /*
    * On finishing the task, set the loop-is-over flag to true.
    */
@@ -272,13 +343,22 @@ void HELIX::addSynchronizations (
   for (auto ss : *sss){
 
     /*
-     * Reset the value of ssState at the beginning of the iteration
+     * Reset the value of ssState at the beginning of the iteration (of the batch if iterations are batched)
      * NOTE: This has to be done BEFORE any preamble synchronization, so this
      * insertion comes after the check exit logic has already been inserted
      */
     auto firstLoopInst = loopHeader->getFirstNonPHIOrDbgOrLifetime();
     IRBuilder<> headerBuilder(firstLoopInst);
-    headerBuilder.CreateStore(ConstantInt::get(int64, 0), ssStates.at(ss->getID()));
+    auto ssState = ssStates.at(ss->getID());
+    Value *newSSState = ConstantInt::get(int64, 0);
+    if (this->batchIterationPHI) {
+      auto isFirstIterationOfBatch = headerBuilder.CreateICmpEQ(
+        this->batchIterationPHI,
+        ConstantInt::get(this->batchIterationPHI->getType(), 0)
+      );
+      newSSState = headerBuilder.CreateSelect(isFirstIterationOfBatch, newSSState, headerBuilder.CreateLoad(ssState));
+    }
+    headerBuilder.CreateStore(newSSState, ssState);
 
     /*
      * Inject waits.
@@ -318,23 +398,32 @@ void HELIX::addSynchronizations (
     /*
      * NOTE: If this is the preamble, also insert signals after all loop exits
      */
+    std::unordered_set<Instruction *> loopExits;
     if (preambleSS == ss) {
       for (auto exitBlock : loopStructure->getLoopExitBasicBlocks()) {
         auto beginningOfExitBlock = exitBlock->getFirstNonPHIOrDbgOrLifetime();
         exits.insert(beginningOfExitBlock);
+        loopExits.insert(beginningOfExitBlock);
       }
     }
 
     /*
      * Inject signals at sequential segment exits
+     * Signals within the loop pass the sequential segment to the next core only at the end of a batch,
+     * while signals after the loop always pass it.
      *
      * NOTE: For the preamble, jnject the exit flag set after injecting the signal
      * so that the set instruction is placed before the signal call
      */
     for (auto exit : exits) {
-      injectSignal(ss, exit);
-      if (preambleSS == ss &&
-        !loopStructure->isIncluded(exit)) {
+      auto needsExitFlagSet = preambleSS == ss && !loopStructure->isIncluded(exit);
+      auto isAfterTheLoop = loopExits.find(exit) != loopExits.end();
+      if (isAfterTheLoop) {
+        injectSignal(ss, exit);
+      } else {
+        injectSignalAtTheEndOfBatch(ss, exit);
+      }
+      if (needsExitFlagSet) {
         injectExitFlagSet(exit);
       }
     }
@@ -41,6 +41,8 @@ namespace llvm {
         Verbosity verbose
       );
 
+      InvocationLatency & getInvocationLatency (void) ;
+
      private:
 
       void minMaxMergePartition (
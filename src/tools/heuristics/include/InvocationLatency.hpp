@@ -30,6 +30,10 @@ namespace llvm {
 
       uint64_t queueLatency (Value *queueVal);
 
+      uint64_t synchronizationLatency (void);
+
+      uint64_t dispatchLatency (uint32_t numberOfCores);
+
       std::set<Value *> &memoizeExternals (SCCDAGAttrs *, SCC *);
 
       std::set<SCC *> &memoizeParents (SCCDAGAttrs *, SCC *);
@@ -19,6 +19,10 @@ Heuristics::Heuristics (Noelle &noelle)
   return ;
 }
 
+InvocationLatency & Heuristics::getInvocationLatency (void) {
+  return this->invocationLatency;
+}
+
 void Heuristics::adjustParallelizationPartitionForDSWP (
   SCCDAGPartitioner *partitioner,
   SCCDAGAttrs &attrs,
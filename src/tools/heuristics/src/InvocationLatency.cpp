@@ -11,6 +11,8 @@
 #include "InvocationLatency.hpp"
 
 using namespace llvm;
+
+static cl::opt<int> DispatchLatency("noelle-dispatch-latency", cl::ZeroOrMore, cl::Hidden, cl::desc("Latency (in instructions) of dispatching the tasks of an invocation of a parallelized loop as measured on the target platform"));
  
 InvocationLatency::InvocationLatency (Hot *hot)
   : profiles{hot}
@@ -96,6 +98,23 @@ uint64_t InvocationLatency::queueLatency (Value *queueVal){
   return 100;
 }
 
+/*
+ * Latency of signaling the next core that a sequential segment can start (i.e., the transfer of a cache line).
+ */
+uint64_t InvocationLatency::synchronizationLatency (void){
+  return 100;
+}
+
+/*
+ * Latency of dispatching the tasks of an invocation of a parallelized loop to the cores and of waiting for all of them to complete.
+ */
+uint64_t InvocationLatency::dispatchLatency (uint32_t numberOfCores){
+  if (DispatchLatency.getNumOccurrences() > 0){
+    return DispatchLatency.getValue();
+  }
+  return 1000 + (numberOfCores * 100);
+}
+
 /*
  * Retrieve or memoize all values the SCC is dependent on.
  * This does NOT include values within clonable parents as they will be present during execution (because they are cloned).
@@ -13,6 +13,8 @@
 
 using namespace llvm;
 
+static cl::opt<bool> ParallelAccesses("noelle-loop-meta-parallel-accesses", cl::ZeroOrMore, cl::Hidden, cl::desc("Tag the loops without loop-carried memory dependences with llvm.loop.parallel_accesses instead of embedding the loop IDs"));
+
 LoopMetadataPass::LoopMetadataPass()
   :
   ModulePass(ID)
@@ -37,6 +39,13 @@ bool LoopMetadataPass::runOnModule (Module &M) {
    */
   auto& context = M.getContext();
 
+  /*
+   * Check if we only have to tag the loops that LLVM can consider parallel.
+   */
+  if (ParallelAccesses){
+    return this->tagParallelAccesses(context, M, parallelizationFramework);
+  }
+
   /*
    * Tag all loops of the function given as input.
    *
@@ -30,6 +30,8 @@ namespace llvm {
 
     private:
       bool tagLoops (LLVMContext &context, Module &M, Noelle &par);
+
+      bool tagParallelAccesses (LLVMContext &context, Module &M, Noelle &par);
   };
 
 }
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2019 - 2020 Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "SystemHeaders.hpp"
+
+#include "LoopMetadataPass.hpp"
+
+using namespace llvm;
+
+bool LoopMetadataPass::tagParallelAccesses (
+  LLVMContext &context,
+  Module &M,
+  Noelle &par
+  ){
+
+  /*
+   * Fetch all the loops of the program.
+   */
+  auto loops = par.getLoops(0.0);
+
+  /*
+   * Tag the loops whose memory accesses have no loop-carried dependences.
+   *
+   * LLVM considers a loop parallel only if every instruction of it that accesses memory belongs to an access group listed in the llvm.loop.parallel_accesses property of the loop.
+   * This lets the vectorizer skip its own dependence analysis and its run-time checks of aliasing.
+   */
+  auto modified = false;
+  for (auto LDI : *loops){
+    auto loopStructure = LDI->getLoopStructure();
+
+    /*
+     * Collect the memory instructions of the loop.
+     */
+    std::vector<Instruction *> memoryInstructions;
+    for (auto bb : loopStructure->getBasicBlocks()){
+      for (auto &I : *bb){
+        if (I.mayReadOrWriteMemory()){
+          memoryInstructions.push_back(&I);
+        }
+      }
+    }
+    if (memoryInstructions.size() == 0){
+      continue ;
+    }
+
+    /*
+     * Check that no loop-carried memory dependence exists, unless the memory locations accessed in different iterations are disjoint.
+     */
+    auto isParallel = true;
+    auto domainSpaceAnalysis = LDI->getLoopIterationDomainSpaceAnalysis();
+    for (auto scc : LDI->sccdagAttrs.getSCCsWithLoopCarriedDataDependencies()){
+      LDI->sccdagAttrs.iterateOverLoopCarriedDataDependences(scc, [
+        &isParallel, domainSpaceAnalysis
+      ](DGEdge<Value> *dep) -> bool {
+        if (!dep->isMemoryDependence()) return false;
+
+        auto fromInst = dyn_cast<Instruction>(dep->getOutgoingT());
+        auto toInst = dyn_cast<Instruction>(dep->getIncomingT());
+        isParallel &= fromInst && toInst && domainSpaceAnalysis->
+          areInstructionsAccessingDisjointMemoryLocationsBetweenIterations(fromInst, toInst);
+        return !isParallel;
+      });
+      if (!isParallel){
+        break ;
+      }
+    }
+    if (!isParallel){
+      continue ;
+    }
+
+    /*
+     * Add the memory instructions to a new access group.
+     * Instructions of nested loops can belong to the groups of several loops.
+     */
+    auto accessGroup = MDNode::getDistinct(context, {});
+    for (auto memoryInst : memoryInstructions){
+      auto groups = memoryInst->getMetadata(LLVMContext::MD_access_group);
+      if (groups == nullptr){
+        memoryInst->setMetadata(LLVMContext::MD_access_group, accessGroup);
+        continue ;
+      }
+      std::vector<Metadata *> newGroups;
+      if (groups->getNumOperands() == 0){
+        newGroups.push_back(groups);
+      } else {
+        newGroups.insert(newGroups.end(), groups->op_begin(), groups->op_end());
+      }
+      newGroups.push_back(accessGroup);
+      memoryInst->setMetadata(LLVMContext::MD_access_group, MDNode::get(context, newGroups));
+    }
+
+    /*
+     * Create the new loop ID by keeping the properties of the current one but the old parallel accesses.
+     * The loop ID is attached to the terminators of the latches.
+     */
+    MDNode *oldLoopID = nullptr;
+    for (auto latch : loopStructure->getLatches()){
+      oldLoopID = latch->getTerminator()->getMetadata(LLVMContext::MD_loop);
+      if (oldLoopID != nullptr){
+        break ;
+      }
+    }
+    std::vector<Metadata *> loopProperties;
+    loopProperties.push_back(nullptr);
+    if (oldLoopID != nullptr){
+      for (auto i = 1u; i < oldLoopID->getNumOperands(); i++){
+        auto property = dyn_cast<MDNode>(oldLoopID->getOperand(i));
+        if (  true
+              && (property != nullptr)
+              && (property->getNumOperands() > 0)
+              && isa<MDString>(property->getOperand(0))
+              && (cast<MDString>(property->getOperand(0))->getString() == "llvm.loop.parallel_accesses")
+          ){
+          continue ;
+        }
+        loopProperties.push_back(oldLoopID->getOperand(i));
+      }
+    }
+    loopProperties.push_back(MDNode::get(context, { MDString::get(context, "llvm.loop.parallel_accesses"), accessGroup }));
+    auto newLoopID = MDNode::getDistinct(context, loopProperties);
+    newLoopID->replaceOperandWith(0, newLoopID);
+    for (auto latch : loopStructure->getLatches()){
+      latch->getTerminator()->setMetadata(LLVMContext::MD_loop, newLoopID);
+    }
+
+    modified = true;
+  }
+
+  /*
+   * Free the memory.
+   */
+  delete loops;
+
+  return modified;
+}
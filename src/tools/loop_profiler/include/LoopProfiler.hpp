@@ -0,0 +1,46 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "Noelle.hpp"
+
+using namespace llvm;
+
+namespace llvm {
+
+  /*
+   * Profiler of the invocations, iterations, and cycles of loops.
+   *
+   * Without options, it injects the code that records them at run time (see noelle-prof-loops).
+   * With -noelle-loop-prof-embed=FILE, it embeds the generated profile in the IR so that Hot can load it (see noelle-meta-loop-prof-embed).
+   *
+   * Loops are identified by their embedded IDs, so they must be embedded first (see noelle-meta-loop-embed).
+   */
+  struct LoopProfiler : public ModulePass {
+    public:
+      static char ID;
+
+      LoopProfiler();
+      virtual ~LoopProfiler();
+
+      bool doInitialization(Module &M) override;
+      void getAnalysisUsage(AnalysisUsage &AU) const override;
+      bool runOnModule(Module &M) override;
+
+    private:
+      bool instrumentLoops (Noelle &noelle, Module &M);
+
+      bool embedProfile (Module &M, std::string const &profileFileName);
+
+      bool canProfileLoop (LoopStructure *loop) const ;
+  };
+
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopProfiler.hpp"
+#include <fstream>
+#include <sstream>
+
+using namespace llvm;
+
+bool LoopProfiler::embedProfile (Module &M, std::string const &profileFileName) {
+  errs() << "LoopProfiler: Embed the profile " << profileFileName << "\n";
+
+  /*
+   * Load the profile.
+   */
+  std::ifstream profileFile(profileFileName);
+  if (!profileFile.is_open()){
+    errs() << "LoopProfiler: ERROR = cannot open " << profileFileName << "\n";
+    abort();
+  }
+  std::string programCycles = "0";
+  std::map<uint64_t, std::vector<std::string>> loopProfiles;
+  std::string line;
+  while (std::getline(profileFile, line)){
+    std::istringstream lineStream(line);
+    std::string kind;
+    lineStream >> kind;
+    if (kind == "program"){
+      lineStream >> programCycles;
+
+    } else if (kind == "loop"){
+      uint64_t loopID;
+      lineStream >> loopID;
+      std::string counter;
+      while (lineStream >> counter){
+        loopProfiles[loopID].push_back(counter);
+      }
+    }
+  }
+
+  /*
+   * Attach the profile of each loop to the terminator of its header, which holds the ID of the loop.
+   */
+  auto &C = M.getContext();
+  uint64_t embeddedLoops = 0;
+  for (auto &F : M){
+    for (auto &bb : F){
+      auto terminator = bb.getTerminator();
+      if (terminator == nullptr){
+        continue ;
+      }
+      auto loopIDM = terminator->getMetadata("noelle.loop_ID");
+      if (loopIDM == nullptr){
+        continue ;
+      }
+      terminator->setMetadata("noelle.loop_profile", nullptr);
+      auto loopID = std::stoull(cast<MDString>(loopIDM->getOperand(0))->getString().str());
+      auto profileIt = loopProfiles.find(loopID);
+      if (profileIt == loopProfiles.end()){
+        continue ;
+      }
+
+      std::vector<Metadata *> counters;
+      for (auto &counter : profileIt->second){
+        counters.push_back(MDString::get(C, counter));
+      }
+      terminator->setMetadata("noelle.loop_profile", MDNode::get(C, counters));
+      embeddedLoops++;
+    }
+  }
+  errs() << "LoopProfiler:   " << embeddedLoops << " loops out of " << loopProfiles.size() << " profiled ones have been embedded\n";
+
+  /*
+   * Embed the cycles of the whole program.
+   */
+  auto n = M.getOrInsertNamedMetadata("noelle.module.loop_profile");
+  n->clearOperands();
+  n->addOperand(MDNode::get(C, MDString::get(C, programCycles)));
+
+  return true;
+}
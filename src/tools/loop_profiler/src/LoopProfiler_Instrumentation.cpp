@@ -0,0 +1,107 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopProfiler.hpp"
+
+using namespace llvm;
+
+bool LoopProfiler::instrumentLoops (Noelle &noelle, Module &M) {
+  if (noelle.getVerbosity() > Verbosity::Disabled) {
+    errs() << "LoopProfiler: Start instrumenting\n";
+  }
+
+  /*
+   * Fetch the runtime.
+   */
+  auto invocationStartFunction = M.getFunction("NOELLE_LoopProfilerInvocationStart");
+  auto iterationFunction = M.getFunction("NOELLE_LoopProfilerIteration");
+  auto invocationEndFunction = M.getFunction("NOELLE_LoopProfilerInvocationEnd");
+  if (  false
+        || (invocationStartFunction == nullptr)
+        || (iterationFunction == nullptr)
+        || (invocationEndFunction == nullptr)
+    ){
+    errs() << "LoopProfiler: ERROR = the NOELLE runtime has not been linked\n";
+    abort();
+  }
+
+  /*
+   * Fetch all the loops.
+   */
+  auto loops = noelle.getLoopStructures(0.0);
+  auto int64 = Type::getInt64Ty(M.getContext());
+
+  /*
+   * Mark the beginning of the invocations and of the iterations.
+   * Exit edges are collected first because the same edge can leave several nested loops.
+   */
+  auto modified = false;
+  std::vector<std::pair<BasicBlock *, BasicBlock *>> exitEdges;
+  std::map<std::pair<BasicBlock *, BasicBlock *>, std::vector<Value *>> loopsExitedByEdge;
+  for (auto loopStructure : *loops){
+    if (!loopStructure->doesHaveMetadata("noelle.loop_ID")){
+      errs() << "LoopProfiler: ERROR = the loop IDs have not been embedded\n";
+      abort();
+    }
+    if (!this->canProfileLoop(loopStructure)){
+      if (noelle.getVerbosity() > Verbosity::Disabled) {
+        errs() << "LoopProfiler:   Loop " << loopStructure->getID() << " cannot be profiled\n";
+      }
+      continue ;
+    }
+    if (noelle.getVerbosity() > Verbosity::Disabled) {
+      errs() << "LoopProfiler:   Loop " << loopStructure->getID() << "\n";
+    }
+    auto loopIDValue = ConstantInt::get(int64, loopStructure->getID());
+
+    IRBuilder<> preheaderBuilder(loopStructure->getPreHeader()->getTerminator());
+    preheaderBuilder.CreateCall(invocationStartFunction, ArrayRef<Value *>({ loopIDValue }));
+    IRBuilder<> headerBuilder(&*loopStructure->getHeader()->getFirstInsertionPt());
+    headerBuilder.CreateCall(iterationFunction, ArrayRef<Value *>({ loopIDValue }));
+
+    for (auto exitEdge : loopStructure->getLoopExitEdges()){
+      if (loopsExitedByEdge.find(exitEdge) == loopsExitedByEdge.end()){
+        exitEdges.push_back(exitEdge);
+      }
+      loopsExitedByEdge[exitEdge].push_back(loopIDValue);
+    }
+    modified = true;
+  }
+
+  /*
+   * Mark the end of the invocations.
+   * Loops are listed from the outermost one, so the innermost loops are closed first.
+   */
+  for (auto exitEdge : exitEdges){
+    auto exitBB = exitEdge.second;
+    if (exitBB->getSinglePredecessor() != exitEdge.first){
+      exitBB = SplitEdge(exitEdge.first, exitEdge.second);
+    }
+    IRBuilder<> exitBuilder(&*exitBB->getFirstInsertionPt());
+    auto &loopIDs = loopsExitedByEdge[exitEdge];
+    for (auto it = loopIDs.rbegin(); it != loopIDs.rend(); it++){
+      exitBuilder.CreateCall(invocationEndFunction, ArrayRef<Value *>({ *it }));
+    }
+  }
+
+  /*
+   * Free the memory.
+   */
+  for (auto loopStructure : *loops){
+    delete loopStructure;
+  }
+  delete loops;
+
+  if (noelle.getVerbosity() > Verbosity::Disabled) {
+    errs() << "LoopProfiler: Exit\n";
+  }
+
+  return modified;
+}
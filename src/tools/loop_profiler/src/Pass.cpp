@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019 - 2020  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "LoopProfiler.hpp"
+
+using namespace llvm;
+
+static cl::opt<std::string> ProfileToEmbed("noelle-loop-prof-embed", cl::ZeroOrMore, cl::Hidden, cl::desc("Embed the loop profile generated by a program instrumented by noelle-prof-loops"));
+
+bool LoopProfiler::doInitialization(Module &M) {
+  return false;
+}
+
+void LoopProfiler::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<Noelle>();
+  return;
+}
+
+bool LoopProfiler::runOnModule(Module &M) {
+
+  /*
+   * Check if we have to embed a profile.
+   */
+  if (ProfileToEmbed.getNumOccurrences() > 0){
+    return this->embedProfile(M, ProfileToEmbed);
+  }
+
+  /*
+   * Inject the code to profile the loops.
+   */
+  auto& noelle = getAnalysis<Noelle>();
+
+  return this->instrumentLoops(noelle, M);
+}
+
+// Next there is code to register your pass to "opt"
+char LoopProfiler::ID = 0;
+static RegisterPass<LoopProfiler> X("LoopProfiler", "Profile the invocations, iterations, and cycles of loops");
+
+// Next there is code to register your pass to "clang"
+static LoopProfiler * _PassMaker = NULL;
+static RegisterStandardPasses _RegPass1(PassManagerBuilder::EP_OptimizerLast,
+    [](const PassManagerBuilder&, legacy::PassManagerBase& PM) {
+        if(!_PassMaker){ PM.add(_PassMaker = new LoopProfiler());}}); // ** for -Ox
+static RegisterStandardPasses _RegPass2(PassManagerBuilder::EP_EnabledOnOptLevel0,
+    [](const PassManagerBuilder&, legacy::PassManagerBase& PM) {
+        if(!_PassMaker){ PM.add(_PassMaker = new LoopProfiler()); }}); // ** for -O0
@@ -54,10 +54,27 @@ namespace llvm::noelle {
         Heuristics *h
       ) const = 0 ;
 
+      /*
+       * Estimate the time (in dynamic instructions) spent by all invocations of the loop LDI once parallelized by the current technique.
+       * The estimation includes the overhead of dispatching tasks and of the synchronizations or communications between them.
+       */
+      virtual double estimateParallelExecutionTime (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        Heuristics *h
+      ) const = 0 ;
+
       Value * getEnvArray () { return envBuilder->getEnvArray(); }
+      uint64_t getEnvVarOffset (int envIndex) { return envBuilder->getEnvVarOffset(envIndex); }
       BasicBlock *getParLoopEntryPoint () { return entryPointOfParallelizedLoop; }
       BasicBlock *getParLoopExitPoint () { return exitPointOfParallelizedLoop; }
 
+      /*
+       * Return the condition (computed in the preheader of the original loop) to run the parallelized loop rather than the original one.
+       * Return nullptr if the parallelized loop must always run.
+       */
+      Value *getConditionToRunTheParLoop () { return conditionToRunTheParallelizedLoop; }
+
       virtual void reset () ;
 
       /*
@@ -191,6 +208,24 @@ namespace llvm::noelle {
 
       Value *castToCorrectReducibleType (IRBuilder<> &builder, Value *value, Type *targetType) ;
 
+      int getBinaryOperatorToReduceEnvironmentValue (
+        LoopDependenceInfo *LDI,
+        int environmentIndex
+      );
+
+      /*
+       * Reduction of live-out variables within the tasks (before the join).
+       */
+      bool shouldReduceLiveOutVariablesInTasks (
+        LoopDependenceInfo *LDI
+      );
+
+      void generateCodeToReduceLiveOutVariablesInTask (
+        LoopDependenceInfo *LDI,
+        int taskIndex,
+        Value *numberOfTaskInstances
+      );
+
       /*
        * Partition SCCDAG.
        */
@@ -208,6 +243,17 @@ namespace llvm::noelle {
         Noelle &par
       ) const ;
 
+      double computeNumberOfCoresUsablePerInvocation (
+        LoopDependenceInfo *LDI,
+        Noelle &par
+      ) const ;
+
+      double estimateDispatchTime (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        Heuristics *h
+      ) const ;
+
       /*
        * Debug
        */
@@ -226,6 +272,7 @@ namespace llvm::noelle {
       Function *taskDispatcher;
       FunctionType *taskType;
       BasicBlock *entryPointOfParallelizedLoop, *exitPointOfParallelizedLoop;
+      Value *conditionToRunTheParallelizedLoop;
       std::vector<Task *> tasks;
       int numTaskInstances;
 
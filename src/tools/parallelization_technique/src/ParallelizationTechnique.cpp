@@ -9,6 +9,17 @@
  * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "ParallelizationTechnique.hpp"
+#include "llvm/Analysis/InstructionSimplify.h"
+#include "llvm/Transforms/Utils/Local.h"
+
+static cl::opt<bool> DisableRuntimeInlining("noelle-disable-runtime-inlining", cl::ZeroOrMore, cl::Hidden, cl::desc("Keep the calls from the parallelized code to the runtime (e.g., queues, synchronization) out of line"));
+
+/*
+ * Thresholds to let tasks combine the private copies of reducible live-out variables in a tree.
+ * The serial reduction after the join combines (task instances * reducible variables) copies, each in its own cache line.
+ */
+#define NOELLE_TREE_REDUCTION_MIN_TASK_INSTANCES 16
+#define NOELLE_TREE_REDUCTION_MIN_COPIES 64
 
 using namespace llvm;
 
@@ -17,7 +28,7 @@ ParallelizationTechnique::ParallelizationTechnique (
   Hot &p,
   Verbosity v
   )
-  : module{module}, verbose{v}, tasks{}, envBuilder{0}, profile{p}
+  : module{module}, verbose{v}, tasks{}, envBuilder{0}, conditionToRunTheParallelizedLoop{nullptr}, profile{p}
   {
 
   return ;
@@ -61,8 +72,18 @@ void ParallelizationTechnique::initializeEnvironmentBuilder (
     varTypes.push_back(LDI->environment->typeOfEnv(i));
   }
 
+  /*
+   * Live-in variables are only read by the tasks.
+   */
+  std::set<int> readOnlyVars;
+  for (auto envIndex : LDI->environment->getEnvIndicesOfLiveInVars()) {
+    if (simpleVars.find(envIndex) != simpleVars.end()) {
+      readOnlyVars.insert(envIndex);
+    }
+  }
+
   this->envBuilder = new EnvBuilder(module.getContext());
-  this->envBuilder->createEnvVariables(varTypes, simpleVars, reducableVars, this->numTaskInstances);
+  this->envBuilder->createEnvVariables(varTypes, simpleVars, reducableVars, readOnlyVars, this->numTaskInstances);
 
   this->envBuilder->createEnvUsers(tasks.size());
   for (auto i = 0; i < tasks.size(); ++i) {
@@ -140,15 +161,7 @@ BasicBlock * ParallelizationTechnique::propagateLiveOutEnvironment (LoopDependen
     if (!isReduced) continue;
 
     auto producer = LDI->environment->producerAt(envInd);
-    auto producerSCC = LDI->sccdagAttrs.getSCCDAG()->sccOfValue(producer);
-    auto producerSCCAttributes = LDI->sccdagAttrs.getSCCAttrs(producerSCC);
-
-    /*
-     * HACK: Need to get accumulator that feeds directly into producer PHI, not any intermediate one
-     */
-    auto firstAccumI = *(producerSCCAttributes->getAccumulators().begin());
-    auto binOpCode = firstAccumI->getOpcode();
-    reducableBinaryOps[envInd] = LDI->sccdagAttrs.accumOpInfo.accumOpForType(binOpCode, producer->getType());
+    reducableBinaryOps[envInd] = this->getBinaryOperatorToReduceEnvironmentValue(LDI, envInd);
 
     PHINode *loopEntryProducerPHI = fetchLoopEntryPHIOfProducer(LDI, producer);
     auto initValPHIIndex = loopEntryProducerPHI->getBasicBlockIndex(loopPreHeader);
@@ -240,6 +253,7 @@ void ParallelizationTechnique::generateEmptyTasks (
   auto &cxt = loopFunction->getContext();
   this->entryPointOfParallelizedLoop = BasicBlock::Create(cxt, "", loopFunction);
   this->exitPointOfParallelizedLoop = BasicBlock::Create(cxt, "", loopFunction);
+  this->conditionToRunTheParallelizedLoop = nullptr;
 
   this->numTaskInstances = taskStructs.size();
   for (auto i = 0; i < numTaskInstances; ++i) {
@@ -897,6 +911,86 @@ Value * ParallelizationTechnique::getIdentityValueForEnvironmentValue (
   return identityValue;
 }
 
+int ParallelizationTechnique::getBinaryOperatorToReduceEnvironmentValue (
+  LoopDependenceInfo *LDI,
+  int environmentIndex
+){
+  auto producer = LDI->environment->producerAt(environmentIndex);
+  auto producerSCC = LDI->sccdagAttrs.getSCCDAG()->sccOfValue(producer);
+  auto producerSCCAttributes = LDI->sccdagAttrs.getSCCAttrs(producerSCC);
+
+  /*
+   * HACK: Need to get accumulator that feeds directly into producer PHI, not any intermediate one
+   */
+  auto firstAccumI = *(producerSCCAttributes->getAccumulators().begin());
+  auto binOpCode = firstAccumI->getOpcode();
+
+  return LDI->sccdagAttrs.accumOpInfo.accumOpForType(binOpCode, producer->getType());
+}
+
+bool ParallelizationTechnique::shouldReduceLiveOutVariablesInTasks (
+  LoopDependenceInfo *LDI
+){
+
+  /*
+   * Count the reducible live-out variables.
+   */
+  uint64_t reducedVariables = 0;
+  for (auto envIndex : LDI->environment->getEnvIndicesOfLiveOutVars()) {
+    if (this->envBuilder->isReduced(envIndex)) {
+      reducedVariables++;
+    }
+  }
+  if (reducedVariables == 0){
+    return false;
+  }
+
+  /*
+   * Combine the copies in a tree when the serial reduction would be long.
+   */
+  if (  false
+        || (this->numTaskInstances >= NOELLE_TREE_REDUCTION_MIN_TASK_INSTANCES)
+        || ((this->numTaskInstances * reducedVariables) >= NOELLE_TREE_REDUCTION_MIN_COPIES)
+    ){
+    return true;
+  }
+
+  return false;
+}
+
+void ParallelizationTechnique::generateCodeToReduceLiveOutVariablesInTask (
+  LoopDependenceInfo *LDI,
+  int taskIndex,
+  Value *numberOfTaskInstances
+){
+
+  /*
+   * Collect the operators to combine the reducible live-out variables of the task.
+   */
+  auto task = this->tasks[taskIndex];
+  auto envUser = this->envBuilder->getUser(taskIndex);
+  std::unordered_map<int, int> reducableBinaryOps;
+  for (auto envIndex : envUser->getEnvIndicesOfLiveOutVars()) {
+    if (!this->envBuilder->isReduced(envIndex)) {
+      continue ;
+    }
+    reducableBinaryOps[envIndex] = this->getBinaryOperatorToReduceEnvironmentValue(LDI, envIndex);
+  }
+
+  /*
+   * Combine the private copies of the task instances before the task ends.
+   */
+  this->envBuilder->reduceLiveOutVariablesInTask(
+    taskIndex,
+    task->getExit(),
+    reducableBinaryOps,
+    task->getTaskInstanceID(),
+    numberOfTaskInstances
+  );
+
+  return ;
+}
+
 void ParallelizationTechnique::generateCodeToStoreExitBlockIndex (
   LoopDependenceInfo *LDI,
   int taskIndex
@@ -946,6 +1040,22 @@ void ParallelizationTechnique::doNestedInlineOfCalls (
   Function *function,
   std::set<CallInst *> &calls
 ){
+
+  /*
+   * Check if inlining the runtime is enabled.
+   */
+  if (DisableRuntimeInlining) {
+    return ;
+  }
+
+  /*
+   * Remember the code of the function before inlining.
+   */
+  std::unordered_set<Instruction *> instsBeforeInlining;
+  for (auto &I : instructions(function)) {
+    instsBeforeInlining.insert(&I);
+  }
+
   std::queue<CallInst *> callsToInline;
   for (auto call : calls) callsToInline.push(call);
 
@@ -965,6 +1075,11 @@ void ParallelizationTechnique::doNestedInlineOfCalls (
           if (auto call = dyn_cast<CallInst>(&I)) {
             auto func = call->getCalledFunction();
             if (func == nullptr || func->empty()) continue;
+
+            /*
+             * The runtime keeps its slow paths (e.g., telemetry) out of the code it is inlined into.
+             */
+            if (func->hasFnAttribute(Attribute::NoInline)) continue;
             funcToInline.insert(func);
           }
         }
@@ -987,6 +1102,36 @@ void ParallelizationTechnique::doNestedInlineOfCalls (
       }
     }
   }
+
+  /*
+   * Clean up the inlined code: fold it with the values it receives from its call sites (e.g., casts of pointers and constant arguments) and remove what becomes dead.
+   * Only inlined instructions are touched, as the tasks keep track of the other ones.
+   */
+  auto &DL = function->getParent()->getDataLayout();
+  std::vector<Instruction *> inlinedInsts;
+  for (auto &I : instructions(function)) {
+    if (instsBeforeInlining.find(&I) == instsBeforeInlining.end()) {
+      inlinedInsts.push_back(&I);
+    }
+  }
+  for (auto inst : inlinedInsts) {
+    auto simplifiedValue = SimplifyInstruction(inst, DL);
+    if (  false
+          || (simplifiedValue == nullptr)
+          || (simplifiedValue == inst)
+      ){
+      continue ;
+    }
+    inst->replaceAllUsesWith(simplifiedValue);
+  }
+  for (auto instIt = inlinedInsts.rbegin(); instIt != inlinedInsts.rend(); ++instIt) {
+    auto inst = *instIt;
+    if (isInstructionTriviallyDead(inst)) {
+      inst->eraseFromParent();
+    }
+  }
+
+  return ;
 }
 
 std::unordered_map<InductionVariable *, Value *> ParallelizationTechnique::cloneIVStepValueComputation (
@@ -1109,6 +1254,45 @@ float ParallelizationTechnique::computeSequentialFractionOfExecution (
   return sequentialInstructionCount / totalInstructionCount;
 }
 
+double ParallelizationTechnique::computeNumberOfCoresUsablePerInvocation (
+  LoopDependenceInfo *LDI,
+  Noelle &par
+) const {
+
+  /*
+   * An invocation cannot keep busy more cores than the iterations it executes.
+   */
+  auto profiles = par.getProfiles();
+  auto loopStructure = LDI->getLoopStructure();
+  auto cores = (double)LDI->getMaximumNumberOfCores();
+  auto averageIterations = profiles->getAverageLoopIterationsPerInvocation(loopStructure);
+  if (averageIterations < cores){
+    cores = averageIterations;
+  }
+  if (cores < 1){
+    cores = 1;
+  }
+
+  return cores;
+}
+
+double ParallelizationTechnique::estimateDispatchTime (
+  LoopDependenceInfo *LDI,
+  Noelle &par,
+  Heuristics *h
+) const {
+
+  /*
+   * Every invocation of the parallelized loop dispatches its tasks.
+   */
+  auto profiles = par.getProfiles();
+  auto loopStructure = LDI->getLoopStructure();
+  auto invocations = profiles->getInvocations(loopStructure);
+  auto dispatchLatency = h->getInvocationLatency().dispatchLatency(LDI->getMaximumNumberOfCores());
+
+  return ((double)invocations) * ((double)dispatchLatency);
+}
+
 void ParallelizationTechnique::dumpToFile (LoopDependenceInfo &LDI) {
   std::error_code EC;
   raw_fd_ostream File("technique-dump-loop-" + std::to_string(LDI.getID()) + ".txt", EC, sys::fs::F_Text);
@@ -13,8 +13,9 @@
 namespace llvm::noelle {
 
   bool Parallelizer::collectThreadPoolHelperFunctionsAndTypes (Module &M, Noelle &par) {
-    std::string pushers[4] = { "queuePush8", "queuePush16", "queuePush32", "queuePush64" };
-    std::string poppers[4] = { "queuePop8", "queuePop16", "queuePop32", "queuePop64" };
+    std::string pushers[6] = { "queuePush8", "queuePush16", "queuePush32", "queuePush64", "queuePushEntry", "queuePushBroadcast" };
+    std::string poppers[6] = { "queuePop8", "queuePop16", "queuePop32", "queuePop64", "queuePopEntry", "queuePopBroadcast" };
+    std::string flushers[6] = { "queueFlush8", "queueFlush16", "queueFlush32", "queueFlush64", "queueFlushEntry", "queueFlushBroadcast" };
     for (auto pusher : pushers) {
       auto pushFunction = M.getFunction(pusher);
       if (pushFunction == nullptr){
@@ -31,11 +32,21 @@ namespace llvm::noelle {
       }
       par.queues.queuePops.push_back(popFunction);
     }
+    for (auto flusher : flushers) {
+      auto flushFunction = M.getFunction(flusher);
+      if (flushFunction == nullptr){
+        errs() << "Parallelizer: ERROR = function \"" << flusher << "\" could not be found\n";
+        abort();
+      }
+      par.queues.queueFlushes.push_back(flushFunction);
+    }
     for (auto queueF : par.queues.queuePushes) {
       par.queues.queueTypes.push_back(queueF->arg_begin()->getType());
     }
     par.queues.queueSizeToIndex = unordered_map<int, int>({ { 1, 0 }, { 8, 0 }, { 16, 1 }, { 32, 2 }, { 64, 3 }});
-    par.queues.queueElementTypes = std::vector<Type *>({ par.int8, par.int16, par.int32, par.int64 });
+    par.queues.queueElementTypes = std::vector<Type *>({ par.int8, par.int16, par.int32, par.int64, par.int8, par.int8 });
+    par.queues.entryQueueIndex = 4;
+    par.queues.broadcastQueueIndex = 5;
 
     return true;
   }
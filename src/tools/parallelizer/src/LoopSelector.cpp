@@ -15,6 +15,7 @@ namespace llvm::noelle {
   std::vector<LoopDependenceInfo *> Parallelizer::selectTheOrderOfLoopsToParallelize (
     Noelle &noelle, 
     Hot *profiles,
+    Heuristics *h,
     noelle::StayConnectedNestedLoopForestNode *tree
     ) {
     std::vector<LoopDependenceInfo *> selectedLoops{};
@@ -28,7 +29,31 @@ namespace llvm::noelle {
     * Compute the amount of time that can be saved by a parallelization technique per loop.
     */
     std::map<LoopDependenceInfo *, uint64_t> timeSavedLoops;
-    auto selector = [&noelle, &timeSavedLoops, profiles](StayConnectedNestedLoopForestNode *n, uint32_t treeLevel) -> bool {
+    std::map<LoopDependenceInfo *, double> netSavingsLoops;
+    std::unordered_map<StayConnectedNestedLoopForestNode *, LoopDependenceInfo *> nodeLoops;
+    auto dispatchLatency = h->getInvocationLatency().dispatchLatency(noelle.getMaximumNumberOfCores());
+
+    /*
+     * Savings are ranked in cycles if the program has been profiled by noelle-prof-loops.
+     * Loops without their own cycles are converted with the cycles per instruction of the whole program.
+     */
+    auto programCyclesPerInstruction = 1.0;
+    if (  true
+          && profiles->hasCycles()
+          && (profiles->getTotalInstructions() > 0)
+      ){
+      programCyclesPerInstruction = ((double)profiles->getTotalCycles()) / ((double)profiles->getTotalInstructions());
+    }
+    auto getCyclesPerInstruction = [profiles, programCyclesPerInstruction](LoopStructure *ls) -> double {
+      if (  true
+            && profiles->hasCycles(ls)
+            && (profiles->getTotalInstructions(ls) > 0)
+        ){
+        return ((double)profiles->getTotalCycles(ls)) / ((double)profiles->getTotalInstructions(ls));
+      }
+      return programCyclesPerInstruction;
+    };
+    auto selector = [&noelle, &timeSavedLoops, &netSavingsLoops, &nodeLoops, profiles, dispatchLatency, &getCyclesPerInstruction](StayConnectedNestedLoopForestNode *n, uint32_t treeLevel) -> bool {
 
       /*
       * Fetch the loop.
@@ -36,6 +61,7 @@ namespace llvm::noelle {
       auto ls = n->getLoop();
       auto optimizations = { LoopDependenceInfoOptimization::MEMORY_CLONING_ID };
       auto ldi = noelle.getLoop(ls, optimizations);
+      nodeLoops[n] = ldi;
 
       /*
       * Fetch the set of sequential SCCs.
@@ -107,13 +133,23 @@ namespace llvm::noelle {
       * Compute the maximum amount of time saved by any parallelization technique.
       */
       timeSavedLoops[ldi] = 0;
+      netSavingsLoops[ldi] = 0;
       if (profiles->getIterations(ls) > 0){
         auto instsPerIteration = profiles->getAverageTotalInstructionsPerIteration(ls);
         auto instsInBiggestSCCPerIteration = ((double)biggestSCCTime) / ((double)profiles->getIterations(ls));
         assert(instsInBiggestSCCPerIteration <= instsPerIteration);
         auto timeSavedPerIteration = (double)(instsPerIteration - instsInBiggestSCCPerIteration);
         auto timeSaved = timeSavedPerIteration * profiles->getIterations(ls);
+        auto dispatchTime = ((double)profiles->getInvocations(ls)) * ((double)dispatchLatency);
+
+        /*
+         * Convert the instructions saved to cycles, preferring the cycles per instruction of the loop if it has been profiled by noelle-prof-loops.
+         */
+        auto cyclesPerInstruction = getCyclesPerInstruction(ls);
+        timeSaved *= cyclesPerInstruction;
+        dispatchTime *= cyclesPerInstruction;
         timeSavedLoops[ldi] = (uint64_t)timeSaved;
+        netSavingsLoops[ldi] = timeSaved - dispatchTime;
       }
 
       return false;
@@ -152,6 +188,38 @@ namespace llvm::noelle {
     };
     std::sort(selectedLoops.begin(), selectedLoops.end(), compareOperator);
 
+    /*
+    * Select the loops of the nest whose parallelization maximizes the savings of the whole nest.
+    * These loops are tried first.
+    * The remaining loops that still save time net of their dispatch costs are kept afterwards to be tried in case the parallelization of a selected loop fails.
+    *
+    * Savings are known only with profiles, and forced parallelizations must not drop any loop; in these cases the order above is kept.
+    */
+    if (  true
+          && this->selectLoopNests
+          && (!this->forceParallelization)
+          && profiles->isAvailable()
+      ){
+      auto nestLoops = this->selectTheLoopsOfTheNestToParallelize(tree, nodeLoops, netSavingsLoops);
+      std::vector<LoopDependenceInfo *> orderedLoops;
+      for (auto ldi : selectedLoops){
+        if (nestLoops.find(ldi) != nestLoops.end()){
+          orderedLoops.push_back(ldi);
+        }
+      }
+      for (auto ldi : selectedLoops){
+        if (nestLoops.find(ldi) != nestLoops.end()){
+          continue ;
+        }
+        if (netSavingsLoops[ldi] <= 0){
+          delete ldi;
+          continue ;
+        }
+        orderedLoops.push_back(ldi);
+      }
+      selectedLoops = orderedLoops;
+    }
+
     /*
     * Print the order and the savings.
     */
@@ -160,7 +228,7 @@ namespace llvm::noelle {
       errs() << "Parallelizer: LoopSelector:   Order of loops and their maximum savings\n";
       for (auto l : selectedLoops){
         auto ls = l->getLoopStructure();
-        auto savedTimeRelative = ((double)timeSavedLoops[l]) / ((double) profiles->getTotalInstructions(ls));
+        auto savedTimeRelative = ((double)timeSavedLoops[l]) / (((double) profiles->getTotalInstructions(ls)) * getCyclesPerInstruction(ls));
         savedTimeRelative *= 100;
         errs() << "Parallelizer: LoopSelector:    Loop " << l->getID() << " savings = " << savedTimeRelative << "%\n";
       }
@@ -169,4 +237,54 @@ namespace llvm::noelle {
 
     return selectedLoops;
   }
+
+  std::unordered_set<LoopDependenceInfo *> Parallelizer::selectTheLoopsOfTheNestToParallelize (
+    noelle::StayConnectedNestedLoopForestNode *tree,
+    std::unordered_map<noelle::StayConnectedNestedLoopForestNode *, LoopDependenceInfo *> &nodeLoops,
+    std::map<LoopDependenceInfo *, double> &netSavingsLoops
+    ) {
+
+    /*
+    * Compute the best savings of every sub-tree bottom-up.
+    * At most one loop per root-to-leaf path can be parallelized.
+    * Hence, a loop is worth parallelizing only if it saves more than the best choice among the loops nested within it.
+    */
+    std::unordered_set<StayConnectedNestedLoopForestNode *> nodesToParallelize;
+    std::function<double (StayConnectedNestedLoopForestNode *)> computeBestSavings;
+    computeBestSavings = [&computeBestSavings, &nodeLoops, &netSavingsLoops, &nodesToParallelize](StayConnectedNestedLoopForestNode *n) -> double {
+      double nestedSavings = 0;
+      for (auto child : n->getDescendants()){
+        nestedSavings += computeBestSavings(child);
+      }
+      auto loopSavings = netSavingsLoops[nodeLoops[n]];
+      if (  true
+            && (loopSavings > 0)
+            && (loopSavings > nestedSavings)
+        ){
+        nodesToParallelize.insert(n);
+        return loopSavings;
+      }
+      return nestedSavings;
+    };
+    computeBestSavings(tree);
+
+    /*
+    * Collect the selected loops top-down.
+    * The loops nested within a selected one are not selected even if they would have been the best choice of their sub-tree.
+    */
+    std::unordered_set<LoopDependenceInfo *> selectedLoops;
+    std::function<void (StayConnectedNestedLoopForestNode *)> collectSelectedLoops;
+    collectSelectedLoops = [&collectSelectedLoops, &nodeLoops, &nodesToParallelize, &selectedLoops](StayConnectedNestedLoopForestNode *n) {
+      if (nodesToParallelize.find(n) != nodesToParallelize.end()){
+        selectedLoops.insert(nodeLoops[n]);
+        return ;
+      }
+      for (auto child : n->getDescendants()){
+        collectSelectedLoops(child);
+      }
+    };
+    collectSelectedLoops(tree);
+
+    return selectedLoops;
+  }
 }
\ No newline at end of file
@@ -54,16 +54,17 @@ namespace llvm::noelle {
       errs() << "Parallelizer:  Nesting level = " << loopStructure->getNestingLevel() << "\n";
     }
 
+    /*
+    * Select the parallelization technique.
+    */
+    auto selectedTechnique = this->selectTheTechniqueToParallelizeLoop(LDI, par, dswp, doall, helix, h);
+
     /*
     * Parallelize the loop.
     */
     auto codeModified = false;
     ParallelizationTechnique *usedTechnique = nullptr;
-    if (  true
-          && par.isTransformationEnabled(DOALL_ID)
-          && LDI->isTransformationEnabled(DOALL_ID)
-          && doall.canBeAppliedToLoop(LDI, par, h)
-      ){
+    if (selectedTechnique == &doall){
 
       /*
       * Apply DOALL.
@@ -72,11 +73,7 @@ namespace llvm::noelle {
       codeModified = doall.apply(LDI, par, h);
       usedTechnique = &doall;
 
-    } else if ( true
-                && par.isTransformationEnabled(HELIX_ID)
-                && LDI->isTransformationEnabled(HELIX_ID)
-                && helix.canBeAppliedToLoop(LDI, par, h)   
-      ){
+    } else if (selectedTechnique == &helix){
 
       /*
       * Apply HELIX
@@ -108,11 +105,7 @@ namespace llvm::noelle {
       codeModified = helix.apply(newLDI, par, h);
       usedTechnique = &helix;
 
-    } else if ( true
-                && par.isTransformationEnabled(DSWP_ID)
-                && LDI->isTransformationEnabled(DSWP_ID)
-                && dswp.canBeAppliedToLoop(LDI, par, h)
-      ) {
+    } else if (selectedTechnique == &dswp){
 
       /*
       * Apply DSWP.
@@ -151,7 +144,8 @@ namespace llvm::noelle {
     if (verbose != Verbosity::Disabled) {
       errs() << "Parallelizer:  Link the parallelize loop\n";
     }
-    auto exitIndex = cast<Value>(ConstantInt::get(par.int64, LDI->environment->indexOfExitBlock()));
+    auto exitBlockEnvIndex = LDI->environment->indexOfExitBlock();
+    auto exitOffset = cast<Value>(ConstantInt::get(par.int64, (exitBlockEnvIndex != -1) ? usedTechnique->getEnvVarOffset(exitBlockEnvIndex) : -1));
     auto loopExitBlocks = loopStructure->getLoopExitBasicBlocks();
     par.linkTransformedLoopToOriginalFunction(
       loopFunction->getParent(),
@@ -159,8 +153,9 @@ namespace llvm::noelle {
       entryPoint,
       exitPoint, 
       envArray,
-      exitIndex,
-      loopExitBlocks
+      exitOffset,
+      loopExitBlocks,
+      usedTechnique->getConditionToRunTheParLoop()
     );
     // if (verbose >= Verbosity::Maximal) {
     //   loopFunction->print(errs() << "Final printout:\n"); errs() << "\n";
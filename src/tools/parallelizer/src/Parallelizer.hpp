@@ -65,6 +65,8 @@ namespace llvm::noelle {
        */
       bool forceParallelization;
       bool forceNoSCCPartition;
+      bool selectTechniqueWithCostModel;
+      bool selectLoopNests;
 
       /*
        * Methods
@@ -78,6 +80,15 @@ namespace llvm::noelle {
         Heuristics *h
       );
 
+      ParallelizationTechnique * selectTheTechniqueToParallelizeLoop (
+        LoopDependenceInfo *LDI,
+        Noelle &par,
+        DSWP &dswp,
+        DOALL &doall,
+        HELIX &helix,
+        Heuristics *h
+      );
+
       std::vector<LoopDependenceInfo *> getLoopsToParallelize (Module &M, Noelle &par) ;
 
       bool collectThreadPoolHelperFunctionsAndTypes (Module &M, Noelle &par) ;
@@ -85,9 +96,16 @@ namespace llvm::noelle {
       std::vector<LoopDependenceInfo *> selectTheOrderOfLoopsToParallelize (
         Noelle &noelle, 
         Hot *profiles,
+        Heuristics *h,
         noelle::StayConnectedNestedLoopForestNode *tree
         ) ;
 
+      std::unordered_set<LoopDependenceInfo *> selectTheLoopsOfTheNestToParallelize (
+        noelle::StayConnectedNestedLoopForestNode *tree,
+        std::unordered_map<noelle::StayConnectedNestedLoopForestNode *, LoopDependenceInfo *> &nodeLoops,
+        std::map<LoopDependenceInfo *, double> &netSavingsLoops
+        ) ;
+
       /*
        * Debug utilities
        */
@@ -17,6 +17,8 @@ using namespace llvm;
 * Options of the Parallelizer pass.
 */
 static cl::opt<bool> ForceParallelization("noelle-parallelizer-force", cl::ZeroOrMore, cl::Hidden, cl::desc("Force the parallelization"));
+static cl::opt<bool> SelectTechniqueWithCostModel("noelle-parallelizer-cost-model", cl::ZeroOrMore, cl::Hidden, cl::desc("Select the parallelization technique of a loop by estimating the speedup of every applicable one rather than by a fixed priority"));
+static cl::opt<bool> SelectLoopNests("noelle-parallelizer-nest-selection", cl::ZeroOrMore, cl::Hidden, cl::desc("Select the loops to parallelize within each loop nest by maximizing the savings of the whole nest net of the dispatch costs"));
 static cl::opt<bool> ForceNoSCCPartition("dswp-no-scc-merge", cl::ZeroOrMore, cl::Hidden, cl::desc("Force no SCC merging when parallelizing"));
 
 namespace llvm::noelle {
@@ -25,7 +27,9 @@ namespace llvm::noelle {
     :
     ModulePass{ID}, 
     forceParallelization{false},
-    forceNoSCCPartition{false}
+    forceNoSCCPartition{false},
+    selectTechniqueWithCostModel{false},
+    selectLoopNests{false}
     {
 
     return ;
@@ -34,6 +38,8 @@ namespace llvm::noelle {
   bool Parallelizer::doInitialization (Module &M) {
     this->forceParallelization = (ForceParallelization.getNumOccurrences() > 0);
     this->forceNoSCCPartition = (ForceNoSCCPartition.getNumOccurrences() > 0);
+    this->selectTechniqueWithCostModel = (SelectTechniqueWithCostModel.getNumOccurrences() > 0);
+    this->selectLoopNests = (SelectLoopNests.getNumOccurrences() > 0);
 
     return false; 
   }
@@ -103,7 +109,18 @@ namespace llvm::noelle {
     * Filter out loops that are not worth parallelizing.
     */
     errs() << "Parallelizer:  Filter out loops not worth considering\n";
-    auto filter = [this, forest, profiles](LoopStructure *ls) -> bool{
+    auto averageInstsPerInvocationThreshold = 2000.0;
+    auto averageIterationThreshold = 12.0;
+    if (this->selectLoopNests){
+
+      /*
+      * The loops selected per nest are the ones whose savings outweigh their dispatch costs.
+      * Hence, we only filter out loops that cannot amortize a single dispatch or that do not have iterations to run in parallel.
+      */
+      averageInstsPerInvocationThreshold = (double)heuristics->getInvocationLatency().dispatchLatency(noelle.getMaximumNumberOfCores());
+      averageIterationThreshold = 2;
+    }
+    auto filter = [this, forest, profiles, averageInstsPerInvocationThreshold, averageIterationThreshold](LoopStructure *ls) -> bool{
 
       /*
       * Fetch the loop ID.
@@ -114,7 +131,6 @@ namespace llvm::noelle {
       * Check if the latency of each loop invocation is enough to justify the parallelization.
       */
       auto averageInstsPerInvocation = profiles->getAverageTotalInstructionsPerInvocation(ls);
-      auto averageInstsPerInvocationThreshold = 2000;
       if (  true
             && (!this->forceParallelization)
             && (averageInstsPerInvocation < averageInstsPerInvocationThreshold)
@@ -132,7 +148,6 @@ namespace llvm::noelle {
       * Check the number of iterations per invocation.
       */
       auto averageIterations = profiles->getAverageLoopIterationsPerInvocation(ls);
-      auto averageIterationThreshold = 12;
       if (  true
             && (!this->forceParallelization)
             && (averageIterations < averageIterationThreshold)
@@ -228,7 +243,7 @@ namespace llvm::noelle {
       /*
       * Select the loops to parallelize.
       */
-      auto loopsToParallelize = this->selectTheOrderOfLoopsToParallelize(noelle, profiles, tree);
+      auto loopsToParallelize = this->selectTheOrderOfLoopsToParallelize(noelle, profiles, heuristics, tree);
 
       /*
       * Parallelize the loops.
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2019 - 2020  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "Parallelizer.hpp"
+
+namespace llvm::noelle {
+
+  ParallelizationTechnique * Parallelizer::selectTheTechniqueToParallelizeLoop (
+    LoopDependenceInfo *LDI,
+    Noelle &par,
+    DSWP &dswp,
+    DOALL &doall,
+    HELIX &helix,
+    Heuristics *h
+    ){
+
+    /*
+    * Fetch the verbosity level.
+    */
+    auto verbose = par.getVerbosity();
+
+    /*
+    * Define the techniques to consider in their priority order.
+    */
+    std::vector<std::tuple<Transformation, std::string, ParallelizationTechnique *>> techniques{
+      { DOALL_ID, "DOALL", &doall },
+      { HELIX_ID, "HELIX", &helix },
+      { DSWP_ID, "DSWP", &dswp }
+    };
+
+    /*
+    * Collect the techniques that can parallelize the loop.
+    * Without the cost model, the first one applicable is selected.
+    */
+    std::vector<std::pair<std::string, ParallelizationTechnique *>> applicableTechniques;
+    for (auto &techniqueTuple : techniques){
+      auto techniqueID = std::get<0>(techniqueTuple);
+      auto technique = std::get<2>(techniqueTuple);
+      if (  false
+            || (!par.isTransformationEnabled(techniqueID))
+            || (!LDI->isTransformationEnabled(techniqueID))
+            || (!technique->canBeAppliedToLoop(LDI, par, h))
+        ){
+        continue ;
+      }
+      if (!this->selectTechniqueWithCostModel){
+        return technique;
+      }
+      applicableTechniques.push_back(std::make_pair(std::get<1>(techniqueTuple), technique));
+    }
+    if (applicableTechniques.size() == 0){
+      return nullptr;
+    }
+
+    /*
+    * The cost model relies on profiles.
+    * If they are not available, then fall back to the priority order.
+    */
+    auto profiles = par.getProfiles();
+    auto loopStructure = LDI->getLoopStructure();
+    auto sequentialTime = (double)profiles->getTotalInstructions(loopStructure);
+    if (  false
+          || (!profiles->isAvailable())
+          || (profiles->getIterations(loopStructure) == 0)
+          || (sequentialTime == 0)
+      ){
+      return applicableTechniques[0].second;
+    }
+
+    /*
+    * Select the technique with the highest expected speedup.
+    */
+    if (verbose != Verbosity::Disabled) {
+      errs() << "Parallelizer:  Cost model: sequential time = " << sequentialTime << "\n";
+    }
+    ParallelizationTechnique *bestTechnique = nullptr;
+    std::string bestTechniqueName{"none"};
+    double bestSpeedup = 0;
+    for (auto &techniquePair : applicableTechniques){
+      auto technique = techniquePair.second;
+      auto parallelTime = technique->estimateParallelExecutionTime(LDI, par, h);
+      auto speedup = sequentialTime / parallelTime;
+      if (verbose != Verbosity::Disabled) {
+        errs() << "Parallelizer:  Cost model:   " << techniquePair.first << ": estimated time = " << parallelTime << ", speedup = " << speedup << "\n";
+      }
+      if (speedup > bestSpeedup){
+        bestSpeedup = speedup;
+        bestTechnique = technique;
+        bestTechniqueName = techniquePair.first;
+      }
+    }
+
+    /*
+    * Check if the best technique is expected to speed up the loop.
+    */
+    if (  true
+          && (!this->forceParallelization)
+          && (bestSpeedup <= 1)
+      ){
+      if (verbose != Verbosity::Disabled) {
+        errs() << "Parallelizer:  Cost model:   No technique is expected to speed up the loop\n";
+      }
+      return nullptr;
+    }
+    if (verbose != Verbosity::Disabled) {
+      errs() << "Parallelizer:  Cost model:   Selected " << bestTechniqueName << "\n";
+    }
+
+    return bestTechnique;
+  }
+}
@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+
+  /*
+   * Each value below is produced by its own sequential SCC and forwarded to the last stage through a queue of its own bitwidth.
+   */
+  uint8_t v8 = argc;
+  uint16_t v16 = ((argc * 5) / 2) + 1;
+  uint32_t v32 = ((argc * 42) / 2) + 1;
+  uint64_t v64 = ((argc * 142) / 2) + 1;
+  uint64_t checksum = 0;
+
+  for (auto i = 0; i < iterations; ++i) {
+
+    // 8-bit producer
+    v8 = (uint8_t)((v8 * 3) + 1);
+
+    // 16-bit producer
+    v16 = (uint16_t)((v16 * 5) + 3);
+
+    // 32-bit producer
+    v32 = (v32 * 7) + 5;
+
+    // 64-bit producer
+    v64 = (v64 * 11) + 7;
+
+    // Consumer
+    checksum = (checksum * 31) ^ ((uint64_t)v8 + (uint64_t)v16 + (uint64_t)v32 + (uint64_t)v64);
+  }
+
+  printf("%u, %u, %u, %llu, %llu\n", v8, v16, v32, (unsigned long long)v64, (unsigned long long)checksum);
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The two pointers may alias.
+ * When they overlap, the iterations of the loop depend on each other.
+ */
+void computeValues (long long int *a, long long int *b, long long int iters){
+  for (auto i = 0; i < iters; i++){
+    a[i] = (b[i] * 3 + i) % 1000003;
+  }
+
+  return ;
+}
+
+long long int checksum (long long int *a, long long int elements){
+  long long int s = 0;
+  for (auto i = 0; i < elements; i++){
+    s = (s * 31 + a[i]) % 1000000007;
+  }
+
+  return s;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations == 0) return 0;
+
+  iterations *= 1000;
+  auto elements = iterations * 2 + 2;
+  long long int *array = (long long int *) malloc(sizeof(long long int) * elements);
+  for (auto i = 0; i < elements; i++){
+    array[i] = i % 17;
+  }
+
+  /*
+   * Disjoint pointers.
+   */
+  computeValues(array, array + iterations + 1, iterations);
+  printf("Disjoint: %lld\n", checksum(array, elements));
+
+  /*
+   * Overlapping pointers: every iteration reads what the previous one wrote.
+   */
+  computeValues(array + 1, array, iterations);
+  printf("Overlapping: %lld\n", checksum(array, elements));
+
+  /*
+   * Overlapping pointers: every iteration reads what a later one writes.
+   */
+  computeValues(array, array + 1, iterations);
+  printf("Overlapping reversed: %lld\n", checksum(array, elements));
+
+  /*
+   * Identical pointers.
+   */
+  computeValues(array, array, iterations);
+  printf("Identical: %lld\n", checksum(array, elements));
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The loop-carried values are not reducible, so HELIX protects them with sequential segments.
+ * They are also live-outs of the loop.
+ */
+long long int computeHash (long long int *a, long long int iters, double *d, int *last){
+  long long int h = 7;
+  double x = 1.0;
+  int l = -1;
+
+  for (auto i = 0; i < iters; i++){
+    auto v = a[i] * 13 + i;
+    a[i] = v % 1000;
+
+    h = (h * 31 + v) % 1000000007;
+    x = x * 0.5 + (double)(v % 17);
+    if ((v % 5) == 0){
+      l = i;
+    }
+  }
+
+  (*d) = x;
+  (*last) = l;
+  return h;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations == 0) return 0;
+
+  iterations *= 1000;
+  long long int *array = (long long int *) malloc(sizeof(long long int) * iterations);
+  for (auto i = 0; i < iterations; i++){
+    array[i] = i % 123;
+  }
+
+  double d = 0;
+  int last = 0;
+  auto h = computeHash(array, iterations, &d, &last);
+  printf("%lld %.6f %d %lld\n", h, d, last, array[iterations / 2]);
+
+  return 0;
+}
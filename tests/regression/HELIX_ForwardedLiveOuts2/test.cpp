@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * A loop-carried value is read and updated in two places of the loop body, separated by parallel code.
+ * The second loop-carried value is updated only in one place.
+ * Both are live-outs of the loop.
+ */
+long long int computeValues (long long int *a, long long int iters, long long int *other){
+  long long int s = 1;
+  long long int o = 0;
+
+  for (auto i = 0; i < iters; i++){
+    s = (s * 3 + a[i]) % 1000003;
+
+    auto w = a[i];
+    for (auto j = 0; j < 10; j++){
+      w = (w * 7 + j) % 10007;
+    }
+    a[i] = w;
+
+    if ((w & 1) == 0){
+      s = s ^ w;
+    }
+    o = (o * 5 + w) % 65521;
+  }
+
+  (*other) = o;
+  return s;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations == 0) return 0;
+
+  iterations *= 500;
+  long long int *array = (long long int *) malloc(sizeof(long long int) * iterations);
+  for (auto i = 0; i < iterations; i++){
+    array[i] = (i * 17) % 311;
+  }
+
+  long long int o = 0;
+  auto s = computeValues(array, iterations, &o);
+  printf("%lld %lld %lld\n", s, o, array[iterations - 1]);
+
+  return 0;
+}
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Perfectly nested counted loops: they can be collapsed into a single loop.
+ */
+void computeMatrix (long long int *m, long long int rows, long long int cols){
+  for (long long int i = 0; i < rows; i++){
+    for (long long int j = 0; j < cols; j++){
+      m[i * cols + j] = i * 3 + j * 7 + (i ^ j);
+    }
+  }
+
+  return ;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations == 0) return 0;
+
+  auto rows = iterations * 10;
+  auto cols = iterations + 3;
+  long long int *matrix = (long long int *) calloc(rows * cols, sizeof(long long int));
+
+  computeMatrix(matrix, rows, cols);
+
+  long long int s = 0;
+  for (auto i = 0; i < rows * cols; i++){
+    s += matrix[i] * (i % 5);
+  }
+  printf("%lld %lld %lld\n", s, matrix[0], matrix[rows * cols - 1]);
+
+  return 0;
+}
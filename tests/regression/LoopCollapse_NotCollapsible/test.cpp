@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The bound of the inner loop depends on the induction variable of the outer loop.
+ */
+void computeTriangle (long long int *m, long long int rows, long long int cols){
+  for (long long int i = 0; i < rows; i++){
+    for (long long int j = 0; j <= i; j++){
+      m[i * cols + j] = i * 5 + j;
+    }
+  }
+
+  return ;
+}
+
+/*
+ * The start of the inner loop depends on the induction variable of the outer loop.
+ */
+void computeUpperTriangle (long long int *m, long long int rows, long long int cols){
+  for (long long int i = 0; i < rows; i++){
+    for (long long int j = i; j < cols; j++){
+      m[i * cols + j] -= i + 2 * j;
+    }
+  }
+
+  return ;
+}
+
+/*
+ * The loops have non-unit and negative steps.
+ */
+void computeStrided (long long int *m, long long int rows, long long int cols){
+  for (long long int i = rows - 1; i >= 0; i -= 2){
+    for (long long int j = 0; j < cols; j += 3){
+      m[i * cols + j] += i * 11 - j;
+    }
+  }
+
+  return ;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations == 0) return 0;
+
+  auto rows = iterations * 4;
+  auto cols = rows + 1;
+  long long int *matrix = (long long int *) calloc(rows * cols, sizeof(long long int));
+
+  computeTriangle(matrix, rows, cols);
+  computeUpperTriangle(matrix, rows, cols);
+  computeStrided(matrix, rows, cols);
+
+  long long int s = 0;
+  for (auto i = 0; i < rows * cols; i++){
+    s += matrix[i] * (i % 5);
+  }
+  printf("%lld %lld %lld\n", s, matrix[cols + 1], matrix[rows * cols - 1]);
+
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Perfectly nested counted loops that are invoked with zero trip counts for the outer loop, the inner loop, or both.
+ */
+void computeMatrix (long long int *m, long long int rows, long long int cols, long long int value){
+  for (long long int i = 0; i < rows; i++){
+    for (long long int j = 0; j < cols; j++){
+      m[i * cols + j] += value + i - j;
+    }
+  }
+
+  return ;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations == 0) return 0;
+
+  auto rows = iterations * 5;
+  auto cols = iterations + 1;
+  long long int *matrix = (long long int *) calloc(rows * cols, sizeof(long long int));
+
+  long long int bounds[][2] = {
+    { 0, cols },
+    { rows, 0 },
+    { 0, 0 },
+    { rows, cols },
+    { 1, cols },
+    { rows, 1 },
+    { -3, cols },
+    { rows, -3 }
+  };
+  for (auto b = 0; b < 8; b++){
+    computeMatrix(matrix, bounds[b][0], bounds[b][1], b + 1);
+
+    long long int s = 0;
+    for (auto i = 0; i < rows * cols; i++){
+      s += matrix[i] * (i % 7);
+    }
+    printf("%lld %lld: %lld\n", bounds[b][0], bounds[b][1], s);
+  }
+
+  return 0;
+}
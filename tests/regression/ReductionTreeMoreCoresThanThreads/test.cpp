@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Eight reductions let DOALL combine the private copies in a tree before the join.
+ * Run it with at least 16 task instances (e.g., -noelle-max-cores=32).
+ */
+void computeSums (long long int *a, long long int iters, long long int *sums){
+  long long int s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+
+  for (auto i = 0; i < iters; ++i){
+    s0 += a[i];
+    s1 += a[i] * 2;
+    s2 += a[i] + 3;
+    s3 += a[i] ^ 5;
+    s4 += a[i] * a[i];
+    s5 += a[i] & 7;
+    s6 += a[i] | 1;
+    s7 += a[i] - 11;
+  }
+
+  sums[0] = s0;
+  sums[1] = s1;
+  sums[2] = s2;
+  sums[3] = s3;
+  sums[4] = s4;
+  sums[5] = s5;
+  sums[6] = s6;
+  sums[7] = s7;
+
+  return ;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]) * 10000;
+
+  /*
+   * Ask for more cores than the threads of the runtime.
+   * The task instances of the loop wait for each other, so they must not wait for a thread of the runtime.
+   */
+  setenv("NOELLE_CORES", "256", 1);
+
+  long long int *array = (long long int *) malloc(sizeof(long long int) * iterations);
+  for (auto i = 0; i < iterations; i++){
+    array[i] = i;
+  }
+
+  /*
+   * Invoke the loop several times, so the runtime re-uses its threads.
+   */
+  long long int sums[8];
+  for (auto invocation = 0; invocation < 10; invocation++){
+    computeSums(array, iterations, sums);
+    for (auto i = 0; i < 8; i++){
+      printf("%lld ", sums[i]);
+    }
+    printf("\n");
+  }
+
+  return 0;
+}
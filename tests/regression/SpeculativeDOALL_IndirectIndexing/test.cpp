@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Iterations depend on each other only if the index array includes the same element more than once.
+ * This can only be known at run time.
+ */
+void updateValues (long long int *a, int *idx, long long int *b, long long int iters){
+  for (auto i = 0; i < iters; i++){
+    a[idx[i]] = (a[idx[i]] * 5 + b[i]) % 1000003;
+  }
+
+  return ;
+}
+
+long long int checksum (long long int *a, long long int elements){
+  long long int s = 0;
+  for (auto i = 0; i < elements; i++){
+    s = (s * 31 + a[i]) % 1000000007;
+  }
+
+  return s;
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations == 0) return 0;
+
+  iterations *= 1000;
+  long long int *a = (long long int *) malloc(sizeof(long long int) * iterations);
+  long long int *b = (long long int *) malloc(sizeof(long long int) * iterations);
+  int *idx = (int *) malloc(sizeof(int) * iterations);
+  for (auto i = 0; i < iterations; i++){
+    a[i] = i % 13;
+    b[i] = (i * 7) % 101;
+  }
+
+  /*
+   * The indexes are a permutation: the iterations are independent.
+   */
+  for (auto i = 0; i < iterations; i++){
+    idx[i] = (int)(iterations - 1 - i);
+  }
+  updateValues(a, idx, b, iterations);
+  printf("Permutation: %lld\n", checksum(a, iterations));
+
+  /*
+   * Pairs of consecutive iterations update the same element: the iterations depend on each other.
+   */
+  for (auto i = 0; i < iterations; i++){
+    idx[i] = (int)(i / 2);
+  }
+  updateValues(a, idx, b, iterations);
+  printf("Collisions: %lld\n", checksum(a, iterations));
+
+  /*
+   * All iterations update the same element.
+   */
+  for (auto i = 0; i < iterations; i++){
+    idx[i] = 3;
+  }
+  updateValues(a, idx, b, iterations);
+  printf("Same element: %lld\n", checksum(a, iterations));
+
+  return 0;
+}
@@ -89,6 +89,7 @@ runningTestsWrapper -noelle-parallelizer-force -noelle-disable-helix ;
 runningTestsWrapper -noelle-parallelizer-force -noelle-disable-helix -dswp-no-scc-merge ;
 
 runningTestsWrapper -noelle-parallelizer-force -noelle-disable-dswp ;
+runningTestsWrapper -noelle-parallelizer-force -noelle-disable-helix -noelle-disable-dswp -noelle-max-cores=32 ;
 runningTestsWrapper -noelle-parallelizer-force -noelle-disable-dswp -dswp-no-scc-merge ;
 
 runningTestsWrapper -noelle-parallelizer-force -noelle-disable-doall ;
@@ -99,6 +100,11 @@ runningTestsWrapper -noelle-parallelizer-force -noelle-disable-doall -noelle-dis
 
 runningTestsWrapper -noelle-parallelizer-force -noelle-disable-doall -noelle-disable-dswp ;
 runningTestsWrapper -noelle-parallelizer-force -noelle-disable-doall -noelle-disable-dswp -dswp-no-scc-merge ;
+runningTestsWrapper -noelle-parallelizer-force -noelle-disable-doall -noelle-disable-dswp -noelle-helix-disable-forwarding ;
+runningTestsWrapper -noelle-parallelizer-force -noelle-disable-doall -noelle-disable-dswp -noelle-disable-runtime-inlining ;
+
+runningTestsWrapper -noelle-parallelizer-force -noelle-disable-helix -noelle-disable-dswp -noelle-doall-speculate ;
+runningTestsWrapper -noelle-parallelizer-force -noelle-disable-helix -noelle-disable-dswp -noelle-doall-speculate -noelle-disable-runtime-inlining ;
 
 cd ../ ;
 
@@ -58,6 +58,7 @@ namespace llvm {
 
       static Values verifyDisjointAccessBetweenIterations (ModulePass &pass, TestSuite &suite) ;
       static Values verifyDisjointAccessBetweenIterationsAfterSCEVSimplification (ModulePass &pass, TestSuite &suite) ;
+      static Values verifyMemoryAccessRanges (ModulePass &pass, TestSuite &suite) ;
 
       Values collectDisjointAccessesBetweenIterations (ModulePass &pass, TestSuite &suite) ;
 
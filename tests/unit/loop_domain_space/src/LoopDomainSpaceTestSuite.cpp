@@ -28,11 +28,13 @@ static RegisterStandardPasses _RegPass2(PassManagerBuilder::EP_EnabledOnOptLevel
 
 const char *LoopDomainSpaceTestSuite::tests[] = {
   "verifyDisjointAccessBetweenIterations",
+  "verifyMemoryAccessRanges",
   "verifyDisjointAccessBetweenIterationsAfterSCEVSimplification"
 };
 
 TestFunction LoopDomainSpaceTestSuite::testFns[] = {
   LoopDomainSpaceTestSuite::verifyDisjointAccessBetweenIterations,
+  LoopDomainSpaceTestSuite::verifyMemoryAccessRanges,
   LoopDomainSpaceTestSuite::verifyDisjointAccessBetweenIterationsAfterSCEVSimplification
 };
 
@@ -78,6 +80,34 @@ Values LoopDomainSpaceTestSuite::verifyDisjointAccessBetweenIterationsAfterSCEVS
   return attrPass.collectDisjointAccessesBetweenIterations(pass, suite);
 }
 
+Values LoopDomainSpaceTestSuite::verifyMemoryAccessRanges (ModulePass &pass, TestSuite &suite) {
+  LoopDomainSpaceTestSuite &attrPass = static_cast<LoopDomainSpaceTestSuite &>(pass);
+  attrPass.computeAnalysisWithoutSCEVSimplification ();
+
+  /*
+   * Describe each range as: kind of access ; name of the base ; offset ; step ; size
+   */
+  Values ranges;
+  for (auto B : attrPass.LIS->getLoopNestingTreeRoot()->getBasicBlocks()) {
+    for (auto &I : *B) {
+      if (!isa<StoreInst>(&I) && !isa<LoadInst>(&I)) continue;
+
+      auto range = attrPass.domainSpaceAnalysis->getMemoryAccessRange(&I);
+      if (!range) continue;
+
+      ranges.insert(suite.combineOrderedValues(std::vector<std::string>{
+        isa<StoreInst>(&I) ? "store" : "load",
+        range->base->getName().str(),
+        std::to_string(range->offset),
+        std::to_string(range->step),
+        std::to_string(range->accessSize)
+      }));
+    }
+  }
+
+  return ranges;
+}
+
 Values LoopDomainSpaceTestSuite::collectDisjointAccessesBetweenIterations (ModulePass &pass, TestSuite &suite) {
   LoopDomainSpaceTestSuite &attrPass = static_cast<LoopDomainSpaceTestSuite &>(pass);
 
@@ -0,0 +1,20 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+int a[100];
+long long int b[300];
+
+int main (int argc, char *argv[]){
+  if (argc < 1) return 0;
+
+  for (long long int i = 0; i < 100; ++i) {
+    a[i] = argc + i;
+    b[2 * i + 1] += a[i];
+    b[0] = i;
+  }
+
+  printf("%d, %lld, %lld\n", a[50], b[0], b[101]);
+
+  return 0;
+}